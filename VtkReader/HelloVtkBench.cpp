@@ -0,0 +1,387 @@
+// Benchmark suite on synthetic meshes. For every size and file format, writes
+// the mesh with MyWriteSyntheticMesh, then runs read -> convert -> color a
+// few times after one warm-up run and reports per stage the median and 95th
+// percentile time and the throughput in cells/s and MB/s:
+//
+//   read     MyLoadPolyDataWithLookupTables, or MyReadMappedXmlPolyData for .vtp
+//   convert  MyTriangulateCleanNormals, MySplitVertices over the cell scalars
+//            and the vertex gather of positions and normals
+//   color    MyColorMap of the point and cell scalars to BGRA8
+//
+// MB/s counts the file for read, the polydata read for convert and the
+// scalars mapped for color. Same options, same files: runs can be compared
+// before and after a change. Stages are also MyStage stages, so MY_PROFILE and
+// MY_PROFILE_TRACE work here too.
+//
+// usage: HelloVtkBench [--cells 1K,1M,100M] [--formats ascii,binary,vtp]
+//                      [--mix quads:triangles:polygons] [--point-arrays n] [--cell-arrays n]
+//                      [--field-arrays n] [--components n] [--runs n] [--seed n] [--serial]
+//                      [--dir output dir] [--keep] [--json results file]
+//        defaults to 1K, 100K and 1M quads in every format, one point and one
+//        cell scalar, 7 runs, files written to and removed from the current directory
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkLookupTable.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkXMLPolyDataReader.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "MyAttributeExtract.h"
+#include "MyColorMap.h"
+#include "MyScalarRange.h"
+#include "MySplitVertices.h"
+#include "MyStageProfile.h"
+#include "MySyntheticMesh.h"
+#include "MyTriangulateCleanNormals.h"
+#include "MyVertexGather.h"
+#include "MyVtkLoader.h"
+#include "MyVtkXmlMappedReader.h"
+
+namespace {
+
+struct BenchOptions
+{
+  std::vector<vtkIdType> Sizes;
+  std::vector<MySyntheticFormat> Formats;
+  MySyntheticMeshOptions Mesh;
+  int Runs = 7;
+  bool Parallel = true;
+  std::filesystem::path Directory = ".";
+  bool Keep = false;
+  std::string JsonPath;
+};
+
+// 1000, 1K, 1M or 1G
+vtkIdType ParseCount(const std::string& text)
+{
+  size_t end = 0;
+  double value = std::stod(text, &end);
+  switch (end < text.size() ? text[end] : '\0')
+  {
+    case 'K': case 'k': value *= 1e3; break;
+    case 'M': case 'm': value *= 1e6; break;
+    case 'G': case 'g': value *= 1e9; break;
+  }
+  return static_cast<vtkIdType>(value);
+}
+
+std::vector<std::string> Split(const std::string& text, char separator)
+{
+  std::vector<std::string> parts;
+  size_t begin = 0;
+  for (size_t end; (end = text.find(separator, begin)) != std::string::npos; begin = end + 1)
+  {
+    parts.push_back(text.substr(begin, end - begin));
+  }
+  parts.push_back(text.substr(begin));
+  return parts;
+}
+
+bool ParseArguments(int argc, char* argv[], BenchOptions& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string flag = argv[i];
+    if (flag == "--serial") options.Parallel = false;
+    else if (flag == "--keep") options.Keep = true;
+    else if (i + 1 < argc)
+    {
+      const std::string value = argv[++i];
+      if (flag == "--cells")
+      {
+        for (const std::string& size : Split(value, ',')) options.Sizes.push_back(ParseCount(size));
+      }
+      else if (flag == "--formats")
+      {
+        for (const std::string& name : Split(value, ','))
+        {
+          if (name == "ascii") options.Formats.push_back(MySyntheticFormat::LegacyAscii);
+          else if (name == "binary") options.Formats.push_back(MySyntheticFormat::LegacyBinary);
+          else if (name == "vtp") options.Formats.push_back(MySyntheticFormat::XmlAppended);
+          else return false;
+        }
+      }
+      else if (flag == "--mix")
+      {
+        const std::vector<std::string> shares = Split(value, ':');
+        if (shares.size() != 3) return false;
+        options.Mesh.QuadShare = std::stod(shares[0]);
+        options.Mesh.TriangleShare = std::stod(shares[1]);
+        options.Mesh.PolygonShare = std::stod(shares[2]);
+      }
+      else if (flag == "--point-arrays") options.Mesh.PointArrays = std::stoi(value);
+      else if (flag == "--cell-arrays") options.Mesh.CellArrays = std::stoi(value);
+      else if (flag == "--field-arrays") options.Mesh.FieldArrays = std::stoi(value);
+      else if (flag == "--components") options.Mesh.Components = std::stoi(value);
+      else if (flag == "--runs") options.Runs = std::max(1, std::stoi(value));
+      else if (flag == "--seed") options.Mesh.Seed = std::stoull(value);
+      else if (flag == "--dir") options.Directory = value;
+      else if (flag == "--json") options.JsonPath = value;
+      else return false;
+    }
+    else return false;
+  }
+  if (options.Sizes.empty()) options.Sizes = { 1000, 100000, 1000000 };
+  if (options.Formats.empty())
+  {
+    options.Formats = { MySyntheticFormat::LegacyAscii, MySyntheticFormat::LegacyBinary,
+      MySyntheticFormat::XmlAppended };
+  }
+  return true;
+}
+
+template <typename F>
+double Seconds(F&& run)
+{
+  auto begin = std::chrono::steady_clock::now();
+  run();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// linear between the closest ranks, so the median of an even count is the
+// mean of the middle two
+double Percentile(std::vector<double> values, double fraction)
+{
+  std::sort(values.begin(), values.end());
+  const double rank = fraction * static_cast<double>(values.size() - 1);
+  const size_t below = static_cast<size_t>(rank);
+  const size_t above = std::min(below + 1, values.size() - 1);
+  return values[below] + (rank - static_cast<double>(below)) * (values[above] - values[below]);
+}
+
+vtkSmartPointer<vtkPolyData> Read(const std::string& path, MySyntheticFormat format, bool parallel)
+{
+  MY_STAGE("read");
+  if (format == MySyntheticFormat::XmlAppended)
+  {
+    if (vtkSmartPointer<vtkPolyData> poly = MyReadMappedXmlPolyData(path.c_str())) return poly;
+    vtkNew<vtkXMLPolyDataReader> reader;
+    reader->SetFileName(path.c_str());
+    reader->Update();
+    return reader->GetOutput();
+  }
+  MyVtkLegacyReadOptions options;
+  options.Parallel = parallel;
+  MyVtkLoadResult result;
+  return MyLoadPolyDataWithLookupTables(path.c_str(), result, options) ? result.PolyData : nullptr;
+}
+
+// what a viewer makes of the polydata before the colors: triangles over
+// vertices split by the cell scalars, positions and normals per vertex
+vtkIdType Convert(vtkPolyData* input, bool parallel)
+{
+  MY_STAGE("convert");
+  MyTriangulateCleanNormalsOptions cleanOptions;
+  cleanOptions.Parallel = parallel;
+  vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(input, cleanOptions);
+  vtkDataArray* normals = poly->GetPointData()->GetNormals();
+  const vtkIdType numPoints = poly->GetNumberOfPoints();
+
+  std::vector<MyComponentView> cellValues;
+  if (vtkDataArray* cellScalars = poly->GetCellData()->GetScalars())
+  {
+    for (int c = 0; c < cellScalars->GetNumberOfComponents(); ++c) cellValues.emplace_back(cellScalars, c);
+  }
+  MySplitVerticesOptions splitOptions;
+  splitOptions.Parallel = parallel;
+  const MySplitVerticesResult split = MySplitVertices(poly, cellValues, splitOptions);
+  const vtkIdType numVertices = static_cast<vtkIdType>(split.VertexPoints.size());
+
+  MyExtractOptions extractOptions;
+  extractOptions.Parallel = parallel;
+  std::vector<float> points(3 * numPoints), pointNormals(normals ? 3 * numPoints : 0);
+  MyExtractComponents(poly->GetPoints()->GetData(), points.data(), extractOptions);
+  if (normals) MyExtractComponents(normals, pointNormals.data(), extractOptions);
+
+  std::vector<float> positions(3 * numVertices), vertexNormals(3 * numVertices);
+  MyVertexSources<float, uint32_t> sources;
+  sources.Points = points.data();
+  sources.VertexPoints = split.VertexPoints.data();
+  sources.VertexCells = split.VertexCells.data();
+  sources.PointNormals = normals ? pointNormals.data() : nullptr;
+  MyVertexTargets<float, uint32_t> targets;
+  targets.Positions = positions.data();
+  targets.Normals = vertexNormals.data();
+  MyGatherVertices(sources, targets, numVertices, parallel);
+  return static_cast<vtkIdType>(split.Triangles.size() / 3);
+}
+
+// BGRA8 colors of the first component of the point and cell scalars, over a
+// 256 color table spanning the point scalars
+vtkIdType Color(vtkPolyData* poly, bool parallel)
+{
+  MY_STAGE("color");
+  vtkDataArray* pointScalars = poly->GetPointData()->GetScalars();
+  vtkDataArray* cellScalars = poly->GetCellData()->GetScalars();
+
+  double range[2] = { 0.0, 1.0 };
+  MyGetScalarRange(pointScalars ? pointScalars : cellScalars, range);
+  vtkNew<vtkLookupTable> lut;
+  lut->SetNumberOfTableValues(256);
+  lut->SetTableRange(range);
+  lut->Build();
+  MyColorMapOptions options;
+  options.Parallel = parallel;
+  const MyColorMap colorMap(lut, options);
+
+  vtkIdType mapped = 0;
+  std::vector<uint32_t> colors;
+  for (vtkDataArray* scalars : { pointScalars, cellScalars })
+  {
+    if (!scalars) continue;
+    colors.resize(scalars->GetNumberOfTuples());
+    mapped += colorMap.Map(scalars, colors.data(), MyColorFormat::BGRA8);
+  }
+  return mapped;
+}
+
+uint64_t ScalarBytes(vtkPolyData* poly)
+{
+  uint64_t bytes = 0;
+  for (vtkDataArray* scalars : { poly->GetPointData()->GetScalars(), poly->GetCellData()->GetScalars() })
+  {
+    if (scalars) bytes += static_cast<uint64_t>(scalars->GetNumberOfTuples()) * scalars->GetDataTypeSize();
+  }
+  return bytes;
+}
+
+struct StageResult
+{
+  vtkIdType Cells;
+  MySyntheticFormat Format;
+  const char* Stage;
+  std::vector<double> Seconds;
+  uint64_t Bytes; // processed per run, for MB/s
+};
+
+void PrintResult(const StageResult& result, double fileMegaBytes)
+{
+  const double median = Percentile(result.Seconds, 0.5);
+  std::printf("%12lld %7s %10.1f %8s %12.4f %12.4f %12.3f %10.1f\n", static_cast<long long>(result.Cells),
+    MySyntheticFormatName(result.Format), fileMegaBytes, result.Stage, median, Percentile(result.Seconds, 0.95),
+    result.Cells / median * 1e-6, result.Bytes / (1024.0 * 1024.0) / median);
+}
+
+bool WriteJson(const std::string& path, const BenchOptions& options, const std::vector<StageResult>& results)
+{
+  std::FILE* file = std::fopen(path.c_str(), "w");
+  if (!file) return false;
+  const MySyntheticMeshOptions& mesh = options.Mesh;
+  std::fprintf(file,
+    "{\n  \"runs\": %d,\n  \"parallel\": %s,\n  \"mix\": [%g, %g, %g],\n  \"point_arrays\": %d,\n"
+    "  \"cell_arrays\": %d,\n  \"field_arrays\": %d,\n  \"components\": %d,\n  \"seed\": %llu,\n  \"results\": [",
+    options.Runs, options.Parallel ? "true" : "false", mesh.QuadShare, mesh.TriangleShare, mesh.PolygonShare,
+    mesh.PointArrays, mesh.CellArrays, mesh.FieldArrays, mesh.Components, static_cast<unsigned long long>(mesh.Seed));
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const StageResult& result = results[i];
+    const double median = Percentile(result.Seconds, 0.5);
+    std::fprintf(file,
+      "%s\n    { \"cells\": %lld, \"format\": \"%s\", \"stage\": \"%s\", \"median_s\": %.6f, \"p95_s\": %.6f, "
+      "\"min_s\": %.6f, \"cells_per_s\": %.0f, \"mb_per_s\": %.3f }",
+      i ? "," : "", static_cast<long long>(result.Cells), MySyntheticFormatName(result.Format), result.Stage, median,
+      Percentile(result.Seconds, 0.95), Percentile(result.Seconds, 0.0), result.Cells / median,
+      result.Bytes / (1024.0 * 1024.0) / median);
+  }
+  std::fprintf(file, "\n  ]\n}\n");
+  return std::fclose(file) == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  BenchOptions options;
+  if (!ParseArguments(argc, argv, options))
+  {
+    std::cerr << "usage: HelloVtkBench [--cells 1K,1M,100M] [--formats ascii,binary,vtp] "
+                 "[--mix quads:triangles:polygons] [--point-arrays n] [--cell-arrays n] [--field-arrays n] "
+                 "[--components n] [--runs n] [--seed n] [--serial] [--dir output dir] [--keep] "
+                 "[--json results file]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  bool consistent = true;
+  std::vector<StageResult> results;
+  std::printf("%12s %7s %10s %8s %12s %12s %12s %10s\n", "cells", "format", "file(MB)", "stage", "median(s)",
+    "p95(s)", "Mcells/s", "MB/s");
+  for (vtkIdType numCells : options.Sizes)
+  {
+    MySyntheticMeshOptions mesh = options.Mesh;
+    mesh.NumberOfCells = numCells;
+    for (MySyntheticFormat format : options.Formats)
+    {
+      const std::string path = (options.Directory /
+        ("hellovtk_bench_" + std::to_string(numCells) + "_" + MySyntheticFormatName(format) +
+          MySyntheticExtension(format))).string();
+      MySyntheticMeshInfo info;
+      if (!MyWriteSyntheticMesh(path.c_str(), format, mesh, &info)) return EXIT_FAILURE;
+
+      StageResult read{ numCells, format, "read", {}, info.FileBytes };
+      StageResult convert{ numCells, format, "convert", {}, 0 };
+      StageResult color{ numCells, format, "color", {}, 0 };
+      for (int run = -1; run < options.Runs; ++run)
+      {
+        vtkSmartPointer<vtkPolyData> poly;
+        vtkIdType triangles = 0, colors = 0;
+        const double readSeconds = Seconds([&] { poly = Read(path, format, options.Parallel); });
+        if (!poly || poly->GetNumberOfCells() != info.NumberOfCells || poly->GetNumberOfPoints() != info.NumberOfPoints)
+        {
+          std::cerr << "read back a different mesh from " << path << std::endl;
+          consistent = false;
+          break;
+        }
+        const double convertSeconds = Seconds([&] { triangles = Convert(poly, options.Parallel); });
+        const double colorSeconds = Seconds([&] { colors = Color(poly, options.Parallel); });
+        // no point is repeated, so no triangle collapses
+        const vtkIdType expectedColors = (mesh.PointArrays > 0 ? info.NumberOfPoints : 0) +
+          (mesh.CellArrays > 0 ? info.NumberOfCells : 0);
+        if (triangles != info.ConnectivitySize - 2 * info.NumberOfCells || colors != expectedColors)
+        {
+          std::cerr << "converted " << triangles << " triangles and " << colors << " colors from " << path
+                    << std::endl;
+          consistent = false;
+        }
+
+        // the first run fills the page cache and the thread pool
+        if (run < 0) continue;
+        read.Seconds.push_back(readSeconds);
+        convert.Seconds.push_back(convertSeconds);
+        convert.Bytes = poly->GetActualMemorySize() * uint64_t(1024);
+        color.Seconds.push_back(colorSeconds);
+        color.Bytes = ScalarBytes(poly);
+      }
+      if (!options.Keep) std::filesystem::remove(path);
+      if (read.Seconds.empty()) continue;
+
+      const double fileMegaBytes = info.FileBytes / (1024.0 * 1024.0);
+      for (StageResult* result : { &read, &convert, &color })
+      {
+        PrintResult(*result, fileMegaBytes);
+        results.push_back(std::move(*result));
+      }
+    }
+  }
+
+  if (!options.JsonPath.empty() && !WriteJson(options.JsonPath, options, results))
+  {
+    std::cerr << "could not write " << options.JsonPath << std::endl;
+    return EXIT_FAILURE;
+  }
+  return consistent ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,109 @@
+#include "MyAttributeExtract.h"
+
+#include <vtkAOSDataArrayTemplate.h>
+#include <vtkArrayDispatch.h>
+#include <vtkDataArrayRange.h>
+#include <vtkSOADataArrayTemplate.h>
+
+#include <algorithm>
+
+#include "MyParallelFor.h"
+
+namespace {
+
+template <typename OutT>
+struct ExtractWorker
+{
+  OutT* Out;
+  int First;
+  int Count;     // components written per tuple
+  int Available; // of those, the ones the source tuple has
+  vtkIdType Stride;
+  bool Parallel;
+
+  void ZeroMissing(vtkIdType begin, vtkIdType end) const
+  {
+    if (this->Available == this->Count) return;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      std::fill(this->Out + i * this->Stride + this->Available, this->Out + i * this->Stride + this->Count, OutT(0));
+    }
+  }
+
+  template <typename ValueT>
+  void operator()(vtkAOSDataArrayTemplate<ValueT>* array) const
+  {
+    const ValueT* src = array->GetPointer(0);
+    const int numComps = array->GetNumberOfComponents();
+    MyParallelFor(this->Parallel, array->GetNumberOfTuples(), [&](vtkIdType begin, vtkIdType end) {
+      if (this->First == 0 && this->Available == numComps && this->Stride == numComps)
+      {
+        // same layout on both sides, one flat converting copy
+        std::copy(src + begin * numComps, src + end * numComps, this->Out + begin * numComps);
+        return;
+      }
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const ValueT* tuple = src + i * numComps + this->First;
+        OutT* out = this->Out + i * this->Stride;
+        for (int c = 0; c < this->Available; ++c) out[c] = static_cast<OutT>(tuple[c]);
+      }
+      this->ZeroMissing(begin, end);
+    });
+  }
+
+  template <typename ValueT>
+  void operator()(vtkSOADataArrayTemplate<ValueT>* array) const
+  {
+    MyParallelFor(this->Parallel, array->GetNumberOfTuples(), [&](vtkIdType begin, vtkIdType end) {
+      for (int c = 0; c < this->Available; ++c)
+      {
+        const ValueT* src = array->GetComponentArrayPointer(this->First + c);
+        OutT* out = this->Out + c;
+        for (vtkIdType i = begin; i < end; ++i) out[i * this->Stride] = static_cast<OutT>(src[i]);
+      }
+      this->ZeroMissing(begin, end);
+    });
+  }
+
+  // any other array, through its virtual component accessors
+  template <typename ArrayT>
+  void operator()(ArrayT* array) const
+  {
+    const auto tuples = vtk::DataArrayTupleRange(array);
+    MyParallelFor(this->Parallel, array->GetNumberOfTuples(), [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const auto tuple = tuples[i];
+        OutT* out = this->Out + i * this->Stride;
+        for (int c = 0; c < this->Available; ++c) out[c] = static_cast<OutT>(tuple[this->First + c]);
+      }
+      this->ZeroMissing(begin, end);
+    });
+  }
+};
+
+} // namespace
+
+template <typename OutT>
+vtkIdType MyExtractComponents(vtkDataArray* array, OutT* out, const MyExtractOptions& options)
+{
+  if (!array || !out || options.NumberOfComponents <= 0) return 0;
+
+  ExtractWorker<OutT> worker;
+  worker.Out = out;
+  worker.First = options.FirstComponent;
+  worker.Count = options.NumberOfComponents;
+  worker.Available = std::clamp(array->GetNumberOfComponents() - options.FirstComponent, 0, options.NumberOfComponents);
+  worker.Stride = options.Stride > 0 ? options.Stride : options.NumberOfComponents;
+  worker.Parallel = options.Parallel;
+
+  if (!vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::Reals>::Execute(array, worker))
+  {
+    worker(array);
+  }
+  return array->GetNumberOfTuples();
+}
+
+template vtkIdType MyExtractComponents<float>(vtkDataArray*, float*, const MyExtractOptions&);
+template vtkIdType MyExtractComponents<double>(vtkDataArray*, double*, const MyExtractOptions&);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vtkDataArray.h>
+
+#include "MyComponentView.h"
+
+struct MyExtractOptions
+{
+  // source components [FirstComponent, FirstComponent + NumberOfComponents) are
+  // written per tuple; components past the end of the source tuple are written as 0
+  int FirstComponent = 0;
+  int NumberOfComponents = 3;
+
+  // output values from one tuple to the next, NumberOfComponents when 0
+  vtkIdType Stride = 0;
+
+  // split the tuples over vtkSMPTools
+  bool Parallel = true;
+};
+
+// Typed copy of a data array into a packed output layout, in place of a
+// GetPoint/GetTuple call per tuple converted through double. The array is
+// dispatched once: float and double arrays in AOS or SOA layout are read
+// straight from their storage in a loop the compiler can vectorize, any other
+// array goes through the vtkDataArray API. Values are converted to OutT.
+//
+// out must hold GetNumberOfTuples() * Stride values. Returns the number of
+// tuples written, 0 for a null array.
+//
+// Instantiated for float and double:
+//   MyExtractComponents(points->GetData(), &Vertices.GetData()->X);
+//   MyExtractComponents(scalars, values.data(), { .NumberOfComponents = 1 });
+template <typename OutT>
+vtkIdType MyExtractComponents(vtkDataArray* array, OutT* out, const MyExtractOptions& options = {});
+
+// The component a view selects, written stride values apart
+template <typename OutT>
+vtkIdType MyExtractComponent(const MyComponentView& values, OutT* out, vtkIdType stride = 1, bool parallel = true)
+{
+  if (!values.IsValid()) return 0;
+  MyExtractOptions options;
+  options.FirstComponent = values.GetComponent();
+  options.NumberOfComponents = 1;
+  options.Stride = stride;
+  options.Parallel = parallel;
+  return MyExtractComponents(values.GetArray(), out, options);
+}
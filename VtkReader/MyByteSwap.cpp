@@ -0,0 +1,112 @@
+#include "MyByteSwap.h"
+
+#include <bit>
+#include <cstring>
+
+#include "MySimd.h"
+
+namespace {
+
+template <size_t N>
+void ScalarCopy(unsigned char* dst, const unsigned char* src, size_t count)
+{
+  for (size_t i = 0; i < count; ++i, dst += N, src += N)
+  {
+    unsigned char word[N];
+    std::memcpy(word, src, N);
+    for (size_t k = 0; k < N; ++k) dst[k] = word[N - 1 - k];
+  }
+}
+
+#if MY_SIMD_X86
+
+// pshufb control reversing every N-byte word, repeated for both 128-bit lanes
+template <size_t N>
+struct SwapMask
+{
+  alignas(32) unsigned char Bytes[32];
+
+  constexpr SwapMask() : Bytes{}
+  {
+    for (size_t i = 0; i < 32; ++i)
+    {
+      size_t lane = i % 16;
+      this->Bytes[i] = static_cast<unsigned char>(lane / N * N + (N - 1 - lane % N));
+    }
+  }
+};
+
+template <size_t N>
+constexpr SwapMask<N> Mask{};
+
+template <size_t N>
+MY_TARGET("avx2") void Avx2Copy(unsigned char* dst, const unsigned char* src, size_t count)
+{
+  const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(Mask<N>.Bytes));
+  const size_t bytes = count * N;
+  size_t i = 0;
+  for (; i + 64 <= bytes; i += 64)
+  {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(a, mask));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), _mm256_shuffle_epi8(b, mask));
+  }
+  for (; i + 32 <= bytes; i += 32)
+  {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(a, mask));
+  }
+  ScalarCopy<N>(dst + i, src + i, (bytes - i) / N);
+}
+
+template <size_t N>
+MY_TARGET("ssse3") void Ssse3Copy(unsigned char* dst, const unsigned char* src, size_t count)
+{
+  const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(Mask<N>.Bytes));
+  const size_t bytes = count * N;
+  size_t i = 0;
+  for (; i + 16 <= bytes; i += 16)
+  {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(a, mask));
+  }
+  ScalarCopy<N>(dst + i, src + i, (bytes - i) / N);
+}
+
+#endif // MY_SIMD_X86
+
+template <size_t N>
+void CopySwapped(unsigned char* dst, const unsigned char* src, size_t count)
+{
+#if MY_SIMD_X86
+  switch (MyGetSimdLevel())
+  {
+    case MySimdAvx2: Avx2Copy<N>(dst, src, count); return;
+    case MySimdSsse3: Ssse3Copy<N>(dst, src, count); return;
+    default: break;
+  }
+#endif
+  ScalarCopy<N>(dst, src, count);
+}
+
+} // namespace
+
+void MyCopyBigEndian(void* dst, const void* src, size_t count, size_t wordSize)
+{
+  auto* out = static_cast<unsigned char*>(dst);
+  auto* in = static_cast<const unsigned char*>(src);
+  if (std::endian::native == std::endian::big || wordSize == 1)
+  {
+    if (out != in) std::memcpy(out, in, count * wordSize);
+    return;
+  }
+
+  switch (wordSize)
+  {
+    case 2: CopySwapped<2>(out, in, count); break;
+    case 4: CopySwapped<4>(out, in, count); break;
+    case 8: CopySwapped<8>(out, in, count); break;
+    default: break;
+  }
+}
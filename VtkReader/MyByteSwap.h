@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+// Copy count big-endian words of wordSize bytes (1, 2, 4 or 8) from src to
+// dst in host order. dst may equal src for an in-place swap, any other
+// overlap is not allowed. Uses SSSE3/AVX2 shuffles when the CPU has them.
+void MyCopyBigEndian(void* dst, const void* src, size_t count, size_t wordSize);
+
+inline void MySwapBigEndian(void* data, size_t count, size_t wordSize)
+{
+  MyCopyBigEndian(data, data, count, wordSize);
+}
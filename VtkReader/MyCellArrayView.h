@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vtkCellArray.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkTypeInt64Array.h>
+
+// Offsets and connectivity of either vtkCellArray storage, read as vtkIdType.
+// Stateless, so unlike InitTraversal/GetNextCell any thread can read any cell.
+class MyCellArrayView
+{
+public:
+  MyCellArrayView() = default;
+  explicit MyCellArrayView(vtkCellArray* cells)
+  {
+    if (!cells) return;
+    this->NumberOfCells = cells->GetNumberOfCells();
+    if (cells->IsStorage64Bit())
+    {
+      this->Offsets64 = cells->GetOffsetsArray64()->GetPointer(0);
+      this->Connectivity64 = cells->GetConnectivityArray64()->GetPointer(0);
+    }
+    else
+    {
+      this->Offsets32 = cells->GetOffsetsArray32()->GetPointer(0);
+      this->Connectivity32 = cells->GetConnectivityArray32()->GetPointer(0);
+    }
+  }
+
+  vtkIdType GetNumberOfCells() const { return this->NumberOfCells; }
+
+  // index of the first point of cellId in the connectivity
+  vtkIdType Begin(vtkIdType cellId) const
+  {
+    return this->Offsets64 ? this->Offsets64[cellId] : this->Offsets32[cellId];
+  }
+  vtkIdType Size(vtkIdType cellId) const { return this->Begin(cellId + 1) - this->Begin(cellId); }
+  vtkIdType Id(vtkIdType i) const { return this->Connectivity64 ? this->Connectivity64[i] : this->Connectivity32[i]; }
+
+private:
+  vtkIdType NumberOfCells = 0;
+  const vtkTypeInt64* Offsets64 = nullptr;
+  const vtkTypeInt64* Connectivity64 = nullptr;
+  const vtkTypeInt32* Offsets32 = nullptr;
+  const vtkTypeInt32* Connectivity32 = nullptr;
+};
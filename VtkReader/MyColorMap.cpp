@@ -0,0 +1,365 @@
+#include "MyColorMap.h"
+
+#include <vtkLookupTable.h>
+#include <vtkMath.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "MyParallelFor.h"
+#include "MySimd.h"
+
+namespace {
+
+// scalars binned per pass, the bins stay in L1 until their colors are gathered
+constexpr vtkIdType BlockSize = 1024;
+
+// Bin of one scalar: 0 below range, 1..resolution inside, then above range and NaN.
+// Always computed in double, as vtkLookupTable does, so float scalars land in
+// the same entry MapValue would pick
+int32_t BinOf(double v, double lo, double hi, double scale, int32_t resolution)
+{
+  if (v != v) return resolution + 2;
+  if (v < lo) return 0;
+  if (v > hi) return resolution + 1;
+  const double t = (v - lo) * scale;
+  return (t < resolution - 1 ? static_cast<int32_t>(t) : resolution - 1) + 1;
+}
+
+template <typename T>
+void ScalarBins(const T* scalars, vtkIdType count, int32_t* bins, double lo, double hi, double scale, int32_t resolution)
+{
+  for (vtkIdType i = 0; i < count; ++i) bins[i] = BinOf(scalars[i], lo, hi, scale, resolution);
+}
+
+void ScalarGather(const uint32_t* table, const int32_t* bins, vtkIdType count, uint8_t* colors)
+{
+  for (vtkIdType i = 0; i < count; ++i) std::memcpy(colors + 4 * i, table + bins[i], 4);
+}
+
+#if MY_SIMD_X86
+
+// high halves of four 64-bit compare masks as four 32-bit masks
+MY_TARGET("avx2") inline __m128i NarrowMask(__m256d mask)
+{
+  const __m256i odd = _mm256_setr_epi32(1, 3, 5, 7, 1, 3, 5, 7);
+  return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_castpd_si256(mask), odd));
+}
+
+struct Avx2Binner
+{
+  __m256d Lo, Hi, Scale, Last;
+  __m128i One, Above, Nan;
+
+  MY_TARGET("avx2") Avx2Binner(double lo, double hi, double scale, int32_t resolution)
+    : Lo(_mm256_set1_pd(lo))
+    , Hi(_mm256_set1_pd(hi))
+    , Scale(_mm256_set1_pd(scale))
+    , Last(_mm256_set1_pd(resolution - 1))
+    , One(_mm_set1_epi32(1))
+    , Above(_mm_set1_epi32(resolution + 1))
+    , Nan(_mm_set1_epi32(resolution + 2))
+  {
+  }
+
+  // BinOf of four scalars
+  MY_TARGET("avx2") __m128i operator()(__m256d v) const
+  {
+    __m256d t = _mm256_mul_pd(_mm256_sub_pd(v, this->Lo), this->Scale);
+    t = _mm256_max_pd(_mm256_min_pd(t, this->Last), _mm256_setzero_pd());
+    __m128i bin = _mm_add_epi32(_mm256_cvttpd_epi32(t), this->One);
+    bin = _mm_andnot_si128(NarrowMask(_mm256_cmp_pd(v, this->Lo, _CMP_LT_OQ)), bin);
+    bin = _mm_blendv_epi8(bin, this->Above, NarrowMask(_mm256_cmp_pd(v, this->Hi, _CMP_GT_OQ)));
+    return _mm_blendv_epi8(bin, this->Nan, NarrowMask(_mm256_cmp_pd(v, v, _CMP_UNORD_Q)));
+  }
+};
+
+MY_TARGET("avx2") void Avx2Bins(const float* scalars, vtkIdType count, int32_t* bins, double lo, double hi,
+  double scale, int32_t resolution)
+{
+  const Avx2Binner binner(lo, hi, scale, resolution);
+  vtkIdType i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256 v = _mm256_loadu_ps(scalars + i);
+    const __m128i low = binner(_mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+    const __m128i high = binner(_mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(bins + i), _mm256_set_m128i(high, low));
+  }
+  ScalarBins(scalars + i, count - i, bins + i, lo, hi, scale, resolution);
+}
+
+MY_TARGET("avx2") void Avx2Bins(const double* scalars, vtkIdType count, int32_t* bins, double lo, double hi,
+  double scale, int32_t resolution)
+{
+  const Avx2Binner binner(lo, hi, scale, resolution);
+  vtkIdType i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bins + i), binner(_mm256_loadu_pd(scalars + i)));
+  }
+  ScalarBins(scalars + i, count - i, bins + i, lo, hi, scale, resolution);
+}
+
+MY_TARGET("avx2") void Avx2Gather(const uint32_t* table, const int32_t* bins, vtkIdType count, uint8_t* colors)
+{
+  vtkIdType i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256i bin = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bins + i));
+    const __m256i color = _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), bin, 4);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(colors + 4 * i), color);
+  }
+  ScalarGather(table, bins + i, count - i, colors + 4 * i);
+}
+
+#endif // MY_SIMD_X86
+
+void Gather(const uint32_t* table, const int32_t* bins, vtkIdType count, uint8_t* colors)
+{
+#if MY_SIMD_X86
+  if (MyGetSimdLevel() >= MySimdAvx2)
+  {
+    Avx2Gather(table, bins, count, colors);
+    return;
+  }
+#endif
+  ScalarGather(table, bins, count, colors);
+}
+
+void Gather(const float* table, const int32_t* bins, vtkIdType count, uint8_t* colors)
+{
+  constexpr size_t size = 4 * sizeof(float);
+  for (vtkIdType i = 0; i < count; ++i) std::memcpy(colors + size * i, table + 4 * bins[i], size);
+}
+
+// One lookup table color in both of the forms VTK gives it.
+// Not thread safe: vtkLookupTable::MapValue returns its own buffer
+struct LutColor
+{
+  uint8_t Bytes[4];
+  float Linear[4];
+};
+
+LutColor MapValue(vtkScalarsToColors* lut, double v)
+{
+  LutColor color;
+  std::memcpy(color.Bytes, lut->MapValue(v), 4);
+  double rgb[3];
+  lut->GetColor(v, rgb);
+  color.Linear[0] = static_cast<float>(rgb[0]);
+  color.Linear[1] = static_cast<float>(rgb[1]);
+  color.Linear[2] = static_cast<float>(rgb[2]);
+  color.Linear[3] = static_cast<float>(lut->GetOpacity(v));
+  return color;
+}
+
+uint32_t Quantize(float v, uint32_t max)
+{
+  return static_cast<uint32_t>(std::clamp(v, 0.0f, 1.0f) * max + 0.5f);
+}
+
+// one color in a 32-bit format; the 8-bit linear formats keep the lookup
+// table's own bytes
+uint32_t Pack(const LutColor& color, MyColorFormat format)
+{
+  uint8_t bytes[4];
+  switch (format)
+  {
+    case MyColorFormat::RGBA8:
+      std::memcpy(bytes, color.Bytes, 4);
+      break;
+    case MyColorFormat::RGBA8_sRGB:
+      bytes[0] = MyLinearToSRGB8(color.Linear[0]);
+      bytes[1] = MyLinearToSRGB8(color.Linear[1]);
+      bytes[2] = MyLinearToSRGB8(color.Linear[2]);
+      bytes[3] = color.Bytes[3];
+      break;
+    case MyColorFormat::BGRA8:
+      bytes[0] = color.Bytes[2];
+      bytes[1] = color.Bytes[1];
+      bytes[2] = color.Bytes[0];
+      bytes[3] = color.Bytes[3];
+      break;
+    case MyColorFormat::BGRA8_sRGB:
+      bytes[0] = MyLinearToSRGB8(color.Linear[2]);
+      bytes[1] = MyLinearToSRGB8(color.Linear[1]);
+      bytes[2] = MyLinearToSRGB8(color.Linear[0]);
+      bytes[3] = color.Bytes[3];
+      break;
+    case MyColorFormat::RGB10A2:
+      return Quantize(color.Linear[0], 1023) | Quantize(color.Linear[1], 1023) << 10 |
+        Quantize(color.Linear[2], 1023) << 20 | Quantize(color.Linear[3], 3) << 30;
+    case MyColorFormat::Float4:
+      return 0;
+  }
+  uint32_t packed;
+  std::memcpy(&packed, bytes, 4);
+  return packed;
+}
+
+void Store(const LutColor& color, MyColorFormat format, uint8_t* out)
+{
+  if (format == MyColorFormat::Float4)
+  {
+    std::memcpy(out, color.Linear, sizeof(color.Linear));
+    return;
+  }
+  const uint32_t packed = Pack(color, format);
+  std::memcpy(out, &packed, 4);
+}
+
+} // namespace
+
+uint8_t MyLinearToSRGB8(float linear)
+{
+  // fine enough that neighbouring entries are at most a quarter code apart,
+  // where the curve is steepest
+  constexpr int size = 1 << 14;
+  static const std::vector<uint8_t> table = [] {
+    std::vector<uint8_t> codes(size);
+    for (int i = 0; i < size; ++i)
+    {
+      const double v = static_cast<double>(i) / (size - 1);
+      const double srgb = v <= 0.0031308 ? 12.92 * v : 1.055 * std::pow(v, 1.0 / 2.4) - 0.055;
+      codes[i] = static_cast<uint8_t>(srgb * 255.0 + 0.5);
+    }
+    return codes;
+  }();
+  return table[Quantize(linear, size - 1)];
+}
+
+MyColorMap::MyColorMap(vtkScalarsToColors* lut, const MyColorMapOptions& options)
+  : Options(options)
+{
+  if (!lut) return;
+
+  const double* range = lut->GetRange();
+  this->Range[0] = range[0];
+  this->Range[1] = range[1];
+  if (lut->UsingLogScale() || lut->GetIndexedLookup())
+  {
+    this->PerValue = lut;
+    return;
+  }
+
+  // a vtkLookupTable bins into exactly its own entries
+  vtkLookupTable* table = vtkLookupTable::SafeDownCast(lut);
+  this->Resolution = std::max<int>(1, table ? static_cast<int>(table->GetNumberOfTableValues()) : options.Resolution);
+  const double span = this->Range[1] - this->Range[0];
+  this->Scale = span > 0.0 ? this->Resolution / span : 0.0;
+
+  std::vector<LutColor> colors(this->Resolution + 3);
+  // sample every bin at its center, which the lookup table maps to that entry
+  const double outside = span > 0.0 ? span : 1.0;
+  colors[0] = MapValue(lut, this->Range[0] - outside);
+  for (int i = 0; i < this->Resolution; ++i)
+  {
+    colors[i + 1] = MapValue(lut, this->Range[0] + (i + 0.5) * span / this->Resolution);
+  }
+  colors[this->Resolution + 1] = MapValue(lut, this->Range[1] + outside);
+  colors[this->Resolution + 2] = MapValue(lut, vtkMath::Nan());
+
+  for (int f = 0; f < NumberOfPackedFormats; ++f)
+  {
+    this->Packed[f].resize(colors.size());
+    for (size_t i = 0; i < colors.size(); ++i) this->Packed[f][i] = Pack(colors[i], static_cast<MyColorFormat>(f));
+  }
+  this->Float4.resize(4 * colors.size());
+  for (size_t i = 0; i < colors.size(); ++i) std::memcpy(&this->Float4[4 * i], colors[i].Linear, 4 * sizeof(float));
+}
+
+template <typename T>
+void MyColorMap::ComputeIndices(const T* scalars, vtkIdType count, int32_t* indices) const
+{
+  const double lo = this->Range[0], hi = this->Range[1];
+#if MY_SIMD_X86
+  if (MyGetSimdLevel() >= MySimdAvx2)
+  {
+    Avx2Bins(scalars, count, indices, lo, hi, this->Scale, this->Resolution);
+    return;
+  }
+#endif
+  ScalarBins(scalars, count, indices, lo, hi, this->Scale, this->Resolution);
+}
+
+template <typename BinsT, typename ValueT>
+void MyColorMap::MapBlocks(vtkIdType count, void* colors, MyColorFormat format, BinsT&& bins, ValueT&& value) const
+{
+  uint8_t* out = static_cast<uint8_t*>(colors);
+  const int size = MyColorFormatSize(format);
+  if (this->PerValue)
+  {
+    for (vtkIdType i = 0; i < count; ++i) Store(MapValue(this->PerValue, value(i)), format, out + size * i);
+    return;
+  }
+  if (this->Float4.empty()) return;
+
+  MyParallelFor(this->Options.Parallel, count, [&](vtkIdType begin, vtkIdType end) {
+    int32_t blockBins[BlockSize];
+    for (vtkIdType b = begin; b < end; b += BlockSize)
+    {
+      const vtkIdType n = std::min(BlockSize, end - b);
+      bins(b, n, blockBins);
+      if (format == MyColorFormat::Float4)
+      {
+        Gather(this->Float4.data(), blockBins, n, out + size * b);
+      }
+      else
+      {
+        Gather(this->Packed[static_cast<int>(format)].data(), blockBins, n, out + size * b);
+      }
+    }
+  });
+}
+
+template <typename T>
+void MyColorMap::MapScalars(const T* scalars, vtkIdType count, void* colors, MyColorFormat format) const
+{
+  this->MapBlocks(
+    count, colors, format,
+    [&](vtkIdType begin, vtkIdType n, int32_t* bins) { this->ComputeIndices(scalars + begin, n, bins); },
+    [&](vtkIdType i) { return static_cast<double>(scalars[i]); });
+}
+
+void MyColorMap::Map(const float* scalars, vtkIdType count, void* colors, MyColorFormat format) const
+{
+  this->MapScalars(scalars, count, colors, format);
+}
+
+void MyColorMap::Map(const double* scalars, vtkIdType count, void* colors, MyColorFormat format) const
+{
+  this->MapScalars(scalars, count, colors, format);
+}
+
+vtkIdType MyColorMap::Map(const MyComponentView& scalars, void* colors, MyColorFormat format) const
+{
+  const vtkIdType count = scalars.GetNumberOfValues();
+  if (const float* floats = scalars.GetContiguous<float>())
+  {
+    this->MapScalars(floats, count, colors, format);
+  }
+  else if (const double* doubles = scalars.GetContiguous<double>())
+  {
+    this->MapScalars(doubles, count, colors, format);
+  }
+  else
+  {
+    // strided or other value types, read a block at a time where the bins are computed
+    this->MapBlocks(
+      count, colors, format,
+      [&](vtkIdType begin, vtkIdType n, int32_t* bins) {
+        double values[BlockSize];
+        scalars.Load(begin, n, values);
+        this->ComputeIndices(values, n, bins);
+      },
+      [&](vtkIdType i) { return scalars.GetValue(i); });
+  }
+  return count;
+}
+
+vtkIdType MyColorMap::Map(vtkDataArray* scalars, void* colors, MyColorFormat format, int component) const
+{
+  return this->Map(MyComponentView(scalars, component), colors, format);
+}
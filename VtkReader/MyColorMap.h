@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vtkDataArray.h>
+#include <vtkScalarsToColors.h>
+#include <vtkSmartPointer.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "MyComponentView.h"
+
+// Memory layout of one output color. Lookup table colors are taken as linear
+// values; the sRGB formats encode the color channels, alpha stays linear.
+enum class MyColorFormat
+{
+  RGBA8,      // bytes R, G, B, A
+  RGBA8_sRGB,
+  BGRA8,      // bytes B, G, R, A: Unreal's FColor
+  BGRA8_sRGB,
+  RGB10A2,    // one uint32, R in bits 0-9, G 10-19, B 20-29, A 30-31
+  Float4,     // floats R, G, B, A: Unreal's FLinearColor
+};
+
+// bytes per color
+inline int MyColorFormatSize(MyColorFormat format)
+{
+  return format == MyColorFormat::Float4 ? 4 * sizeof(float) : sizeof(uint32_t);
+}
+
+// 8-bit sRGB code of a linear [0, 1] value, from a precomputed table
+uint8_t MyLinearToSRGB8(float linear);
+
+struct MyColorMapOptions
+{
+  // samples taken from a vtkScalarsToColors that is not a vtkLookupTable;
+  // a vtkLookupTable is baked at its own number of table values
+  int Resolution = 4096;
+
+  // map with vtkSMPTools
+  bool Parallel = true;
+};
+
+// Scalar to color mapping without a mapper. The lookup table is baked once
+// into a table of colors over its range, plus its below range, above range
+// and NaN colors, in every MyColorFormat; scalars are then binned against that
+// range with AVX2 when the CPU has it and the colors gathered from the table.
+// Only CommonCore is needed, so it works in headless builds that do not link
+// RenderingCore.
+//
+// A vtkLookupTable gives the same colors as its MapValue / GetColor. Log scale
+// and indexed lookup tables cannot be binned linearly and are mapped through
+// the lookup table per value instead.
+class MyColorMap
+{
+public:
+  explicit MyColorMap(vtkScalarsToColors* lut, const MyColorMapOptions& options = {});
+
+  bool IsValid() const { return !this->Float4.empty() || this->PerValue; }
+  int GetResolution() const { return this->Resolution; }
+  const double* GetRange() const { return this->Range; }
+
+  // count scalars to count colors of MyColorFormatSize(format) bytes each
+  void Map(const float* scalars, vtkIdType count, void* colors, MyColorFormat format) const;
+  void Map(const double* scalars, vtkIdType count, void* colors, MyColorFormat format) const;
+
+  // every value of the view, read in place; returns the number of colors written
+  vtkIdType Map(const MyComponentView& scalars, void* colors, MyColorFormat format) const;
+  vtkIdType Map(vtkDataArray* scalars, void* colors, MyColorFormat format, int component = 0) const;
+
+private:
+  static constexpr int NumberOfPackedFormats = static_cast<int>(MyColorFormat::Float4);
+
+  template <typename T>
+  void ComputeIndices(const T* scalars, vtkIdType count, int32_t* indices) const;
+  template <typename BinsT, typename ValueT>
+  void MapBlocks(vtkIdType count, void* colors, MyColorFormat format, BinsT&& bins, ValueT&& value) const;
+  template <typename T>
+  void MapScalars(const T* scalars, vtkIdType count, void* colors, MyColorFormat format) const;
+
+  MyColorMapOptions Options;
+  int Resolution = 0;
+  double Range[2] = { 0.0, 1.0 };
+  double Scale = 0.0; // bins per unit of scalar
+
+  // [0] below range, [1, Resolution] the table, then above range and NaN;
+  // one 32-bit table per format before Float4
+  std::array<std::vector<uint32_t>, NumberOfPackedFormats> Packed;
+  std::vector<float> Float4;
+
+  // set when the table cannot be binned linearly
+  vtkSmartPointer<vtkScalarsToColors> PerValue;
+};
@@ -0,0 +1,65 @@
+#include "MyComponentView.h"
+
+#include <vtkAOSDataArrayTemplate.h>
+#include <vtkSOADataArrayTemplate.h>
+
+namespace {
+
+// where the values of component live in array, when they are in memory
+template <typename T>
+void Locate(vtkDataArray* array, int component, const void*& pointer, vtkIdType& stride)
+{
+  if (auto* aos = vtkAOSDataArrayTemplate<T>::FastDownCast(array))
+  {
+    pointer = aos->GetPointer(0) + component;
+    stride = aos->GetNumberOfComponents();
+  }
+  else if (auto* soa = vtkSOADataArrayTemplate<T>::FastDownCast(array))
+  {
+    pointer = soa->GetComponentArrayPointer(component);
+    stride = 1;
+  }
+}
+
+template <typename T>
+void LoadValues(const T* first, vtkIdType count, vtkIdType stride, double* values)
+{
+  for (vtkIdType i = 0; i < count; ++i) values[i] = static_cast<double>(first[i * stride]);
+}
+
+} // namespace
+
+MyComponentView::MyComponentView(vtkDataArray* array, int component)
+{
+  if (!array || component < 0 || component >= array->GetNumberOfComponents()) return;
+
+  this->Array = array;
+  this->Component = component;
+  this->DataType = array->GetDataType();
+  this->NumberOfValues = array->GetNumberOfTuples();
+  switch (this->DataType)
+  {
+    vtkTemplateMacro(Locate<VTK_TT>(array, component, this->Pointer, this->Stride));
+  }
+}
+
+double MyComponentView::GetValue(vtkIdType i) const
+{
+  double value;
+  this->Load(i, 1, &value);
+  return value;
+}
+
+void MyComponentView::Load(vtkIdType begin, vtkIdType count, double* values) const
+{
+  if (!this->Pointer)
+  {
+    for (vtkIdType i = 0; i < count; ++i) values[i] = this->Array->GetComponent(begin + i, this->Component);
+    return;
+  }
+  switch (this->DataType)
+  {
+    vtkTemplateMacro(
+      LoadValues(static_cast<const VTK_TT*>(this->Pointer) + begin * this->Stride, count, this->Stride, values));
+  }
+}
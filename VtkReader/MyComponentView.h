@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vtkDataArray.h>
+#include <vtkType.h>
+#include <vtkTypeTraits.h>
+
+// Non-owning view of one component of a data array: its first value and the
+// distance between values, read in place. Selecting component k of an
+// N-component array allocates and copies nothing; AOS arrays are seen with a
+// stride of N, SOA arrays through their component array with a stride of 1.
+// Arrays that do not keep their values in memory are read through the
+// vtkDataArray API.
+//
+// The view does not hold a reference, the array must outlive it.
+class MyComponentView
+{
+public:
+  MyComponentView() = default;
+  explicit MyComponentView(vtkDataArray* array, int component = 0);
+
+  bool IsValid() const { return this->Array != nullptr; }
+  vtkDataArray* GetArray() const { return this->Array; }
+  int GetComponent() const { return this->Component; }
+  vtkIdType GetNumberOfValues() const { return this->NumberOfValues; }
+
+  // VTK_FLOAT, VTK_DOUBLE, ... of the array, VTK_VOID when the view is invalid
+  int GetDataType() const { return this->DataType; }
+
+  // first value, null when the values are not in memory; GetStride() values apart
+  const void* GetPointer() const { return this->Pointer; }
+  vtkIdType GetStride() const { return this->Stride; }
+
+  // the values as one T[GetNumberOfValues()], null unless the array holds T
+  // and the component is contiguous
+  template <typename T>
+  const T* GetContiguous() const
+  {
+    return this->Stride == 1 && this->DataType == vtkTypeTraits<T>::VTK_TYPE_ID ?
+      static_cast<const T*>(this->Pointer) : nullptr;
+  }
+
+  double GetValue(vtkIdType i) const;
+
+  // values [begin, begin + count) converted to double
+  void Load(vtkIdType begin, vtkIdType count, double* values) const;
+
+private:
+  vtkDataArray* Array = nullptr;
+  int Component = 0;
+  int DataType = VTK_VOID;
+  vtkIdType NumberOfValues = 0;
+  const void* Pointer = nullptr;
+  vtkIdType Stride = 0;
+};
@@ -0,0 +1,463 @@
+#include "MyEdgeOverlay.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "MyAttributeExtract.h"
+#include "MyCellArrayView.h"
+#include "MySimd.h"
+
+namespace {
+
+uint64_t EdgeKey(vtkIdType a, vtkIdType b)
+{
+  if (a > b) std::swap(a, b);
+  return (static_cast<uint64_t>(a) << 32) | static_cast<uint32_t>(b);
+}
+
+struct Entry
+{
+  uint64_t Key;
+  vtkIdType Cell;
+};
+
+uint64_t KeyOf(uint64_t key) { return key; }
+uint64_t KeyOf(const Entry& entry) { return entry.Key; }
+
+vtkIdType NumberOfBlocks(vtkIdType count) { return (count + MyParallelGrain - 1) / MyParallelGrain; }
+
+// Stable LSD radix sort on 8-bit digits, one block of MyParallelGrain items per
+// task: every block counts its digits, the counts are scanned digit by digit
+// and block by block, and every block scatters its items from its own offsets.
+// Bytes that are equal in all keys, the high bytes of small point ids, are skipped.
+template <typename T>
+void RadixSort(std::vector<T>& items, bool parallel)
+{
+  const vtkIdType count = static_cast<vtkIdType>(items.size());
+  const vtkIdType numBlocks = NumberOfBlocks(count);
+  if (count < 2) return;
+
+  std::vector<uint64_t> blockAnd(numBlocks, ~uint64_t(0)), blockOr(numBlocks, 0);
+  MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      for (vtkIdType i = b * MyParallelGrain, last = std::min(count, i + MyParallelGrain); i < last; ++i)
+      {
+        blockAnd[b] &= KeyOf(items[i]);
+        blockOr[b] |= KeyOf(items[i]);
+      }
+    }
+  }, 1);
+  uint64_t allAnd = ~uint64_t(0), allOr = 0;
+  for (vtkIdType b = 0; b < numBlocks; ++b)
+  {
+    allAnd &= blockAnd[b];
+    allOr |= blockOr[b];
+  }
+  const uint64_t varying = allOr ^ allAnd;
+
+  std::vector<T> scratch(count);
+  std::vector<vtkIdType> offsets(256 * numBlocks);
+  for (int shift = 0; shift < 64; shift += 8)
+  {
+    if (((varying >> shift) & 0xff) == 0) continue;
+
+    MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType b = begin; b < end; ++b)
+      {
+        vtkIdType* digits = &offsets[256 * b];
+        std::fill(digits, digits + 256, 0);
+        for (vtkIdType i = b * MyParallelGrain, last = std::min(count, i + MyParallelGrain); i < last; ++i)
+        {
+          ++digits[(KeyOf(items[i]) >> shift) & 0xff];
+        }
+      }
+    }, 1);
+    vtkIdType sum = 0;
+    for (int d = 0; d < 256; ++d)
+    {
+      for (vtkIdType b = 0; b < numBlocks; ++b)
+      {
+        const vtkIdType n = offsets[256 * b + d];
+        offsets[256 * b + d] = sum;
+        sum += n;
+      }
+    }
+    MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType b = begin; b < end; ++b)
+      {
+        vtkIdType* digits = &offsets[256 * b];
+        for (vtkIdType i = b * MyParallelGrain, last = std::min(count, i + MyParallelGrain); i < last; ++i)
+        {
+          scratch[digits[(KeyOf(items[i]) >> shift) & 0xff]++] = items[i];
+        }
+      }
+    }, 1);
+    items.swap(scratch);
+  }
+}
+
+// Key of every run of equal keys of sorted items for which keep(first, count)
+// holds, in order: runs starting in a block are counted, the counts scanned,
+// and every block writes its runs from its own start
+template <typename T, typename KeepF>
+std::vector<uint64_t> SelectRuns(const std::vector<T>& items, bool parallel, KeepF&& keep)
+{
+  const vtkIdType count = static_cast<vtkIdType>(items.size());
+  const vtkIdType numBlocks = NumberOfBlocks(count);
+  std::vector<vtkIdType> blockStart(numBlocks + 1, 0);
+
+  auto forRuns = [&](vtkIdType b, auto&& visit) {
+    const vtkIdType last = std::min(count, (b + 1) * MyParallelGrain);
+    vtkIdType i = b * MyParallelGrain;
+    while (i > 0 && i < last && KeyOf(items[i]) == KeyOf(items[i - 1])) ++i;
+    while (i < last)
+    {
+      vtkIdType next = i + 1;
+      while (next < count && KeyOf(items[next]) == KeyOf(items[i])) ++next;
+      if (keep(i, next - i)) visit(KeyOf(items[i]));
+      i = next;
+    }
+  };
+
+  MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      forRuns(b, [&](uint64_t) { ++blockStart[b + 1]; });
+    }
+  }, 1);
+  for (vtkIdType b = 0; b < numBlocks; ++b) blockStart[b + 1] += blockStart[b];
+
+  std::vector<uint64_t> keys(blockStart[numBlocks]);
+  MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      vtkIdType out = blockStart[b];
+      forRuns(b, [&](uint64_t key) { keys[out++] = key; });
+    }
+  }, 1);
+  return keys;
+}
+
+// Half the width across one edge and the quad normal, zero for a degenerate edge
+void RibbonFrame(const double d[3], double halfWidth, double offset[3], double normal[3])
+{
+  offset[0] = offset[1] = offset[2] = 0.0;
+  normal[0] = normal[1] = normal[2] = 0.0;
+  const double r2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+  if (r2 < 1.e-8) return;
+
+  const double inv = 1.0 / std::sqrt(r2);
+  const double l[3] = { d[0] * inv, d[1] * inv, d[2] * inv };
+  double p[3];
+  const double h2 = l[0] * l[0] + l[1] * l[1];
+  if (h2 >= 1.e-8)
+  {
+    // direction x +Z
+    const double ih = 1.0 / std::sqrt(h2);
+    p[0] = l[1] * ih;
+    p[1] = -l[0] * ih;
+    p[2] = 0.0;
+  }
+  else
+  {
+    // vertical, direction x +Y
+    const double iv = 1.0 / std::sqrt(l[2] * l[2] + l[0] * l[0]);
+    p[0] = -l[2] * iv;
+    p[1] = 0.0;
+    p[2] = l[0] * iv;
+  }
+  for (int k = 0; k < 3; ++k) offset[k] = p[k] * halfWidth;
+
+  // p and l are unit and perpendicular, their cross product needs no normalizing
+  normal[0] = p[1] * l[2] - p[2] * l[1];
+  normal[1] = p[2] * l[0] - p[0] * l[2];
+  normal[2] = p[0] * l[1] - p[1] * l[0];
+}
+
+template <typename T>
+void StoreRibbon(const T* s, const T* t, const double offset[3], const double normal[3], T* vertices, T* normals)
+{
+  for (int k = 0; k < 3; ++k)
+  {
+    vertices[k] = static_cast<T>(s[k] - offset[k]);
+    vertices[3 + k] = static_cast<T>(s[k] + offset[k]);
+    vertices[6 + k] = static_cast<T>(t[k] + offset[k]);
+    vertices[9 + k] = static_cast<T>(t[k] - offset[k]);
+    normals[k] = normals[3 + k] = normals[6 + k] = normals[9 + k] = static_cast<T>(normal[k]);
+  }
+}
+
+template <typename T>
+void ScalarRibbons(const T* xyz, const int32_t* edges, vtkIdType begin, vtkIdType end, double halfWidth,
+  T* vertices, T* normals)
+{
+  for (vtkIdType e = begin; e < end; ++e)
+  {
+    const T* s = xyz + 3 * static_cast<vtkIdType>(edges[2 * e]);
+    const T* t = xyz + 3 * static_cast<vtkIdType>(edges[2 * e + 1]);
+    const double d[3] = { double(t[0]) - double(s[0]), double(t[1]) - double(s[1]), double(t[2]) - double(s[2]) };
+    double offset[3], normal[3];
+    RibbonFrame(d, halfWidth, offset, normal);
+    StoreRibbon(s, t, offset, normal, vertices + 12 * e, normals + 12 * e);
+  }
+}
+
+#if MY_SIMD_X86
+
+// coordinate k of the start and end points of four edges, widened to double
+MY_TARGET("avx2") __m256d GatherCoordinate(const double* xyz, __m256i base)
+{
+  return _mm256_i64gather_pd(xyz, base, 8);
+}
+
+MY_TARGET("avx2") __m256d GatherCoordinate(const float* xyz, __m256i base)
+{
+  return _mm256_cvtps_pd(_mm256_i64gather_ps(xyz, base, 4));
+}
+
+// RibbonFrame for four edges per register, both perpendiculars computed and
+// the vertical one blended in where the horizontal one degenerates
+template <typename T>
+MY_TARGET("avx2") void Avx2Ribbons(const T* xyz, const int32_t* edges, vtkIdType begin, vtkIdType end,
+  double halfWidth, T* vertices, T* normals)
+{
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d one = _mm256_set1_pd(1.0);
+  const __m256d tiny = _mm256_set1_pd(1.e-8);
+  const __m256d half = _mm256_set1_pd(halfWidth);
+  const __m256i three = _mm256_set1_epi64x(3);
+  vtkIdType e = begin;
+  for (; e + 4 <= end; e += 4)
+  {
+    // start and end ids of the four edges, interleaved in edges
+    const __m256i ids = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(edges + 2 * e)));
+    const __m256i ids2 = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(edges + 2 * e + 4)));
+    const __m256i starts = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(ids, ids2), 0xd8);
+    const __m256i ends = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(ids, ids2), 0xd8);
+    const __m256i sBase = _mm256_mul_epu32(starts, three);
+    const __m256i tBase = _mm256_mul_epu32(ends, three);
+
+    __m256d s[3], d[3];
+    for (int k = 0; k < 3; ++k)
+    {
+      const __m256i kk = _mm256_set1_epi64x(k);
+      s[k] = GatherCoordinate(xyz, _mm256_add_epi64(sBase, kk));
+      d[k] = _mm256_sub_pd(GatherCoordinate(xyz, _mm256_add_epi64(tBase, kk)), s[k]);
+    }
+
+    const __m256d r2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(d[0], d[0]), _mm256_mul_pd(d[1], d[1])),
+      _mm256_mul_pd(d[2], d[2]));
+    const __m256d valid = _mm256_cmp_pd(r2, tiny, _CMP_GE_OQ);
+    const __m256d inv = _mm256_div_pd(one, _mm256_sqrt_pd(_mm256_blendv_pd(one, r2, valid)));
+    const __m256d l[3] = { _mm256_mul_pd(d[0], inv), _mm256_mul_pd(d[1], inv), _mm256_mul_pd(d[2], inv) };
+
+    const __m256d h2 = _mm256_add_pd(_mm256_mul_pd(l[0], l[0]), _mm256_mul_pd(l[1], l[1]));
+    const __m256d v2 = _mm256_add_pd(_mm256_mul_pd(l[2], l[2]), _mm256_mul_pd(l[0], l[0]));
+    const __m256d horizontal = _mm256_cmp_pd(h2, tiny, _CMP_GE_OQ);
+    const __m256d inv2 = _mm256_div_pd(one, _mm256_sqrt_pd(_mm256_blendv_pd(_mm256_blendv_pd(one, v2, valid), h2, horizontal)));
+    __m256d p[3];
+    p[0] = _mm256_blendv_pd(_mm256_sub_pd(zero, l[2]), l[1], horizontal);
+    p[1] = _mm256_blendv_pd(zero, _mm256_sub_pd(zero, l[0]), horizontal);
+    p[2] = _mm256_blendv_pd(l[0], zero, horizontal);
+    for (int k = 0; k < 3; ++k) p[k] = _mm256_and_pd(_mm256_mul_pd(p[k], inv2), valid);
+
+    alignas(32) double offset[3][4], normal[3][4];
+    for (int k = 0; k < 3; ++k) _mm256_store_pd(offset[k], _mm256_mul_pd(p[k], half));
+    _mm256_store_pd(normal[0], _mm256_sub_pd(_mm256_mul_pd(p[1], l[2]), _mm256_mul_pd(p[2], l[1])));
+    _mm256_store_pd(normal[1], _mm256_sub_pd(_mm256_mul_pd(p[2], l[0]), _mm256_mul_pd(p[0], l[2])));
+    _mm256_store_pd(normal[2], _mm256_sub_pd(_mm256_mul_pd(p[0], l[1]), _mm256_mul_pd(p[1], l[0])));
+
+    for (int j = 0; j < 4; ++j)
+    {
+      const double o[3] = { offset[0][j], offset[1][j], offset[2][j] };
+      const double n[3] = { normal[0][j], normal[1][j], normal[2][j] };
+      const vtkIdType edge = e + j;
+      StoreRibbon(xyz + 3 * static_cast<vtkIdType>(edges[2 * edge]), xyz + 3 * static_cast<vtkIdType>(edges[2 * edge + 1]),
+        o, n, vertices + 12 * edge, normals + 12 * edge);
+    }
+  }
+  ScalarRibbons(xyz, edges, e, end, halfWidth, vertices, normals);
+}
+
+#endif // MY_SIMD_X86
+
+} // namespace
+
+MyEdgeExtractor::MyEdgeExtractor(const MyEdgeExtractOptions& options)
+  : Options(options)
+{
+}
+
+template <typename BeginF, typename IdF, typename PointF>
+void MyEdgeExtractor::Add(vtkIdType numCells, BeginF&& begin, IdF&& id, PointF&& point)
+{
+  const bool byKind = !this->Options.AllEdges;
+  const vtkIdType numBlocks = NumberOfBlocks(numCells);
+  const vtkIdType firstCell = static_cast<vtkIdType>(this->CellNormals.size() / 3);
+
+  // edges per block of polygons, scanned into the output position of each block
+  std::vector<vtkIdType> blockStart(numBlocks + 1, 0);
+  blockStart[0] = static_cast<vtkIdType>(this->Keys.size());
+  MyParallelFor(this->Options.Parallel, numBlocks, [&](vtkIdType first, vtkIdType last) {
+    for (vtkIdType b = first; b < last; ++b)
+    {
+      vtkIdType sum = 0;
+      for (vtkIdType c = b * MyParallelGrain, lastCell = std::min(numCells, c + MyParallelGrain); c < lastCell; ++c)
+      {
+        const vtkIdType n = begin(c + 1) - begin(c);
+        sum += n >= 3 ? n : 0;
+      }
+      blockStart[b + 1] = sum;
+    }
+  }, 1);
+  for (vtkIdType b = 0; b < numBlocks; ++b) blockStart[b + 1] += blockStart[b];
+
+  this->Keys.resize(blockStart[numBlocks]);
+  if (byKind)
+  {
+    this->Cells.resize(blockStart[numBlocks]);
+    this->CellNormals.resize(3 * (firstCell + numCells));
+  }
+
+  MyParallelFor(this->Options.Parallel, numBlocks, [&](vtkIdType first, vtkIdType last) {
+    for (vtkIdType b = first; b < last; ++b)
+    {
+      vtkIdType out = blockStart[b];
+      for (vtkIdType c = b * MyParallelGrain, lastCell = std::min(numCells, c + MyParallelGrain); c < lastCell; ++c)
+      {
+        const vtkIdType cb = begin(c), n = begin(c + 1) - cb;
+        if (n < 3) continue;
+        for (vtkIdType j = 0; j < n; ++j, ++out)
+        {
+          this->Keys[out] = EdgeKey(id(cb + j), id(cb + (j + 1 == n ? 0 : j + 1)));
+          if (byKind) this->Cells[out] = firstCell + c;
+        }
+        if (!byKind) continue;
+
+        // Newell normal, robust for non planar polygons
+        double normal[3] = { 0.0, 0.0, 0.0 }, a[3], bb[3];
+        point(cb + n - 1, a);
+        for (vtkIdType j = 0; j < n; ++j)
+        {
+          point(cb + j, bb);
+          normal[0] += (a[1] - bb[1]) * (a[2] + bb[2]);
+          normal[1] += (a[2] - bb[2]) * (a[0] + bb[0]);
+          normal[2] += (a[0] - bb[0]) * (a[1] + bb[1]);
+          std::copy(bb, bb + 3, a);
+        }
+        const double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        const double inv = length > 0.0 ? 1.0 / length : 0.0;
+        for (int k = 0; k < 3; ++k) this->CellNormals[3 * (firstCell + c) + k] = static_cast<float>(normal[k] * inv);
+      }
+    }
+  }, 1);
+}
+
+void MyEdgeExtractor::AddPolygons(vtkCellArray* polys, vtkPoints* points)
+{
+  const MyCellArrayView cells(polys);
+  std::vector<double> xyz;
+  if (!this->Options.AllEdges && points)
+  {
+    xyz.resize(3 * points->GetNumberOfPoints());
+    MyExtractComponents(points->GetData(), xyz.data(), { .Parallel = this->Options.Parallel });
+  }
+  this->Add(cells.GetNumberOfCells(),
+    [&](vtkIdType c) { return cells.Begin(c); },
+    [&](vtkIdType i) { return cells.Id(i); },
+    [&](vtkIdType i, double p[3]) {
+      if (xyz.empty())
+      {
+        p[0] = p[1] = p[2] = 0.0;
+        return;
+      }
+      std::copy_n(&xyz[3 * cells.Id(i)], 3, p);
+    });
+}
+
+void MyEdgeExtractor::AddPolygons(const vtkIdType* offsets, const vtkIdType* connectivity, vtkIdType numCells,
+  const vtkIdType* pointIds, const float* xyz)
+{
+  this->Add(numCells,
+    [&](vtkIdType c) { return offsets[c]; },
+    [&](vtkIdType i) { return pointIds[connectivity[i]]; },
+    [&](vtkIdType i, double p[3]) {
+      if (!xyz)
+      {
+        p[0] = p[1] = p[2] = 0.0;
+        return;
+      }
+      std::copy_n(xyz + 3 * connectivity[i], 3, p);
+    });
+}
+
+void MyEdgeExtractor::Extract()
+{
+  const bool parallel = this->Options.Parallel;
+  if (this->Options.AllEdges)
+  {
+    RadixSort(this->Keys, parallel);
+    this->Edges = SelectRuns(this->Keys, parallel, [](vtkIdType, vtkIdType) { return true; });
+  }
+  else
+  {
+    std::vector<Entry> entries(this->Keys.size());
+    MyParallelFor(parallel, static_cast<vtkIdType>(entries.size()), [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i) entries[i] = { this->Keys[i], this->Cells[i] };
+    });
+    RadixSort(entries, parallel);
+
+    const double cosAngle = std::cos(this->Options.FeatureAngle * 3.14159265358979323846 / 180.0);
+    this->Edges = SelectRuns(entries, parallel, [&](vtkIdType first, vtkIdType count) {
+      if (count == 1) return this->Options.BoundaryEdges;
+      if (count > 2) return this->Options.NonManifoldEdges;
+      if (!this->Options.FeatureEdges) return false;
+      const float* n0 = &this->CellNormals[3 * entries[first].Cell];
+      const float* n1 = &this->CellNormals[3 * entries[first + 1].Cell];
+      const double dot = double(n0[0]) * n1[0] + double(n0[1]) * n1[1] + double(n0[2]) * n1[2];
+      // a degenerate polygon has no normal to compare
+      const bool degenerate = (n0[0] == 0.0f && n0[1] == 0.0f && n0[2] == 0.0f) ||
+        (n1[0] == 0.0f && n1[1] == 0.0f && n1[2] == 0.0f);
+      return !degenerate && dot < cosAngle;
+    });
+  }
+
+  std::vector<uint64_t>().swap(this->Keys);
+  std::vector<vtkIdType>().swap(this->Cells);
+  std::vector<float>().swap(this->CellNormals);
+}
+
+template <typename T>
+void MyBuildEdgeRibbons(const T* xyz, const int32_t* edges, vtkIdType numEdges, double width, T* vertices,
+  T* normals, int32_t* indices, bool parallel)
+{
+  const double halfWidth = 0.5 * width;
+  MyParallelFor(parallel, numEdges, [&](vtkIdType begin, vtkIdType end) {
+#if MY_SIMD_X86
+    if (MyGetSimdLevel() >= MySimdAvx2)
+    {
+      Avx2Ribbons(xyz, edges, begin, end, halfWidth, vertices, normals);
+    }
+    else
+#endif
+    {
+      ScalarRibbons(xyz, edges, begin, end, halfWidth, vertices, normals);
+    }
+
+    for (vtkIdType e = begin; e < end; ++e)
+    {
+      const int32_t base = static_cast<int32_t>(4 * e);
+      int32_t* out = indices + 6 * e;
+      out[0] = base;
+      out[1] = base + 1;
+      out[2] = base + 2;
+      out[3] = base;
+      out[4] = base + 2;
+      out[5] = base + 3;
+    }
+  });
+}
+
+template void MyBuildEdgeRibbons<float>(const float*, const int32_t*, vtkIdType, double, float*, float*, int32_t*, bool);
+template void MyBuildEdgeRibbons<double>(const double*, const int32_t*, vtkIdType, double, double*, double*, int32_t*, bool);
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vtkCellArray.h>
+#include <vtkPoints.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "MyParallelFor.h"
+
+struct MyEdgeExtractOptions
+{
+  // every unique edge; when false only the kinds below, as vtkFeatureEdges
+  bool AllEdges = true;
+
+  // used by a single polygon
+  bool BoundaryEdges = true;
+
+  // between two polygons whose normals are more than FeatureAngle degrees apart
+  bool FeatureEdges = true;
+  double FeatureAngle = 30.0;
+
+  // used by three or more polygons
+  bool NonManifoldEdges = true;
+
+  // key, sort and select with vtkSMPTools
+  bool Parallel = true;
+};
+
+// Unique polygon edges for an edge overlay, in place of inserting every edge
+// into a hash set one at a time. Each polygon edge becomes a 64-bit key, the
+// lower point id in the high word, written on all threads from a prefix sum of
+// the cell sizes. A parallel LSD radix sort over only the key bytes that vary
+// brings equal edges together, and the runs of equal keys are the unique
+// edges: one polygon for a boundary edge, two for a manifold edge, whose
+// polygon normals give its dihedral angle.
+//
+// Polygons can be added in several pieces, the chunks of MyVtkCellStream for
+// instance. Point ids must fit in 32 bits.
+class MyEdgeExtractor
+{
+public:
+  explicit MyEdgeExtractor(const MyEdgeExtractOptions& options = {});
+
+  // Edges of every polygon of polys in their point ids. points is only read
+  // when edges are selected by kind.
+  void AddPolygons(vtkCellArray* polys, vtkPoints* points);
+
+  // Edges of numCells polygons given by offsets into connectivity of local
+  // point indices; edges are reported in pointIds[local]. xyz holds the
+  // coordinates of the local points, only read when edges are selected by kind.
+  void AddPolygons(const vtkIdType* offsets, const vtkIdType* connectivity, vtkIdType numCells,
+    const vtkIdType* pointIds, const float* xyz);
+
+  // Sorts and selects the edges added so far; the edges are then cleared
+  void Extract();
+
+  vtkIdType GetNumberOfEdges() const { return static_cast<vtkIdType>(this->Edges.size()); }
+
+  // Writes 2 * GetNumberOfEdges() point ids, lower id first, edges in
+  // increasing order of their ids
+  template <typename IndexT>
+  void Fill(IndexT* edges) const
+  {
+    MyParallelFor(this->Options.Parallel, this->GetNumberOfEdges(), [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType e = begin; e < end; ++e)
+      {
+        edges[2 * e] = static_cast<IndexT>(this->Edges[e] >> 32);
+        edges[2 * e + 1] = static_cast<IndexT>(this->Edges[e] & 0xffffffffu);
+      }
+    });
+  }
+
+private:
+  template <typename BeginF, typename IdF, typename PointF>
+  void Add(vtkIdType numCells, BeginF&& begin, IdF&& id, PointF&& point);
+
+  MyEdgeExtractOptions Options;
+  std::vector<uint64_t> Keys;
+  std::vector<vtkIdType> Cells;   // polygon of every key, when selecting by kind
+  std::vector<float> CellNormals; // unit normal of every polygon added, when selecting by kind
+  std::vector<uint64_t> Edges;
+};
+
+// Thin quads drawing edges as triangles, the visualizer's edge mesh: the
+// vertices start -o, start +o, end +o, end -o with o half of width across the
+// edge (perpendicular to it and to +Z, or to +Y for vertical edges), one flat
+// normal per quad and triangles (0, 1, 2), (0, 2, 3). Four edges at a time in
+// AVX2 registers when the CPU has it.
+//
+// xyz holds the packed points edges index; vertices and normals receive
+// 12 values, indices 6 per edge. Edges shorter than 1e-4 get zero offsets and
+// normals, like FVector::GetSafeNormal.
+template <typename T>
+void MyBuildEdgeRibbons(const T* xyz, const int32_t* edges, vtkIdType numEdges, double width, T* vertices,
+  T* normals, int32_t* indices, bool parallel = true);
@@ -0,0 +1,134 @@
+#include "MyMappedFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MyMappedFile::~MyMappedFile()
+{
+  this->Close();
+}
+
+#ifdef _WIN32
+
+bool MyMappedFile::Open(const char* fileName, bool copyOnWrite)
+{
+  this->Close();
+
+  HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr,
+    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return false;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size))
+  {
+    CloseHandle(file);
+    return false;
+  }
+
+  this->FileHandle = file;
+  this->Length = static_cast<size_t>(size.QuadPart);
+  this->Writable = copyOnWrite;
+  this->Opened = true;
+  if (this->Length == 0) return true;
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping)
+  {
+    this->Close();
+    return false;
+  }
+  this->MappingHandle = mapping;
+
+  this->Data = static_cast<char*>(MapViewOfFile(mapping, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+  if (!this->Data)
+  {
+    this->Close();
+    return false;
+  }
+  return true;
+}
+
+void MyMappedFile::Close()
+{
+  if (this->Data) UnmapViewOfFile(this->Data);
+  if (this->MappingHandle) CloseHandle(this->MappingHandle);
+  if (this->FileHandle) CloseHandle(this->FileHandle);
+  this->Data = nullptr;
+  this->MappingHandle = nullptr;
+  this->FileHandle = nullptr;
+  this->Length = 0;
+  this->Writable = false;
+  this->Opened = false;
+}
+
+void MyMappedFile::AdviseSequential(size_t, size_t) const
+{
+  // FILE_FLAG_SEQUENTIAL_SCAN on open already drives read-ahead
+}
+
+#else
+
+bool MyMappedFile::Open(const char* fileName, bool copyOnWrite)
+{
+  this->Close();
+
+  int fd = ::open(fileName, O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0)
+  {
+    ::close(fd);
+    return false;
+  }
+
+  this->Length = static_cast<size_t>(st.st_size);
+  this->Writable = copyOnWrite;
+  this->Opened = true;
+  if (this->Length == 0)
+  {
+    ::close(fd);
+    return true;
+  }
+
+  int prot = copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+  void* data = ::mmap(nullptr, this->Length, prot, MAP_PRIVATE, fd, 0);
+  // the mapping keeps its own reference to the file
+  ::close(fd);
+  if (data == MAP_FAILED)
+  {
+    this->Close();
+    return false;
+  }
+  this->Data = static_cast<char*>(data);
+  return true;
+}
+
+void MyMappedFile::Close()
+{
+  if (this->Data) ::munmap(this->Data, this->Length);
+  this->Data = nullptr;
+  this->Length = 0;
+  this->Writable = false;
+  this->Opened = false;
+}
+
+void MyMappedFile::AdviseSequential(size_t offset, size_t length) const
+{
+  if (!this->Data) return;
+  // madvise wants a page aligned start
+  const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  size_t begin = offset - offset % page;
+  size_t end = length ? offset + length : this->Length;
+  if (end > this->Length) end = this->Length;
+  ::madvise(this->Data + begin, end - begin, MADV_SEQUENTIAL);
+}
+
+#endif
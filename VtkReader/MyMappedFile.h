@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// Read-only view of a whole file through the OS page cache.
+// Nothing is copied into process memory until a page is touched.
+class MyMappedFile
+{
+public:
+  MyMappedFile() = default;
+  ~MyMappedFile();
+
+  MyMappedFile(const MyMappedFile&) = delete;
+  MyMappedFile& operator=(const MyMappedFile&) = delete;
+
+  // copyOnWrite maps the pages private and writable; writes stay in this process
+  bool Open(const char* fileName, bool copyOnWrite = false);
+  void Close();
+
+  bool IsOpen() const { return this->Opened; }
+  const char* GetData() const { return this->Data; }
+  char* GetWritableData() const { return this->Writable ? this->Data : nullptr; }
+  size_t GetSize() const { return this->Length; }
+  std::string_view View() const { return { this->Data, this->Length }; }
+
+  // hint the kernel that [offset, offset+length) is read front to back
+  void AdviseSequential(size_t offset = 0, size_t length = 0) const;
+
+private:
+  char* Data = nullptr;
+  size_t Length = 0;
+  bool Writable = false;
+  bool Opened = false;
+#ifdef _WIN32
+  void* FileHandle = nullptr;
+  void* MappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,286 @@
+#include "MyMeshCache.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+
+namespace {
+
+// XXH64, reading words in host order
+constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t Prime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t Rotl(uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t Read64(const unsigned char* p)
+{
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+
+inline uint32_t Read32(const unsigned char* p)
+{
+  uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input)
+{
+  acc += input * Prime2;
+  return Rotl(acc, 31) * Prime1;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t value)
+{
+  acc ^= Round(0, value);
+  return acc * Prime1 + Prime4;
+}
+
+uint64_t Hash64(const void* data, size_t length, uint64_t seed = 0)
+{
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  const unsigned char* end = p + length;
+  uint64_t h;
+
+  if (length >= 32)
+  {
+    uint64_t v1 = seed + Prime1 + Prime2, v2 = seed + Prime2, v3 = seed, v4 = seed - Prime1;
+    for (const unsigned char* limit = end - 32; p <= limit; p += 32)
+    {
+      v1 = Round(v1, Read64(p));
+      v2 = Round(v2, Read64(p + 8));
+      v3 = Round(v3, Read64(p + 16));
+      v4 = Round(v4, Read64(p + 24));
+    }
+    h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+    h = MergeRound(h, v1);
+    h = MergeRound(h, v2);
+    h = MergeRound(h, v3);
+    h = MergeRound(h, v4);
+  }
+  else
+  {
+    h = seed + Prime5;
+  }
+  h += length;
+
+  for (; p + 8 <= end; p += 8) h = Rotl(h ^ Round(0, Read64(p)), 27) * Prime1 + Prime4;
+  if (p + 4 <= end)
+  {
+    h = Rotl(h ^ (Read32(p) * Prime1), 23) * Prime2 + Prime3;
+    p += 4;
+  }
+  for (; p < end; ++p) h = Rotl(h ^ (*p * Prime5), 11) * Prime1;
+
+  h ^= h >> 33;
+  h *= Prime2;
+  h ^= h >> 29;
+  h *= Prime3;
+  h ^= h >> 32;
+  return h;
+}
+
+enum Section
+{
+  Positions,
+  Normals,
+  UVs,
+  Colors,
+  Tangents,
+  Triangles,
+  Edges,
+  NumberOfSections
+};
+
+struct SectionEntry
+{
+  uint64_t Offset; // from the start of the file, 64-byte aligned
+  uint64_t Count;  // 4-byte elements
+};
+
+// file layout: header, params text, then the sections in enum order
+struct FileHeader
+{
+  char Magic[8];
+  uint32_t Version;
+  uint32_t ByteOrderMark; // 0x01020304 as written by the host
+  uint64_t ContentHash;
+  uint64_t ParamsSize;
+  SectionEntry Sections[NumberOfSections];
+};
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+
+constexpr char Magic[8] = { 'V', 'T', 'K', 'M', 'E', 'S', 'H', '\0' };
+constexpr uint32_t ByteOrderMark = 0x01020304;
+constexpr uint64_t SectionAlignment = 64;
+
+uint64_t AlignUp(uint64_t offset)
+{
+  return (offset + SectionAlignment - 1) & ~(SectionAlignment - 1);
+}
+
+} // namespace
+
+bool MyHashFileContent(const char* fileName, uint64_t& hash)
+{
+  MyMappedFile file;
+  if (!file.Open(fileName)) return false;
+  file.AdviseSequential();
+  hash = Hash64(file.GetData(), file.GetSize());
+  return true;
+}
+
+bool MyMakeMeshCacheKey(const char* fileName, std::string_view params, MyMeshCacheKey& key)
+{
+  if (!MyHashFileContent(fileName, key.ContentHash)) return false;
+  key.Params = params;
+  return true;
+}
+
+MyMeshCache::MyMeshCache(std::string directory)
+  : Directory(std::move(directory))
+{
+}
+
+std::string MyMeshCache::GetEntryPath(const MyMeshCacheKey& key) const
+{
+  char name[64];
+  std::snprintf(name, sizeof(name), "%016llx-%016llx.vtkmesh",
+    static_cast<unsigned long long>(key.ContentHash),
+    static_cast<unsigned long long>(Hash64(key.Params.data(), key.Params.size())));
+  return (std::filesystem::path(this->Directory) / name).string();
+}
+
+bool MyMeshCache::Load(const MyMeshCacheKey& key, MyMeshCacheView& view) const
+{
+  auto file = std::make_shared<MyMappedFile>();
+  if (!file->Open(this->GetEntryPath(key).c_str())) return false;
+
+  // a miss on anything unexpected, the entry is rewritten after the conversion
+  const size_t size = file->GetSize();
+  FileHeader header;
+  if (size < sizeof(header)) return false;
+  std::memcpy(&header, file->GetData(), sizeof(header));
+  if (std::memcmp(header.Magic, Magic, sizeof(Magic)) != 0 || header.Version != Version ||
+      header.ByteOrderMark != ByteOrderMark || header.ContentHash != key.ContentHash ||
+      header.ParamsSize != key.Params.size() || size - sizeof(header) < header.ParamsSize ||
+      std::memcmp(file->GetData() + sizeof(header), key.Params.data(), key.Params.size()) != 0)
+  {
+    return false;
+  }
+
+  for (const SectionEntry& section : header.Sections)
+  {
+    if (section.Offset % SectionAlignment != 0 || section.Offset > size || (size - section.Offset) / 4 < section.Count)
+    {
+      std::cerr << "MyMeshCache: corrupt entry " << this->GetEntryPath(key) << std::endl;
+      return false;
+    }
+  }
+
+  const char* data = file->GetData();
+  auto floats = [&](Section s) {
+    return std::span<const float>(reinterpret_cast<const float*>(data + header.Sections[s].Offset), header.Sections[s].Count);
+  };
+  auto ints = [&](Section s) {
+    return std::span<const int32_t>(reinterpret_cast<const int32_t*>(data + header.Sections[s].Offset), header.Sections[s].Count);
+  };
+  view.Positions = floats(Positions);
+  view.Normals = floats(Normals);
+  view.UVs = floats(UVs);
+  view.Colors = floats(Colors);
+  view.Tangents = floats(Tangents);
+  view.Triangles = ints(Triangles);
+  view.Edges = ints(Edges);
+  view.File = std::move(file);
+  return true;
+}
+
+bool MyMeshCache::Store(const MyMeshCacheKey& key, const MyMeshBuffers& buffers) const
+{
+  struct Payload { const void* Data; size_t Count; };
+  const Payload payloads[NumberOfSections] = {
+    { buffers.Positions.data(), buffers.Positions.size() },
+    { buffers.Normals.data(), buffers.Normals.size() },
+    { buffers.UVs.data(), buffers.UVs.size() },
+    { buffers.Colors.data(), buffers.Colors.size() },
+    { buffers.Tangents.data(), buffers.Tangents.size() },
+    { buffers.Triangles.data(), buffers.Triangles.size() },
+    { buffers.Edges.data(), buffers.Edges.size() },
+  };
+
+  FileHeader header = {};
+  std::memcpy(header.Magic, Magic, sizeof(Magic));
+  header.Version = Version;
+  header.ByteOrderMark = ByteOrderMark;
+  header.ContentHash = key.ContentHash;
+  header.ParamsSize = key.Params.size();
+  uint64_t offset = sizeof(header) + key.Params.size();
+  for (int s = 0; s < NumberOfSections; ++s)
+  {
+    offset = AlignUp(offset);
+    header.Sections[s] = { offset, payloads[s].Count };
+    offset += payloads[s].Count * 4;
+  }
+
+  std::error_code error;
+  std::filesystem::create_directories(this->Directory, error);
+
+  // unique temporary name per writer, renamed over the entry when complete
+  static std::atomic<unsigned> counter{ 0 };
+  const std::string entryPath = this->GetEntryPath(key);
+  const std::string tempPath = entryPath + "." +
+    std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+                   static_cast<size_t>(std::chrono::steady_clock::now().time_since_epoch().count())) +
+    "." + std::to_string(counter++) + ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+      std::cerr << "MyMeshCache: cannot write " << tempPath << std::endl;
+      return false;
+    }
+
+    static const char padding[SectionAlignment] = {};
+    uint64_t written = sizeof(header) + key.Params.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(key.Params.data(), static_cast<std::streamsize>(key.Params.size()));
+    for (int s = 0; s < NumberOfSections; ++s)
+    {
+      out.write(padding, static_cast<std::streamsize>(header.Sections[s].Offset - written));
+      out.write(static_cast<const char*>(payloads[s].Data), static_cast<std::streamsize>(payloads[s].Count * 4));
+      written = header.Sections[s].Offset + payloads[s].Count * 4;
+    }
+    if (!out.flush())
+    {
+      out.close();
+      std::filesystem::remove(tempPath, error);
+      std::cerr << "MyMeshCache: cannot write " << tempPath << std::endl;
+      return false;
+    }
+  }
+
+  std::filesystem::rename(tempPath, entryPath, error);
+  if (error)
+  {
+    std::filesystem::remove(tempPath, error);
+    std::cerr << "MyMeshCache: cannot replace " << entryPath << std::endl;
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MyMappedFile.h"
+
+// Final engine-ready buffers of one converted mesh, flat and engine agnostic
+struct MyMeshBuffers
+{
+  std::vector<float> Positions; // xyz per vertex
+  std::vector<float> Normals;   // xyz per vertex
+  std::vector<float> UVs;       // uv per vertex
+  std::vector<float> Colors;    // linear rgba per vertex
+  std::vector<float> Tangents;  // xyz + binormal sign per vertex
+  std::vector<int32_t> Triangles;
+  std::vector<int32_t> Edges;   // index pairs
+};
+
+// A cache entry mapped read-only; the spans point into the mapping and stay
+// valid as long as the view does.
+struct MyMeshCacheView
+{
+  std::span<const float> Positions;
+  std::span<const float> Normals;
+  std::span<const float> UVs;
+  std::span<const float> Colors;
+  std::span<const float> Tangents;
+  std::span<const int32_t> Triangles;
+  std::span<const int32_t> Edges;
+
+  std::shared_ptr<MyMappedFile> File;
+};
+
+// What a converted mesh depends on: the source file content and every
+// conversion parameter, spelled out as text (e.g. "MaxSubdivisions=3;LUT=my_table")
+struct MyMeshCacheKey
+{
+  uint64_t ContentHash = 0;
+  std::string Params;
+};
+
+// Hash the whole content of fileName; false when it cannot be read
+bool MyHashFileContent(const char* fileName, uint64_t& hash);
+
+// Builds the key for fileName; false when the file cannot be read
+bool MyMakeMeshCacheKey(const char* fileName, std::string_view params, MyMeshCacheKey& key);
+
+// Converted meshes on disk, one file per key in directory.
+// The files are host byte order with 64-byte aligned sections so a hit is a
+// single mmap; stale or foreign files are treated as misses. Writes go to a
+// temporary file first, so concurrent editors never see half an entry.
+class MyMeshCache
+{
+public:
+  // bumped whenever the file layout changes
+  static constexpr uint32_t Version = 1;
+
+  explicit MyMeshCache(std::string directory);
+
+  bool Load(const MyMeshCacheKey& key, MyMeshCacheView& view) const;
+  bool Store(const MyMeshCacheKey& key, const MyMeshBuffers& buffers) const;
+
+  std::string GetEntryPath(const MyMeshCacheKey& key) const;
+
+private:
+  std::string Directory;
+};
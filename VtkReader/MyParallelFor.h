@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vtkSMPTools.h>
+#include <vtkType.h>
+
+// Fewer items than this per task are not worth handing to another thread
+constexpr vtkIdType MyParallelGrain = 1 << 14;
+
+// vtkSMPTools::For over [0, count) in chunks of grain when parallel is set and
+// there is more than one chunk of work, otherwise body(0, count) on this thread
+template <typename F>
+void MyParallelFor(bool parallel, vtkIdType count, F&& body, vtkIdType grain = MyParallelGrain)
+{
+  if (parallel && count > grain)
+  {
+    vtkSMPTools::For(0, count, grain, body);
+  }
+  else if (count > 0)
+  {
+    body(0, count);
+  }
+}
@@ -23,9 +23,6 @@
 #include <vtkUnstructuredGrid.h>
 #include <vtkPointData.h>
 #include <vtkCellData.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkLookupTable.h>
 #include <vtkFloatArray.h>
 #include <vtkTessellatorFilter.h>
@@ -33,11 +30,24 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <random>
 #include <string>
 #include <vector>
 #include <math.h>
 
+#include "MyAttributeExtract.h"
+#include "MyColorMap.h"
+#include "MyComponentView.h"
+#include "MyScalarRange.h"
+#include "MySplitVertices.h"
+#include "MyStageProfile.h"
+#include "MyTangents.h"
+#include "MyTrace.h"
+#include "MyVtkLoader.h"
+#include "MyTriangulateCleanNormals.h"
+#include "MyVertexGather.h"
+
 // 1. Not use generic poly reader but use PolyReader
 // 2. Use PolyMapper to map colors from LUT
 // 3. Don't use lookuptable when use mapper
@@ -85,10 +95,11 @@ vtkStandardNewMacro(MyCustomInteractorStyle);
 
 
 // UE에서 문제되는 코드 비교 테스트, 최종 적으로는 vtkPolyDataReader에서 읽은 vtkPolyData 그대로 리턴
-vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName);
-
-// polydata 파일에서 color 데이터 직접 파싱해서 갖고 오기
-vtkSmartPointer<vtkLookupTable> create_lookup_table_from_vtk(const std::string& vtkFilePath, const std::string& tableName);
+// loaded, if given, receives the raw polydata and the lookup tables of the same single read
+// options default to the parallel mode, large ASCII bodies are parsed on all cores,
+// and to loading only the arrays this viewer uses
+vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName, MyVtkLoadResult* loaded = nullptr,
+  const MyVtkLegacyReadOptions* options = nullptr);
 
 int main(int argc, char* argv[])
 {
@@ -119,15 +130,21 @@ int main(int argc, char* argv[])
   {
     std::cout << "Loading: " << argv[i] << std::endl;
     std::string vtkFileName = argv[i];
-    auto polyData = MyReadPolyData(vtkFileName.c_str());
+    MyVtkLoadResult loaded;
+    auto polyData = MyReadPolyData(vtkFileName.c_str(), &loaded);
+    if (!polyData) {
+      continue;
+    }
 
     // 1. 셀 격자화
+    MyStage tessellateStage("tessellate");
     vtkNew<vtkTessellatorFilter> tessel;
     tessel->SetInputData(polyData);
     tessel->SetMaximumNumberOfSubdivisions(3); // 3 x 3 격자
     tessel->Update();
+    tessellateStage.Stop();
     auto processedData = tessel->GetOutput();
-    std::cerr << "After Tessel, numcell= " << (int)processedData->GetNumberOfCells() << std::endl;
+    MY_TRACE(MyTraceInfo, "After Tessel, numcell=%lld", static_cast<long long>(processedData->GetNumberOfCells()));
 
     
     // 2. 매퍼 설정
@@ -140,11 +157,19 @@ int main(int argc, char* argv[])
     mapper->InterpolateScalarsBeforeMappingOn(); // 색상 보간
     
     // 3. 스칼라 범위
-    double* scalRange = polyData->GetPointData()->GetArray(scalarName.c_str())->GetRange();
-    std::cerr << "Scalar ranges: [ " << scalRange[0] << ", " << scalRange[1] << " ]" << std::endl;
+    double scalRange[2] = { 0.0, 1.0 };
+    MyGetScalarRange(polyData->GetPointData()->GetArray(scalarName.c_str()), scalRange);
+    MY_TRACE(MyTraceInfo, "Scalar ranges: [%g, %g]", scalRange[0], scalRange[1]);
 
-    // 4. 색상 테이블
-    vtkSmartPointer<vtkLookupTable> lut = create_lookup_table_from_vtk(vtkFileName,"my_table");
+    // 4. 색상 테이블, parsed along with the polydata
+    vtkSmartPointer<vtkLookupTable> lut = loaded.FindLookupTable("my_table");
+    if (!lut) {
+      MY_TRACE(MyTraceError, "Error, lookuptable my_table not found in %s", vtkFileName.c_str());
+      lut = vtkSmartPointer<vtkLookupTable>::New();
+      lut->SetNumberOfTableValues(256);
+      lut->SetHueRange(0.667f, 0.0f); // 파랑 -> 빨강
+      lut->Build();
+    }
     lut->SetTableRange(scalRange[0], scalRange[1]);
     mapper->SetLookupTable(lut);
 
@@ -175,43 +200,37 @@ int main(int argc, char* argv[])
 }
 
 
-vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
+vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName, MyVtkLoadResult* loaded,
+  const MyVtkLegacyReadOptions* options)
 {
-  vtkNew<vtkPolyDataReader> reader;
-  reader->SetFileName(fileName);
-  reader->Update();
-  vtkSmartPointer<vtkPolyData> rawPoly = reader->GetOutput();
-
-  if (!rawPoly || !rawPoly->GetPoints()) {
-      std::cerr << "MyRead invalid polydata or no points" << std::endl;
+  MyVtkLoadResult localLoad;
+  MyVtkLoadResult& load = loaded ? *loaded : localLoad;
+  MyVtkLegacyReadOptions defaults;
+  defaults.Parallel = true;
+  // only these arrays are used below, bodies of every other array are skipped
+  defaults.ArrayNames = { "custom_table_scalars", "cell_normals", "faceAttributes" };
+  MyStage readStage("read");
+  if (!MyLoadPolyDataWithLookupTables(fileName, load, options ? *options : defaults)) {
+      MY_TRACE(MyTraceError, "MyRead invalid polydata or no points: %s", fileName);
       return nullptr;
   }
+  vtkSmartPointer<vtkPolyData> rawPoly = load.PolyData;
+  readStage.Stop();
 
   // Below, It's just verify to translate everything in polydata
   vtkIdType numPoints = rawPoly->GetNumberOfPoints();
-  std::cerr << "MyRead raw polydata points=" << numPoints << std::endl;
+  MY_TRACE(MyTraceInfo, "MyRead raw polydata points=%lld", static_cast<long long>(numPoints));
 
   // Ensure mesh is triangulated, Must be triangled if use other renderer
   #define USE_TRY_TRIANGLED 1
   #if USE_TRY_TRIANGLED  // translate triangled poly
-  vtkNew<vtkTriangleFilter> triaf;
-  triaf->SetInputData(rawPoly);
-  triaf->Update();
-
-  vtkNew<vtkCleanPolyData> clean;
-  clean->SetInputConnection(triaf->GetOutputPort());
-  clean->Update();
-
-  #if 0
-  vtkNew<vtkPolyDataNormals> normf;
-  normf->SetInputConnection(clean->GetOutputPort());
-  // TODO: Need to determin API via checking what's the kind of normals if point_normals or cell_normals in .vtk file
-  normf->ComputePointNormalsOff(); // explicitly turn off pointnormal, if polydata has only cell_normals like cube-colortable-correct.vtk
-  normf->ComputeCellNormalsOn();
-  normf->Update();
-  vtkSmartPointer<vtkPolyData> poly = normf->GetOutput();
-  #endif
-  vtkSmartPointer<vtkPolyData> poly = clean->GetOutput();
+  // triangulate + clean in one pass, no intermediate polydata per filter.
+  // point normals stay off, polydata like cube-colortable-correct.vtk has only cell_normals
+  MyTriangulateCleanNormalsOptions fusedOptions;
+  fusedOptions.ComputePointNormals = false;
+  MyStage triangulateStage("triangulate+clean");
+  vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(rawPoly, fusedOptions);
+  triangulateStage.Stop();
   // final output
 #else
 vtkSmartPointer<vtkPolyData> poly = rawPoly;
@@ -221,18 +240,18 @@ vtkSmartPointer<vtkPolyData> poly = rawPoly;
 
   if (!points || !points->GetData())
   {
-      std::cerr << "MyRead invalid points" << std::endl; // points is null, Why can't get point data through vtkPoints? but we can traverse point data via vtkPolyData's GetPoint()
+      MY_TRACE(MyTraceError, "MyRead invalid points"); // points is null, Why can't get point data through vtkPoints? but we can traverse point data via vtkPolyData's GetPoint()
       return poly;
   }
 
   numPoints = poly->GetNumberOfPoints();
-  std::cerr << "MyRead points=" << numPoints << std::endl;
+  MY_TRACE(MyTraceInfo, "MyRead points=%lld", static_cast<long long>(numPoints));
 
   vtkPointData* pointData = poly->GetPointData();
   vtkCellData* cellData = poly->GetCellData();
   if (!cellData)
   {
-     std::cerr << "MyRead invalid celldata" << std::endl;
+     MY_TRACE(MyTraceError, "MyRead invalid celldata");
      return poly;
   }
 
@@ -240,15 +259,14 @@ vtkSmartPointer<vtkPolyData> poly = rawPoly;
   vtkDataArray* pointNormals = poly->GetPointData()->GetNormals();
   if (!pointNormals)
   {
-      std::cerr << "MyRead point normals is none" << std::endl;
+      MY_TRACE(MyTraceDebug, "MyRead point normals is none");
     //   return poly;
   }
 
   vtkDataArray* cellNormals = cellData->GetNormals(); // 언리얼에서 Crash 
-  std::cerr << "MyRead okay cell normals" << std::endl;
   if (!cellNormals)
   {
-    std::cerr << "MyRead cell normals is none" << std::endl;
+    MY_TRACE(MyTraceDebug, "MyRead cell normals is none");
   }
 
   // 3. Scalars
@@ -256,16 +274,15 @@ vtkSmartPointer<vtkPolyData> poly = rawPoly;
   vtkUnsignedCharArray* pointColorArray = nullptr;
   if (!pointScalars)
   {
-    std::cerr << "MyRead point scalars none" << std::endl;
+    MY_TRACE(MyTraceDebug, "MyRead point scalars none");
   }
   else
   {
-    std::cerr << "MyRead okay point scalars" << ": numComp="
-    << pointScalars->GetNumberOfComponents() << ", numTuple="
-    << pointScalars->GetNumberOfTuples() << std::endl;
+    MY_TRACE(MyTraceDebug, "MyRead okay point scalars: numComp=%d, numTuple=%lld",
+      pointScalars->GetNumberOfComponents(), static_cast<long long>(pointScalars->GetNumberOfTuples()));
     pointColorArray = vtkUnsignedCharArray::SafeDownCast(pointScalars); // Cast failed
     if (!pointColorArray) {
-      std::cerr << "point color array none" << std::endl;
+      MY_TRACE(MyTraceDebug, "point color array none");
     }
   }
 
@@ -273,21 +290,15 @@ vtkSmartPointer<vtkPolyData> poly = rawPoly;
   vtkUnsignedCharArray* cellColorArray = nullptr;
   if (!cellScalars)
   {
-    std::cerr << "MyRead cell scalars none" << std::endl;
+    MY_TRACE(MyTraceDebug, "MyRead cell scalars none");
   }
   else
   {
-    std::cerr << "MyRead okay cell scalars" << ": numComp="
-    << cellScalars->GetNumberOfComponents() << ", numTuple="
-    << cellScalars->GetNumberOfTuples() << std::endl;
+    MY_TRACE(MyTraceDebug, "MyRead okay cell scalars: numComp=%d, numTuple=%lld",
+      cellScalars->GetNumberOfComponents(), static_cast<long long>(cellScalars->GetNumberOfTuples()));
     cellColorArray = vtkUnsignedCharArray::SafeDownCast(cellScalars); // Cast failed
     if (!cellColorArray) {
-      std::cerr << "cell color array none" << std::endl; // True
-    }
-    else {
-      std::cerr << "MyRead okay cell color array" << ": numComp="
-    << cellColorArray->GetNumberOfComponents() << ", numTuple="
-    << cellColorArray->GetNumberOfTuples() << std::endl;
+      MY_TRACE(MyTraceDebug, "cell color array none"); // True
     }
   }
 
@@ -295,53 +306,36 @@ vtkSmartPointer<vtkPolyData> poly = rawPoly;
   vtkFieldData* cellField  = poly->GetCellData();
   vtkDataArray* faceAttributesFieldArray = cellField->GetArray("faceAttributes");// True
   if (!faceAttributesFieldArray) {
-        std::cerr << "Error: 'faceAttributes' array not found in Cell FieldData!" << std::endl;
+        MY_TRACE(MyTraceError, "MyRead 'faceAttributes' array not found in Cell FieldData");
         std::remove(fileName);
         return poly;
   }
 
   // Since faceAttributes has 2 components per cell (e.g., value and something else),
-  // we need to extract a single component to use for coloring with a 1D lookup table.
-  // Let's use the first component (index 0) for coloring.
-    vtkNew<vtkFloatArray> coloringScalars;
-    coloringScalars->SetName("FaceColoringScalars");
-    coloringScalars->SetNumberOfComponents(1);
-    coloringScalars->SetNumberOfValues(poly->GetNumberOfCells());
-
-    double rangeMin = VTK_FLOAT_MAX;
-    double rangeMax = VTK_FLOAT_MIN;
-
-    for (vtkIdType i = 0; i < poly->GetNumberOfCells(); ++i) {
-        double val = faceAttributesFieldArray->GetComponent(i, 0); // Get the first component
-        coloringScalars->SetValue(i, val);
-        if (val < rangeMin) rangeMin = val;
-        if (val > rangeMax) rangeMax = val;
-    }
-    std::cout << "Extracted 'FaceColoringScalars' from 'faceAttributes' component 0." << std::endl;
-    std::cout << "  Scalar range for coloring: [" << rangeMin << ", " << rangeMax << "]" << std::endl;
-
-    // Add this new scalar array to the CellData as the active scalars for coloring
-    poly->GetCellData()->SetScalars(coloringScalars); // 언리얼에서 Crash
- 
+  // we color with a 1D lookup table over a single component, the first one (index 0),
+  // viewed in place instead of copied into an array of its own.
+    const MyComponentView faceScalars(faceAttributesFieldArray, 0);
+    double faceRange[2] = { VTK_FLOAT_MAX, VTK_FLOAT_MIN };
+    MyGetScalarRange(faceScalars, faceRange);
+    MY_TRACE(MyTraceInfo, "MyRead coloring with 'faceAttributes' component 0, range [%g, %g]", faceRange[0],
+      faceRange[1]);
   
   // 3. Colors
-     cellScalars = poly->GetCellData()->GetScalars();
     // vtkSmartPointer<vtkLookupTable> lut = vtkSmartPointer<vtkLookupTable>::New();
     vtkSmartPointer<vtkScalarsToColors> lut = nullptr;
     if (pointScalars) {
         lut = pointScalars->GetLookupTable();
-    } else if (cellScalars) {
-        lut = cellScalars->GetLookupTable();
+    } else if (faceScalars.IsValid()) {
+        lut = faceAttributesFieldArray->GetLookupTable();
     }
 
     if (!lut) {
-        std::cerr << "not found lookup table from scalars" << std::endl;
+        MY_TRACE(MyTraceDebug, "MyRead no lookup table on the scalars, generating one");
         // Fallback: generate LUT manually
         vtkNew<vtkLookupTable> generatedLut;
-        if (pointScalars)
-            generatedLut->SetTableRange(pointScalars->GetRange());
-        else if (cellScalars)
-            generatedLut->SetTableRange(cellScalars->GetRange());
+        double scalarRange[2];
+        if (pointScalars ? MyGetScalarRange(pointScalars, scalarRange) : MyGetScalarRange(faceScalars, scalarRange))
+            generatedLut->SetTableRange(scalarRange);
         generatedLut->Build();
         lut = generatedLut;
     }
@@ -350,7 +344,6 @@ vtkSmartPointer<vtkPolyData> poly = rawPoly;
   std::vector<FVector> Vertices;
   std::vector<FVector> Normals;
   std::vector<FVector2D> UVs;
-  std::vector<FVector> Colors;
   std::vector<FVector> Tangents; 
 
   // 4. UVs 
@@ -360,154 +353,143 @@ vtkSmartPointer<vtkPolyData> poly = rawPoly;
   double dx = bounds[1] - bounds[0]; // xMax - xMin
   double dy = bounds[3] - bounds[2]; // yMax - yMin
 
-  // DO ALL in POINTS
-    for (vtkIdType i = 0; i < numPoints; ++i) {
-        // 4-1 Vertex
-        double p[3];
-        std::cerr << "#0 getpoint " << i << std::endl;
-        poly->GetPoint(i, p);
-        Vertices.push_back(vtkVector3<float>(p[0], p[1], p[2]));
-        std::cerr << "#1 point= " << p[0] << ", " << p[1] << ", " << p[2] << std::endl;
-
-        // 4-2 Vertex Normals
-        if (pointNormals) {
-            double n[3];
-            pointNormals->GetTuple(i, n);
-            Normals.push_back(vtkVector3<float>(n[0], n[1], n[2]));
-            std::cerr << "#2 point normal= "<< n[0] << ", " << n[1] << ", " << n[2] << std::endl;
-        } else {
-            Normals.push_back(vtkVector3<float>(0.0f,1.0f,0.0f));
-            std::cerr << "#2 point normal" << std::endl;
-        }
-
-        // 4-3 Vertex UVs
-        float u = static_cast<float>((p[0]-bounds[0])/dx);
-        float v = static_cast<float>((p[1]-bounds[2])/dy);
-        UVs.push_back(vtkVector2<float>(u,v));
-        
-        // 4-4 Vertex COLOR
-        FVector color(vtkVector3<float>(0.5,0.5,0.5));
-        if (pointScalars) {
-            double val = pointScalars->GetTuple1(i);
-            double rgb[3];
-            lut->GetColor(val, rgb);
-            color[0] = rgb[0];
-            color[1] = rgb[1];
-            color[2] = rgb[2];
-            std::cerr << "#3 point color= " 
-                << color(0) << ", "
-                << color(1) << ", "
-                << color(2) << std::endl;
-        }
-
-        Colors.push_back(color);
-
-        // 4-5 TANGENT
-        Tangents.push_back(vtkVector3<float>(1.0f, 0.0f, 0.0f)); // placeholder 
-    }
+  // cell normals and colors are flat: a point shared by cells with different
+  // ones gets a vertex per distinct value instead of the last cell's value
+  const bool useCellNormals = !pointNormals && cellNormals;
+  const bool useCellColors = !pointScalars && faceScalars.IsValid();
+  std::vector<MyComponentView> splitValues;
+  if (useCellColors) {
+      splitValues.push_back(faceScalars);
+  }
+  if (useCellNormals) {
+      for (int c = 0; c < 3; ++c) {
+          splitValues.emplace_back(cellNormals, c);
+      }
+  }
+  vtkCellArray* cells = poly->GetPolys();
+  MyStage splitStage("split vertices");
+  MySplitVerticesResult split = MySplitVertices(poly, splitValues);
+  splitStage.Stop();
+  const vtkIdType numVertices = static_cast<vtkIdType>(split.VertexPoints.size());
+  MY_TRACE(MyTraceInfo, "MyRead split vertices=%lld from points=%lld", static_cast<long long>(numVertices),
+    static_cast<long long>(numPoints));
+
+  // typed copies of the per point arrays, no GetPoint/GetTuple per point
+  MyStage extractStage("extract");
+  std::vector<FVector> pointVertices(numPoints);
+  MyExtractComponents(points->GetData(), pointVertices.data()->GetData());
+  std::vector<FVector> pointNormalValues;
+  if (pointNormals) {
+      pointNormalValues.resize(numPoints);
+      MyExtractComponents(pointNormals, pointNormalValues.data()->GetData());
+  }
+  std::vector<FVector> faceNormals;
+  if (useCellNormals) {
+      faceNormals.resize(cellNormals->GetNumberOfTuples());
+      MyExtractComponents(cellNormals, faceNormals.data()->GetData());
+  }
 
-    std::cerr << "MyReader POLY Points End !" << std::endl;
+  extractStage.Stop();
 
+  // the lookup table baked once, scalars mapped in bulk instead of GetColor per value
+  MyStage colorMapStage("color map");
+  using FColor4 = vtkVector<float,4>;
+  const MyColorMap colorMap(lut);
+  std::vector<FColor4> pointColors;
+  if (pointScalars) {
+      pointColors.resize(numPoints);
+      colorMap.Map(pointScalars, pointColors.data()->GetData(), MyColorFormat::Float4);
+  }
+  std::vector<FColor4> cellColors;
+  if (useCellColors) {
+      cellColors.resize(faceScalars.GetNumberOfValues());
+      colorMap.Map(faceScalars, cellColors.data()->GetData(), MyColorFormat::Float4);
+  }
+  colorMapStage.Stop();
+
+  // DO ALL in VERTICES, point data from the point, cell data from a cell using it.
+  // Vertices without normals or colors keep the defaults below, the gather
+  // kernel picked for the attributes present never writes them.
+  MyStage gatherStage("gather");
+  Vertices.resize(numVertices);
+  Normals.assign(numVertices, FVector(vtkVector3<float>(0.0f,1.0f,0.0f)));
+  UVs.resize(numVertices);
+  FColor4 gray(0.5f);
+  gray[3] = 1.0f;
+  std::vector<FColor4> Colors(numVertices, gray);
+
+  MyVertexSources<float, FColor4> sources;
+  sources.Points = pointVertices.data()->GetData();
+  sources.VertexPoints = split.VertexPoints.data();
+  sources.VertexCells = split.VertexCells.data();
+  sources.PointNormals = pointNormals ? pointNormalValues.data()->GetData() : nullptr;
+  sources.CellNormals = useCellNormals ? faceNormals.data()->GetData() : nullptr;
+  sources.PointColors = pointScalars ? pointColors.data() : nullptr;
+  sources.CellColors = useCellColors ? cellColors.data() : nullptr;
+  sources.PlanarUVs = true;
+  sources.UVOrigin[0] = bounds[0];
+  sources.UVOrigin[1] = bounds[2];
+  sources.UVSize[0] = dx;
+  sources.UVSize[1] = dy;
+  MyVertexTargets<float, FColor4> targets;
+  targets.Positions = Vertices.data()->GetData();
+  targets.Normals = Normals.data()->GetData();
+  targets.Colors = Colors.data();
+  targets.UVs = UVs.data()->GetData();
+  const unsigned streams = MyGetVertexStreams(sources, targets);
+  MyGatherVertices(streams, sources, targets, numVertices);
+  gatherStage.Stop();
+
+  // one summary of the vertices instead of a line per attribute per vertex
+  MY_TRACE(MyTraceInfo, "MyRead vertices=%lld normals=%s colors=%s uvs=planar", static_cast<long long>(numVertices),
+    (streams & MyVertexPointNormals) ? "point" : (streams & MyVertexCellNormals) ? "cell" : "default",
+    (streams & MyVertexPointColors) ? "point" : (streams & MyVertexCellColors) ? "cell" : "default");
+  if (MY_TRACE_ENABLED(MyTraceDebug)) {
+      vtkIdType nonUnitNormals = 0;
+      for (const FVector& normal : Normals) {
+          nonUnitNormals += std::fabs(normal.SquaredNorm() - 1.0f) > 1.e-3f;
+      }
+      FColor4 colorMin(VTK_FLOAT_MAX), colorMax(VTK_FLOAT_MIN);
+      for (const FColor4& color : Colors) {
+          for (int c = 0; c < 4; ++c) {
+              colorMin[c] = std::min(colorMin[c], color[c]);
+              colorMax[c] = std::max(colorMax[c], color[c]);
+          }
+      }
+      MY_TRACE(MyTraceDebug, "MyRead vertex bounds [%g, %g] [%g, %g] [%g, %g], non unit normals=%lld, "
+          "color range r[%g, %g] g[%g, %g] b[%g, %g]", bounds[0], bounds[1], bounds[2], bounds[3], bounds[4],
+          bounds[5], static_cast<long long>(nonUnitNormals), colorMin[0], colorMax[0], colorMin[1], colorMax[1],
+          colorMin[2], colorMax[2]);
+  }
 
     // 5. DO ALL in Cell(Face)
-    //  5-1 TRIANGLES(INDEX)
-    //  5-2 Cell NORMAL
-    //  5-3 Cell Colors triangles 
-    //  5-4 Tangent
-    // compute triangles and tangents from cell data
-    vtkCellArray* cells = poly->GetPolys();
-    vtkIdType npts;
-    const vtkIdType* ptIds;
-    vtkIdType cellId = 0;
-    std::vector<vtkIdType> Triangles;
-
-    for (cells->InitTraversal(); cells->GetNextCell(npts, ptIds);++cellId) {
-      std::cerr << "cell travel => cellid="
-      <<cellId<<", npts="<< npts << std::endl;
-        if (npts == 3) { // only triangled polys
-           // 5-1 TRIANGLES
-            std::cerr << "MyReader traverse cell "
-            << cellId << ", pts "
-            << ptIds[0] << ", "
-            << ptIds[1] << ", "
-            << ptIds[2] << std::endl;
-
-            Triangles.push_back(ptIds[0]);
-            Triangles.push_back(ptIds[1]);
-            Triangles.push_back(ptIds[2]);
-
-            // 5-2 CeLL NORMAL
-            FVector normal(vtkVector3<float>(0.0f,1.0f,0.0f));
-            if (!pointNormals && cellNormals) {
-                double n[3];
-                cellNormals->GetTuple(cellId, n);
-                // normal = FVector(n[0], n[1], n[2]);
-                normal[0] = n[0]; // x
-                normal[1] = n[1]; // y
-                normal[2] = n[2]; // z
-                Normals[ptIds[0]] = normal;
-                Normals[ptIds[1]] = normal;
-                Normals[ptIds[2]] = normal;
-                std::cerr << "#2 cell normal= "<< n[0] << ", " << n[1] << ", " << n[2] << std::endl;
-            }
-
-            // 5-3 CELL COLOR 
-            FVector color(vtkVector3<float>(0.5,0.5,0.5));
-            if (!pointScalars && cellScalars) {
-                double val = cellScalars->GetTuple1(cellId);
-                double rgb[3];
-                lut->GetColor(val, rgb);
-                color[0] = rgb[0];
-                color[1] = rgb[1];
-                color[2] = rgb[2];
-                std::cerr << "#3 cell color= " 
-                << color(0) << ", "
-                << color(1) << ", "
-                << color(2) << std::endl;
-
-                Colors[ptIds[0]] = color;
-                Colors[ptIds[1]] = color;
-                Colors[ptIds[2]] = color;
-            }
-
-            // 5-4 TANGENT
-            // Compute tangents from trpiangle edges
-            FVector& p0 = Vertices[ptIds[0]];
-            FVector& p1 = Vertices[ptIds[1]];
-            FVector& p2 = Vertices[ptIds[2]];
-
-            FVector2D& uv0 = UVs[ptIds[0]];
-            FVector2D& uv1 = UVs[ptIds[1]];
-            FVector2D& uv2 = UVs[ptIds[2]];
-
-            FVector edge1 = p1 - p0;
-            FVector edge2 = p2 - p0;
-            FVector2D deltaUV1 = uv1 - uv0;
-            FVector2D deltaUV2 = uv2 - uv0;
-
-            float df = deltaUV1(0) * deltaUV2(1) - deltaUV2(0) * deltaUV1(1);
-
-            if (abs(df) < KINDA_SMALL_NUMBER) df = 1.0f; else df = 1.0f / df;
-            // FVector tangent = df * (deltaUV2(0) * edge1 - deltaUV1(1) * edge2);
-            FVector tangent(df * (deltaUV2(0) * edge1 - deltaUV1(1) * edge2));
-            tangent.Normalize();
-
-            Tangents[ptIds[0]] = tangent;
-            Tangents[ptIds[1]] = tangent;
-            Tangents[ptIds[2]] = tangent;
-
-            std::cerr   << "MyReader tangents " << ptIds[0] << ", " 
-            << ptIds[1] << ", " 
-            << ptIds[2] << "'s tangent= " 
-            << tangent(0) << ", " 
-            << tangent(1) << ", " 
-            << tangent(2) << std::endl;
+    //  5-1 TRIANGLES(INDEX), over the split vertices
+    //  5-2 Tangent, angle weighted per vertex as MikkTSpace does
+    const std::vector<vtkIdType>& Triangles = split.Triangles;
+    const vtkIdType numTriangles = static_cast<vtkIdType>(Triangles.size() / 3);
+    MyStage tangentStage("tangents");
+    Tangents.resize(numVertices);
+    std::vector<float> TangentSigns(numVertices);
+    MyComputeTangents(Vertices.data()->GetData(), Normals.data()->GetData(), UVs.data()->GetData(), numVertices,
+        Triangles.data(), numTriangles, Tangents.data()->GetData(), TangentSigns.data());
+    tangentStage.Stop();
+
+    MY_TRACE(MyTraceInfo, "MyRead triangles=%lld from cells=%lld", static_cast<long long>(numTriangles),
+        static_cast<long long>(cells->GetNumberOfCells()));
+    if (MY_TRACE_ENABLED(MyTraceDebug)) {
+        vtkIdType degenerate = 0;
+        for (vtkIdType t = 0; t < numTriangles; ++t) {
+            const vtkIdType* ptIds = Triangles.data() + 3 * t;
+            degenerate += ptIds[0] == ptIds[1] || ptIds[1] == ptIds[2] || ptIds[2] == ptIds[0];
         }
+        const vtkIdType mirrored = std::count_if(TangentSigns.begin(), TangentSigns.end(),
+            [](float sign) { return sign < 0.0f; });
+        MY_TRACE(MyTraceDebug, "MyRead degenerate triangles=%lld, tangents=%lld mirrored=%lld",
+            static_cast<long long>(degenerate), static_cast<long long>(numVertices), static_cast<long long>(mirrored));
     }
 
-
     // Test VTK Array
-    float colorMap[8][4] = 
+    float testColors[8][4] = 
     { 
         { 0.0, 0.0, 0.0, 1.0 },
         { 0.3, 0.0, 0.0, 1.0 },
@@ -523,13 +505,12 @@ vtkSmartPointer<vtkPolyData> poly = rawPoly;
     array->SetNumberOfComponents(4);
     // array->SetNumberOfTuples(8);
     for (int i=0;i<8;i++) {
-        array->InsertNextTuple(colorMap[i]);
+        array->InsertNextTuple(testColors[i]);
     }
     int numComps = array->GetNumberOfComponents();
     int numTuples = array->GetNumberOfTuples();
      // 4 compoentns, 8 tuples , 언리얼에서는 31 compoentns, 1 tuple
-    std::cerr << "Test vtk array numComp="
-    << numComps << ", numTuple="<< numTuples << std::endl;
+    MY_TRACE(MyTraceVerbose, "Test vtk array numComp=%d, numTuple=%d", numComps, numTuples);
 
 
     return poly;
@@ -0,0 +1,168 @@
+// Load time of synthetic legacy ASCII polydata:
+// vtkPolyDataReader against the memory mapped MyReadLegacyPolyData,
+// single threaded and with the parallel chunked body parsing.
+//
+// usage: MyReadPolyDataBench [output dir] [number of points ...]
+//        defaults to 1M, 10M and 100M points in the current directory
+#include <vtkPolyDataReader.h>
+#include <vtkPolyData.h>
+#include <vtkNew.h>
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "MyVtkLegacyReader.h"
+
+namespace {
+
+class TextWriter
+{
+public:
+  explicit TextWriter(const std::string& path) : File(std::fopen(path.c_str(), "wb")) { Buffer.reserve(1 << 22); }
+  ~TextWriter() { Flush(); if (File) std::fclose(File); }
+
+  bool IsOpen() const { return File != nullptr; }
+
+  TextWriter& operator<<(const char* text)
+  {
+    Buffer.append(text);
+    return Check();
+  }
+
+  template <typename T>
+  TextWriter& operator<<(T value)
+  {
+    char number[32];
+    auto [end, ec] = std::to_chars(number, number + sizeof(number), value);
+    Buffer.append(number, end);
+    return Check();
+  }
+
+  void Flush()
+  {
+    if (File && !Buffer.empty()) std::fwrite(Buffer.data(), 1, Buffer.size(), File);
+    Buffer.clear();
+  }
+
+private:
+  TextWriter& Check()
+  {
+    if (Buffer.size() > (1 << 22) - 256) Flush();
+    return *this;
+  }
+
+  FILE* File;
+  std::string Buffer;
+};
+
+// nx * ny grid of quads with one point scalar, one cell scalar and a 2 component cell field
+bool WriteSyntheticAscii(const std::string& path, vtkIdType numPoints)
+{
+  const vtkIdType nx = static_cast<vtkIdType>(std::sqrt(static_cast<double>(numPoints)));
+  const vtkIdType ny = numPoints / nx;
+  const vtkIdType points = nx * ny;
+  const vtkIdType cells = (nx - 1) * (ny - 1);
+
+  TextWriter out(path);
+  if (!out.IsOpen()) return false;
+
+  out << "# vtk DataFile Version 2.0\nsynthetic grid\nASCII\nDATASET POLYDATA\n";
+  out << "POINTS " << points << " float\n";
+  for (vtkIdType j = 0; j < ny; ++j)
+  {
+    for (vtkIdType i = 0; i < nx; ++i)
+    {
+      float z = 0.25f * std::sin(0.01f * i) * std::cos(0.01f * j);
+      out << 0.001f * i << " " << 0.001f * j << " " << z << "\n";
+    }
+  }
+
+  out << "POLYGONS " << cells << " " << cells * 5 << "\n";
+  for (vtkIdType j = 0; j + 1 < ny; ++j)
+  {
+    for (vtkIdType i = 0; i + 1 < nx; ++i)
+    {
+      vtkIdType p0 = j * nx + i;
+      out << "4 " << p0 << " " << p0 + 1 << " " << p0 + nx + 1 << " " << p0 + nx << "\n";
+    }
+  }
+
+  out << "CELL_DATA " << cells << "\nSCALARS cell_scalars float 1\nLOOKUP_TABLE default\n";
+  for (vtkIdType c = 0; c < cells; ++c) out << static_cast<float>(c % 97) << "\n";
+  out << "FIELD FieldData 1\nfaceAttributes 2 " << cells << " float\n";
+  for (vtkIdType c = 0; c < cells; ++c) out << static_cast<float>(c % 13) << " " << 0.5f << "\n";
+
+  out << "POINT_DATA " << points << "\nSCALARS custom_table_scalars float 1\nLOOKUP_TABLE my_table\n";
+  for (vtkIdType p = 0; p < points; ++p) out << static_cast<float>(p % 1001) / 1000.0f << "\n";
+  out << "LOOKUP_TABLE my_table 2\n0.0 0.0 0.0 1.0\n1.0 1.0 1.0 1.0\n";
+  return true;
+}
+
+template <typename F>
+double Seconds(F&& run)
+{
+  auto begin = std::chrono::steady_clock::now();
+  run();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  std::filesystem::path dir = argc > 1 ? argv[1] : ".";
+  std::vector<vtkIdType> sizes;
+  for (int i = 2; i < argc; ++i) sizes.push_back(std::stoll(argv[i]));
+  if (sizes.empty()) sizes = { 1000000, 10000000, 100000000 };
+
+  std::printf("%12s %10s %14s %14s %14s %8s %8s\n", "points", "MB", "vtkReader(s)", "MyReader(s)",
+    "MyParallel(s)", "speedup", "parallel");
+  for (vtkIdType numPoints : sizes)
+  {
+    std::string path = (dir / ("bench_" + std::to_string(numPoints) + ".vtk")).string();
+    if (!WriteSyntheticAscii(path, numPoints))
+    {
+      std::cerr << "could not write " << path << std::endl;
+      return EXIT_FAILURE;
+    }
+    const double megaBytes = std::filesystem::file_size(path) / (1024.0 * 1024.0);
+
+    vtkIdType vtkCells = 0, myCells = 0, parallelCells = 0;
+    double vtkSeconds = Seconds([&] {
+      vtkNew<vtkPolyDataReader> reader;
+      reader->SetFileName(path.c_str());
+      // same amount of work as MyReadLegacyPolyData, which keeps every array
+      reader->ReadAllScalarsOn();
+      reader->ReadAllFieldsOn();
+      reader->Update();
+      vtkCells = reader->GetOutput()->GetNumberOfCells();
+    });
+
+    double mySeconds = Seconds([&] {
+      MyVtkLoadResult result;
+      if (MyReadLegacyPolyData(path.c_str(), result)) myCells = result.PolyData->GetNumberOfCells();
+    });
+
+    double parallelSeconds = Seconds([&] {
+      MyVtkLegacyReadOptions options;
+      options.Parallel = true;
+      MyVtkLoadResult result;
+      if (MyReadLegacyPolyData(path.c_str(), result, options)) parallelCells = result.PolyData->GetNumberOfCells();
+    });
+
+    if (vtkCells != myCells || myCells != parallelCells)
+    {
+      std::cerr << "cell count mismatch " << vtkCells << " " << myCells << " " << parallelCells << std::endl;
+    }
+    std::printf("%12lld %10.1f %14.3f %14.3f %14.3f %7.1fx %7.1fx\n", static_cast<long long>(numPoints), megaBytes,
+      vtkSeconds, mySeconds, parallelSeconds, vtkSeconds / mySeconds, vtkSeconds / parallelSeconds);
+    std::filesystem::remove(path);
+  }
+  return EXIT_SUCCESS;
+}
@@ -20,10 +20,8 @@
 
 #include <vtkPointData.h>
 #include <vtkCellData.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkLookupTable.h>
+#include <vtkUnsignedCharArray.h>
 
 #include <algorithm>
 #include <array>
@@ -32,6 +30,11 @@
 #include <vector>
 #include <math.h>
 
+#include "MyColorMap.h"
+#include "MyScalarRange.h"
+#include "MyTrace.h"
+#include "MyTriangulateCleanNormals.h"
+
 // 1. Not use generic poly reader but use PolyReader
 // 2. Use PolyMapper to map colors from LUT
 // 3. Don't use lookuptable when use mapper
@@ -131,7 +134,7 @@ int main(int argc, char* argv[])
 
 
 namespace {
-vtkUnsignedCharArray* MapScalarsFromPolyData(
+vtkSmartPointer<vtkUnsignedCharArray> MapScalarsFromPolyData(
     vtkPolyData* poly,
     const char* scalarName,
     bool useCellData
@@ -154,24 +157,14 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
 
   return rawPoly;
   
-  // Ensure mesh is triangulated
-  vtkNew<vtkTriangleFilter> triaf;
-  triaf->SetInputData(rawPoly);
-  triaf->Update();
-
-  vtkNew<vtkCleanPolyData> clean;
-  clean->SetInputConnection(triaf->GetOutputPort());
-  clean->Update();
-
-  vtkNew<vtkPolyDataNormals> normf;
-  normf->SetInputConnection(clean->GetOutputPort());
+  // Ensure mesh is triangulated: triangulate, clean and cell normals in one pass
+  MyTriangulateCleanNormalsOptions fusedOptions;
   // TODO: Need to determin API via checking what's the kind of normals if point_normals or cell_normals in .vtk file
-  normf->ComputePointNormalsOff(); // explicitly turn off pointnormal, if polydata has only cell_normals like cube-colortable-correct.vtk
-  normf->ComputeCellNormalsOn();
-  normf->Update();
+  fusedOptions.ComputePointNormals = false; // explicitly turn off pointnormal, if polydata has only cell_normals like cube-colortable-correct.vtk
+  fusedOptions.ComputeCellNormals = true;
 
   // final output
-  vtkSmartPointer<vtkPolyData> poly = normf->GetOutput();
+  vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(rawPoly, fusedOptions);
 
   // 1. Vertices
   vtkPoints* points = poly->GetPoints();
@@ -234,7 +227,7 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
   
   // 3. Colors
   #if USE_POLYMAPPER  // mapper map the named scalars from lookup table.
-  vtkUnsignedCharArray* mappedColorData = MapScalarsFromPolyData(poly, "custom_table_scalars", false);
+  vtkSmartPointer<vtkUnsignedCharArray> mappedColorData = MapScalarsFromPolyData(poly, "custom_table_scalars", false);
   if (mappedColorData) {
         vtkIdType numTuple = mappedColorData->GetNumberOfTuples();
         int numComp = mappedColorData->GetNumberOfComponents();
@@ -244,7 +237,6 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
             #if USE_MAPPER_AUTO_MAP_COLORS
             unsigned char colors[4];
             mappedColorData->GetTypedTuple(i,colors); // Crash!
-            std::cerr << "color= "<< colors[0] << ", " << colors[1] << ", " << colors[2] << std::endl;
             #else
                float colors[4];
                #if USE_VTK_ARRAY_AND_NO_MAPPER
@@ -253,7 +245,6 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
                    mappedColorData->GetTuple(i,colors);
                 #endif
                 
-            std::cerr << "coloXr= "<< colors[0] << ", " << colors[1] << ", " << colors[2] << std::endl;
             #endif
             // std::cerr << "color = " << colors[j] << ", ";
             // std::cerr << std::endl;
@@ -264,11 +255,9 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
     }
     #else
     vtkSmartPointer<vtkLookupTable> lut = vtkSmartPointer<vtkLookupTable>::New();
-    if (cellScalars) {
-             lut->SetTableRange(cellScalars->GetRange());
-             lut->Build();
-    } else if (pointScalars) {
-             lut->SetTableRange(pointScalars->GetRange());
+    double scalarRange[2];
+    if (MyGetScalarRange(cellScalars ? cellScalars : pointScalars, scalarRange)) {
+             lut->SetTableRange(scalarRange);
              lut->Build();
     }
     
@@ -292,20 +281,16 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
     for (vtkIdType i = 0; i < numPoints; ++i) {
         // 4-1 Vertex
         double p[3];
-        std::cerr << "#0 getpoint " << i << std::endl;
         poly->GetPoint(i, p);
         Vertices.push_back(vtkVector3<float>(p[0], p[1], p[2]));
-        std::cerr << "#1 point= " << p[0] << ", " << p[1] << ", " << p[2] << std::endl;
 
         // 4-2 Vertex Normals
         if (pointNormals) {
             double n[3];
             pointNormals->GetTuple(i, n);
             Normals.push_back(vtkVector3<float>(n[0], n[1], n[2]));
-            std::cerr << "#2 point normal= "<< n[0] << ", " << n[1] << ", " << n[2] << std::endl;
         } else {
             Normals.push_back(vtkVector3<float>(0.0f,1.0f,0.0f));
-            std::cerr << "#2 point normal" << std::endl;
         }
 
         // 4-3 Vertex UVs
@@ -334,7 +319,6 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
                     #endif
                     color = FVector(rgba[0], rgba[1], rgba[2], rgba[3]);
                 #endif
-            std::cerr <<"color= "<< color(0) << ", " << color(1) << ", " << color(2) << std::endl;
             }
         #else
         if (pointScalars) {
@@ -344,10 +328,6 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
             color[0] = rgb[0];
             color[1] = rgb[1];
             color[2] = rgb[2];
-            std::cerr << "#3 point color= " 
-                << color(0) << ", "
-                << color(1) << ", "
-                << color(2) << std::endl;
         }
 
         #endif
@@ -357,7 +337,9 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
         Tangents.push_back(vtkVector3<float>(1.0f, 0.0f, 0.0f)); // placeholder 
     }
 
-    std::cerr << "MyReader POLY Points End !" << std::endl;
+    // one summary instead of a line per point
+    MY_TRACE(MyTraceInfo, "MyRead vertices=%lld normals=%s uvs=planar", static_cast<long long>(numPoints),
+        pointNormals ? "point" : (cellNormals ? "cell" : "default"));
 
 
     // 5. DO ALL in Cell(Face)
@@ -375,11 +357,6 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
     for (cells->InitTraversal(); cells->GetNextCell(npts, ptIds);++cellId) {
         if (npts == 3) { // only triangled polys
            // 5-1 TRIANGLES
-            std::cerr << "PolyTransfer cell "
-            << cellId << ", pts "
-            << ptIds[0] << ", "
-            << ptIds[1] << ", "
-            << ptIds[2] << std::endl;
 
             Triangles.push_back(ptIds[0]);
             Triangles.push_back(ptIds[1]);
@@ -397,7 +374,6 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
                 Normals[ptIds[0]] = normal;
                 Normals[ptIds[1]] = normal;
                 Normals[ptIds[2]] = normal;
-                std::cerr << "#2 cell normal= "<< n[0] << ", " << n[1] << ", " << n[2] << std::endl;
             }
 
             // 5-3 CELL COLOR 
@@ -411,10 +387,6 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
                 color[0] = rgb[0];
                 color[1] = rgb[1];
                 color[2] = rgb[2];
-                std::cerr << "#3 cell color= " 
-                << color(0) << ", "
-                << color(1) << ", "
-                << color(2) << std::endl;
 
                 Colors[ptIds[0]] = color;
                 Colors[ptIds[1]] = color;
@@ -447,36 +419,49 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
             Tangents[ptIds[0]] = tangent;
             Tangents[ptIds[1]] = tangent;
             Tangents[ptIds[2]] = tangent;
-
-            std::cerr   << "MyReader tangents " << ptIds[0] << ", " 
-            << ptIds[1] << ", " 
-            << ptIds[2] << "'s tangent= " 
-            << tangent(0) << ", " 
-            << tangent(1) << ", " 
-            << tangent(2) << std::endl;
         }
     }
+    MY_TRACE(MyTraceInfo, "MyRead triangles=%lld from cells=%lld", static_cast<long long>(Triangles.size() / 3),
+        static_cast<long long>(cellId));
 
     return poly;
 }
 
-vtkUnsignedCharArray* MapScalarsFromPolyData(vtkPolyData* poly, const char* scalarName, bool useCellData)
+// RGBA bytes of the named point or cell scalars, the active ones when there is
+// no such array, like vtkMapper::MapScalars without a mapper: through the
+// array's own lookup table, or a default one over the array's range
+vtkSmartPointer<vtkUnsignedCharArray> MapScalarsFromPolyData(vtkPolyData* poly, const char* scalarName, bool useCellData)
 {
-    vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapper->SetInputData(poly);
-    mapper->SetScalarVisibility(true);
-    mapper->SetScalarMode(useCellData ? VTK_SCALAR_MODE_USE_CELL_DATA : VTK_SCALAR_MODE_USE_POINT_DATA);  // default is VTK_SCALAR_MODE_USE_POINT_DATA, vtk defect automatically cell data if there is not point data
-    // mapper->SetScalarModeToUsePointFieldData(); // No Effects
-    mapper->SetColorModeToMapScalars();
-    // mapper->SelectColorArray(scalarName);
-    mapper->Update();
-
-    vtkUnsignedCharArray* mappedScalars = mapper->MapScalars(1.0);
-    std::cerr << "mapper 2 >> numcomp="
-    << mappedScalars->GetNumberOfComponents() << ", numtuple="
-    << mappedScalars->GetNumberOfTuples() << std::endl;
-
-    return mapper->MapScalars(1.0);
+    vtkDataSetAttributes* data = useCellData
+        ? static_cast<vtkDataSetAttributes*>(poly->GetCellData())
+        : static_cast<vtkDataSetAttributes*>(poly->GetPointData());
+    vtkDataArray* scalars = data->GetArray(scalarName);
+    if (!scalars) {
+        scalars = data->GetScalars();
+    }
+    if (!scalars) {
+        return nullptr;
+    }
+
+    vtkSmartPointer<vtkLookupTable> lut = scalars->GetLookupTable();
+    if (!lut) {
+        double scalarRange[2];
+        if (!MyGetScalarRange(scalars, scalarRange)) {
+            return nullptr;
+        }
+        lut = vtkSmartPointer<vtkLookupTable>::New();
+        lut->SetTableRange(scalarRange);
+        lut->Build();
+    }
+
+    vtkNew<vtkUnsignedCharArray> mappedScalars;
+    mappedScalars->SetNumberOfComponents(4);
+    mappedScalars->SetNumberOfTuples(scalars->GetNumberOfTuples());
+    MyColorMap(lut).Map(scalars, mappedScalars->GetPointer(0), MyColorFormat::RGBA8);
+    MY_TRACE(MyTraceDebug, "MapScalarsFromPolyData %s numcomp=%d numtuple=%lld",
+        scalars->GetName() ? scalars->GetName() : "(unnamed)", mappedScalars->GetNumberOfComponents(),
+        static_cast<long long>(mappedScalars->GetNumberOfTuples()));
+    return mappedScalars;
 }
 
 }
\ No newline at end of file
@@ -20,9 +20,6 @@
 
 #include <vtkPointData.h>
 #include <vtkCellData.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkLookupTable.h>
 
 #include <algorithm>
@@ -32,6 +29,9 @@
 #include <vector>
 #include <math.h>
 
+#include "MyTrace.h"
+#include "MyTriangulateCleanNormals.h"
+
 
 #define KINDA_SMALL_NUMBER (1.e-4f)
 
@@ -124,24 +124,14 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
   vtkIdType numPoints = rawPoly->GetNumberOfPoints();
   std::cerr << "MyRead raw polydata points=" << numPoints << std::endl;
 
-  // Ensure mesh is triangulated
-  vtkNew<vtkTriangleFilter> triaf;
-  triaf->SetInputData(rawPoly);
-  triaf->Update();
-
-  vtkNew<vtkCleanPolyData> clean;
-  clean->SetInputConnection(triaf->GetOutputPort());
-  clean->Update();
-
-  vtkNew<vtkPolyDataNormals> normf;
-  normf->SetInputConnection(clean->GetOutputPort());
+  // Ensure mesh is triangulated: triangulate, clean and cell normals in one pass
+  MyTriangulateCleanNormalsOptions fusedOptions;
   // TODO: Need to determin API via checking what's the kind of normals if point_normals or cell_normals in .vtk file
-  normf->ComputePointNormalsOff(); // explicitly turn off pointnormal, if polydata has only cell_normals like cube-colortable-correct.vtk
-  normf->ComputeCellNormalsOn();
-  normf->Update();
+  fusedOptions.ComputePointNormals = false; // explicitly turn off pointnormal, if polydata has only cell_normals like cube-colortable-correct.vtk
+  fusedOptions.ComputeCellNormals = true;
 
   // final output
-  vtkSmartPointer<vtkPolyData> poly = normf->GetOutput();
+  vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(rawPoly, fusedOptions);
 
   // 1. Vertices
   vtkPoints* points = poly->GetPoints();
@@ -226,20 +216,16 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
     for (vtkIdType i = 0; i < numPoints; ++i) {
         // 4-1 Vertex
         double p[3];
-        std::cerr << "#0 getpoint " << i << std::endl;
         poly->GetPoint(i, p);
         Vertices.push_back(vtkVector3<float>(p[0], p[1], p[2]));
-        std::cerr << "#1 point= " << p[0] << ", " << p[1] << ", " << p[2] << std::endl;
 
         // 4-2 Vertex Normals
         if (pointNormals) {
             double n[3];
             pointNormals->GetTuple(i, n);
             Normals.push_back(vtkVector3<float>(n[0], n[1], n[2]));
-            std::cerr << "#2 point normal= "<< n[0] << ", " << n[1] << ", " << n[2] << std::endl;
         } else {
             Normals.push_back(vtkVector3<float>(0.0f,1.0f,0.0f));
-            std::cerr << "#2 point normal" << std::endl;
         }
 
         // 4-3 Vertex UVs
@@ -259,10 +245,6 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
             color[0] = r;
             color[1] = g;
             color[2] = b;
-            std::cerr << "#3 point color= " 
-                << color(0) << ", "
-                << color(1) << ", "
-                << color(2) << std::endl;
         }
 
         Colors.push_back(color);
@@ -271,7 +253,9 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
         Tangents.push_back(vtkVector3<float>(1.0f, 0.0f, 0.0f)); // placeholder 
     }
 
-    std::cerr << "MyReader POLY Points End !" << std::endl;
+    // one summary instead of a line per point
+    MY_TRACE(MyTraceInfo, "MyRead vertices=%lld normals=%s uvs=planar", static_cast<long long>(numPoints),
+        pointNormals ? "point" : (cellNormals ? "cell" : "default"));
 
 
     // 5. DO ALL in Cell(Face)
@@ -289,11 +273,6 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
     for (cells->InitTraversal(); cells->GetNextCell(npts, ptIds);++cellId) {
         if (npts == 3) { // only triangled polys
            // 5-1 TRIANGLES
-            std::cerr << "PolyTransfer cell "
-            << cellId << ", pts "
-            << ptIds[0] << ", "
-            << ptIds[1] << ", "
-            << ptIds[2] << std::endl;
 
             Triangles.push_back(ptIds[0]);
             Triangles.push_back(ptIds[1]);
@@ -311,7 +290,6 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
                 Normals[ptIds[0]] = normal;
                 Normals[ptIds[1]] = normal;
                 Normals[ptIds[2]] = normal;
-                std::cerr << "#2 cell normal= "<< n[0] << ", " << n[1] << ", " << n[2] << std::endl;
             }
 
             // 5-3 CELL COLOR 
@@ -326,10 +304,6 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
                 color[0] = r;
                 color[1] = g;
                 color[2] = b;
-                std::cerr << "#3 cell color= " 
-                << color(0) << ", "
-                << color(1) << ", "
-                << color(2) << std::endl;
 
                 Colors[ptIds[0]] = color;
                 Colors[ptIds[1]] = color;
@@ -361,15 +335,10 @@ vtkSmartPointer<vtkPolyData> MyReadPolyData(const char* fileName)
             Tangents[ptIds[0]] = tangent;
             Tangents[ptIds[1]] = tangent;
             Tangents[ptIds[2]] = tangent;
-
-            std::cerr   << "MyReader tangents " << ptIds[0] << ", " 
-            << ptIds[1] << ", " 
-            << ptIds[2] << "'s tangent= " 
-            << tangent(0) << ", " 
-            << tangent(1) << ", " 
-            << tangent(2) << std::endl;
         }
     }
+    MY_TRACE(MyTraceInfo, "MyRead triangles=%lld from cells=%lld", static_cast<long long>(Triangles.size() / 3),
+        static_cast<long long>(cellId));
 
     return poly;
 }
@@ -0,0 +1,295 @@
+#include "MyScalarRange.h"
+
+#include <vtkAOSDataArrayTemplate.h>
+#include <vtkArrayDispatch.h>
+#include <vtkDataArrayRange.h>
+#include <vtkSOADataArrayTemplate.h>
+#include <vtkWeakPointer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+
+#include "MyParallelFor.h"
+#include "MySimd.h"
+
+namespace {
+
+constexpr double Inf = std::numeric_limits<double>::infinity();
+
+// Folds values into range, skipping NaN and, when finite, infinities
+template <typename T>
+void ScalarMinMax(const T* values, vtkIdType count, vtkIdType stride, bool finite, double range[2])
+{
+  for (vtkIdType i = 0; i < count; ++i)
+  {
+    const double v = static_cast<double>(values[i * stride]);
+    if (finite ? !std::isfinite(v) : v != v) continue;
+    range[0] = std::min(range[0], v);
+    range[1] = std::max(range[1], v);
+  }
+}
+
+#if MY_SIMD_X86
+
+// min/max_ps return their second operand when either is NaN, so NaN values,
+// and infinities turned into NaN, never reach the accumulators
+MY_TARGET("avx2") void Avx2MinMax(const float* values, vtkIdType count, bool finite, double range[2])
+{
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  const __m256 inf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+  const __m256 nan = _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN());
+  __m256 lo = inf, hi = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+  vtkIdType i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 v = _mm256_loadu_ps(values + i);
+    if (finite) v = _mm256_blendv_ps(nan, v, _mm256_cmp_ps(_mm256_and_ps(v, absMask), inf, _CMP_LT_OQ));
+    lo = _mm256_min_ps(v, lo);
+    hi = _mm256_max_ps(v, hi);
+  }
+  alignas(32) float los[8], his[8];
+  _mm256_store_ps(los, lo);
+  _mm256_store_ps(his, hi);
+  for (int k = 0; k < 8; ++k)
+  {
+    range[0] = std::min<double>(range[0], los[k]);
+    range[1] = std::max<double>(range[1], his[k]);
+  }
+  ScalarMinMax(values + i, count - i, 1, finite, range);
+}
+
+MY_TARGET("avx2") void Avx2MinMax(const double* values, vtkIdType count, bool finite, double range[2])
+{
+  const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffff));
+  const __m256d inf = _mm256_set1_pd(Inf);
+  const __m256d nan = _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN());
+  __m256d lo = inf, hi = _mm256_set1_pd(-Inf);
+  vtkIdType i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m256d v = _mm256_loadu_pd(values + i);
+    if (finite) v = _mm256_blendv_pd(nan, v, _mm256_cmp_pd(_mm256_and_pd(v, absMask), inf, _CMP_LT_OQ));
+    lo = _mm256_min_pd(v, lo);
+    hi = _mm256_max_pd(v, hi);
+  }
+  alignas(32) double los[4], his[4];
+  _mm256_store_pd(los, lo);
+  _mm256_store_pd(his, hi);
+  for (int k = 0; k < 4; ++k)
+  {
+    range[0] = std::min(range[0], los[k]);
+    range[1] = std::max(range[1], his[k]);
+  }
+  ScalarMinMax(values + i, count - i, 1, finite, range);
+}
+
+#endif // MY_SIMD_X86
+
+// contiguous values of one component
+template <typename T>
+void ContiguousMinMax(const T* values, vtkIdType count, bool finite, double range[2])
+{
+#if MY_SIMD_X86
+  if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+  {
+    if (MyGetSimdLevel() >= MySimdAvx2)
+    {
+      Avx2MinMax(values, count, finite, range);
+      return;
+    }
+  }
+#endif
+  ScalarMinMax(values, count, 1, finite, range);
+}
+
+// Ranges of numComps components over count tuples: scan(begin, end, blockRanges)
+// folds tuples [begin, end) into blockRanges, one block of MyParallelGrain
+// tuples per call on all threads, and the blocks are merged into ranges
+template <typename F>
+void BlockRanges(bool parallel, vtkIdType count, int numComps, double* ranges, F&& scan)
+{
+  const vtkIdType numBlocks = (count + MyParallelGrain - 1) / MyParallelGrain;
+  std::vector<double> blockRanges(2 * numComps * numBlocks);
+  MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      double* block = &blockRanges[2 * numComps * b];
+      for (int c = 0; c < numComps; ++c)
+      {
+        block[2 * c] = Inf;
+        block[2 * c + 1] = -Inf;
+      }
+      scan(b * MyParallelGrain, std::min(count, (b + 1) * MyParallelGrain), block);
+    }
+  }, 1);
+  for (vtkIdType b = 0; b < numBlocks; ++b)
+  {
+    const double* block = &blockRanges[2 * numComps * b];
+    for (int c = 0; c < 2 * numComps; c += 2)
+    {
+      ranges[c] = std::min(ranges[c], block[c]);
+      ranges[c + 1] = std::max(ranges[c + 1], block[c + 1]);
+    }
+  }
+}
+
+struct RangeWorker
+{
+  double* Ranges;
+  bool Finite;
+  bool Parallel;
+
+  template <typename ValueT>
+  void operator()(vtkAOSDataArrayTemplate<ValueT>* array) const
+  {
+    const ValueT* values = array->GetPointer(0);
+    const int numComps = array->GetNumberOfComponents();
+    BlockRanges(this->Parallel, array->GetNumberOfTuples(), numComps, this->Ranges,
+      [&](vtkIdType begin, vtkIdType end, double* block) {
+        if (numComps == 1)
+        {
+          ContiguousMinMax(values + begin, end - begin, this->Finite, block);
+          return;
+        }
+        for (int c = 0; c < numComps; ++c)
+        {
+          ScalarMinMax(values + begin * numComps + c, end - begin, numComps, this->Finite, block + 2 * c);
+        }
+      });
+  }
+
+  template <typename ValueT>
+  void operator()(vtkSOADataArrayTemplate<ValueT>* array) const
+  {
+    const int numComps = array->GetNumberOfComponents();
+    BlockRanges(this->Parallel, array->GetNumberOfTuples(), numComps, this->Ranges,
+      [&](vtkIdType begin, vtkIdType end, double* block) {
+        for (int c = 0; c < numComps; ++c)
+        {
+          ContiguousMinMax(array->GetComponentArrayPointer(c) + begin, end - begin, this->Finite, block + 2 * c);
+        }
+      });
+  }
+
+  // any other array, through its virtual component accessors
+  template <typename ArrayT>
+  void operator()(ArrayT* array) const
+  {
+    const auto tuples = vtk::DataArrayTupleRange(array);
+    const int numComps = array->GetNumberOfComponents();
+    BlockRanges(this->Parallel, array->GetNumberOfTuples(), numComps, this->Ranges,
+      [&](vtkIdType begin, vtkIdType end, double* block) {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          const auto tuple = tuples[i];
+          for (int c = 0; c < numComps; ++c)
+          {
+            const double v = static_cast<double>(tuple[c]);
+            ScalarMinMax(&v, 1, 1, this->Finite, block + 2 * c);
+          }
+        }
+      });
+  }
+};
+
+std::vector<double> ComputeRanges(vtkDataArray* array, const MyScalarRangeOptions& options)
+{
+  const int numComps = array->GetNumberOfComponents();
+  std::vector<double> ranges(2 * numComps);
+  for (int c = 0; c < numComps; ++c)
+  {
+    ranges[2 * c] = Inf;
+    ranges[2 * c + 1] = -Inf;
+  }
+
+  RangeWorker worker{ ranges.data(), options.FiniteOnly, options.Parallel };
+  if (!vtkArrayDispatch::Dispatch::Execute(array, worker))
+  {
+    worker(array);
+  }
+
+  for (int c = 0; c < numComps; ++c)
+  {
+    if (ranges[2 * c] > ranges[2 * c + 1])
+    {
+      ranges[2 * c] = VTK_DOUBLE_MAX;
+      ranges[2 * c + 1] = VTK_DOUBLE_MIN;
+    }
+  }
+  return ranges;
+}
+
+// Ranges computed so far, keyed by array. The weak pointer tells a live array
+// from a new one allocated at the address of a deleted one.
+// Never destroyed: arrays may still be freed during static destruction.
+struct RangeCache
+{
+  struct Entry
+  {
+    vtkWeakPointer<vtkDataArray> Array;
+    vtkMTimeType MTime = 0;
+    std::vector<double> Ranges[2]; // by FiniteOnly
+  };
+
+  std::mutex Mutex;
+  std::unordered_map<vtkDataArray*, Entry> Entries;
+};
+
+RangeCache& CachedRanges()
+{
+  static auto* cache = new RangeCache;
+  return *cache;
+}
+
+} // namespace
+
+std::vector<double> MyGetComponentRanges(vtkDataArray* array, const MyScalarRangeOptions& options)
+{
+  if (!array) return {};
+
+  RangeCache& cache = CachedRanges();
+  const vtkMTimeType mtime = array->GetMTime();
+  {
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    auto it = cache.Entries.find(array);
+    if (it != cache.Entries.end() && it->second.Array == array && it->second.MTime == mtime &&
+      !it->second.Ranges[options.FiniteOnly].empty())
+    {
+      return it->second.Ranges[options.FiniteOnly];
+    }
+  }
+
+  std::vector<double> ranges = ComputeRanges(array, options);
+
+  std::lock_guard<std::mutex> lock(cache.Mutex);
+  std::erase_if(cache.Entries, [](const auto& entry) { return !entry.second.Array; });
+  RangeCache::Entry& entry = cache.Entries[array];
+  if (entry.Array != array || entry.MTime != mtime)
+  {
+    entry = RangeCache::Entry();
+    entry.Array = array;
+    entry.MTime = mtime;
+  }
+  entry.Ranges[options.FiniteOnly] = ranges;
+  return ranges;
+}
+
+bool MyGetScalarRange(vtkDataArray* array, double range[2], int component, const MyScalarRangeOptions& options)
+{
+  if (!array || component < 0 || component >= array->GetNumberOfComponents()) return false;
+
+  const std::vector<double> ranges = MyGetComponentRanges(array, options);
+  if (ranges[2 * component] > ranges[2 * component + 1]) return false;
+  range[0] = ranges[2 * component];
+  range[1] = ranges[2 * component + 1];
+  return true;
+}
+
+bool MyGetScalarRange(const MyComponentView& values, double range[2], const MyScalarRangeOptions& options)
+{
+  return MyGetScalarRange(values.GetArray(), range, values.GetComponent(), options);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vtkDataArray.h>
+
+#include <vector>
+
+#include "MyComponentView.h"
+
+struct MyScalarRangeOptions
+{
+  // skip infinities as well as NaN, what vtkDataArray::GetFiniteRange does;
+  // otherwise only NaN is skipped, like vtkDataArray::GetRange
+  bool FiniteOnly = false;
+
+  // split the scan over vtkSMPTools
+  bool Parallel = true;
+};
+
+// Shared min/max of data arrays, in place of a GetRange or a GetComponent loop
+// per converter. Every component is scanned in one pass: contiguous float and
+// double values with AVX2 when the CPU has it, blocks of values on all threads.
+// Results are cached per array and kept until the array's MTime changes, so
+// recoloring the same array again does not rescan it. Call Modified() on an
+// array after writing to its memory directly.
+//
+// Min then max of every component, GetNumberOfComponents() pairs. A component
+// with no values in range gets [VTK_DOUBLE_MAX, VTK_DOUBLE_MIN].
+std::vector<double> MyGetComponentRanges(vtkDataArray* array, const MyScalarRangeOptions& options = {});
+
+// Range of one component; false, and range left alone, when the array is null
+// or the component has no values in range
+bool MyGetScalarRange(vtkDataArray* array, double range[2], int component = 0,
+  const MyScalarRangeOptions& options = {});
+
+// Range of the component a view selects, from the cached ranges of its array
+bool MyGetScalarRange(const MyComponentView& values, double range[2], const MyScalarRangeOptions& options = {});
@@ -0,0 +1,55 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MY_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define MY_SIMD_X86 0
+#endif
+
+// GCC and Clang only emit AVX2/SSSE3 code in functions marked for it, so the
+// rest of the library keeps the baseline instruction set
+#if defined(__GNUC__) || defined(__clang__)
+#define MY_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MY_TARGET(isa)
+#endif
+
+enum MySimdLevel
+{
+  MySimdScalar = 0,
+  MySimdSsse3 = 1,
+  MySimdAvx2 = 2
+};
+
+// Best instruction set of this CPU, checked once
+inline MySimdLevel MyGetSimdLevel()
+{
+  static const MySimdLevel level = [] {
+#if MY_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return MySimdAvx2;
+    if (__builtin_cpu_supports("ssse3")) return MySimdSsse3;
+    return MySimdScalar;
+#elif MY_SIMD_X86 && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool ssse3 = (info[2] & (1 << 9)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (maxLeaf >= 7 && osxsave && (_xgetbv(0) & 6) == 6)
+    {
+      __cpuidex(info, 7, 0);
+      if (info[1] & (1 << 5)) return MySimdAvx2;
+    }
+    return ssse3 ? MySimdSsse3 : MySimdScalar;
+#else
+    return MySimdScalar;
+#endif
+  }();
+  return level;
+}
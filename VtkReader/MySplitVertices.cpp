@@ -0,0 +1,202 @@
+#include "MySplitVertices.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <numeric>
+
+#include "MyParallelFor.h"
+#include "MyTriangleIndexBuilder.h"
+
+namespace {
+
+constexpr vtkIdType Empty = -1;
+
+uint64_t Mix(uint64_t h, uint64_t v)
+{
+  h ^= v + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  return h;
+}
+
+uint64_t Bits(double x)
+{
+  x += 0.0; // -0.0 and 0.0 are the same value
+  uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+// Open addressing table of item ids, filled from all threads. Each slot stands
+// for one group of equal items and ends up holding the lowest id inserted.
+class LowestOfGroup
+{
+public:
+  explicit LowestOfGroup(vtkIdType numberOfItems)
+  {
+    size_t capacity = 16;
+    while (capacity < 2 * static_cast<size_t>(numberOfItems)) capacity *= 2;
+    this->Mask = capacity - 1;
+    this->Slots = std::vector<std::atomic<vtkIdType>>(capacity);
+    for (auto& slot : this->Slots) slot.store(Empty, std::memory_order_relaxed);
+  }
+
+  template <typename EqualT>
+  void Insert(vtkIdType item, uint64_t hash, EqualT&& equal)
+  {
+    for (size_t s = hash & this->Mask;; s = (s + 1) & this->Mask)
+    {
+      std::atomic<vtkIdType>& slot = this->Slots[s];
+      vtkIdType current = slot.load(std::memory_order_relaxed);
+      if (current == Empty && slot.compare_exchange_strong(current, item, std::memory_order_relaxed)) return;
+      // current holds an item of the slot's group, maybe lowered since
+      if (!equal(current, item)) continue;
+      while (item < current && !slot.compare_exchange_weak(current, item, std::memory_order_relaxed))
+      {
+      }
+      return;
+    }
+  }
+
+  // the lowest item equal to item, once every insert is done
+  template <typename EqualT>
+  vtkIdType Find(vtkIdType item, uint64_t hash, EqualT&& equal) const
+  {
+    for (size_t s = hash & this->Mask;; s = (s + 1) & this->Mask)
+    {
+      const vtkIdType current = this->Slots[s].load(std::memory_order_relaxed);
+      if (current == Empty) return item;
+      if (equal(current, item)) return current;
+    }
+  }
+
+private:
+  std::vector<std::atomic<vtkIdType>> Slots;
+  size_t Mask = 0;
+};
+
+// the lowest equal item of every item, from hash(i) and equal(i, j)
+template <typename HashT, typename EqualT>
+std::vector<vtkIdType> GroupItems(vtkIdType numberOfItems, bool parallel, HashT&& hash, EqualT&& equal)
+{
+  LowestOfGroup table(numberOfItems);
+  MyParallelFor(parallel, numberOfItems, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) table.Insert(i, hash(i), equal);
+  });
+  std::vector<vtkIdType> lowest(numberOfItems);
+  MyParallelFor(parallel, numberOfItems, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) lowest[i] = table.Find(i, hash(i), equal);
+  });
+  return lowest;
+}
+
+} // namespace
+
+MySplitVerticesResult MySplitVertices(vtkPolyData* poly, const std::vector<MyComponentView>& cellValues,
+  const MySplitVerticesOptions& options)
+{
+  MySplitVerticesResult result;
+  if (!poly || !poly->GetPolys()) return result;
+  const bool parallel = options.Parallel;
+
+  const MyTriangleIndexBuilder triangles(poly->GetPolys(), parallel);
+  const vtkIdType numCells = triangles.GetNumberOfCells();
+  const vtkIdType numCorners = 3 * triangles.GetNumberOfTriangles();
+  const std::vector<vtkIdType> cornerPoints = triangles.Build<vtkIdType>();
+  std::vector<vtkIdType> triangleCells(triangles.GetNumberOfTriangles());
+  MyParallelFor(parallel, numCells, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType c = begin; c < end; ++c)
+    {
+      std::fill(triangleCells.begin() + triangles.GetFirstTriangle(c),
+        triangleCells.begin() + triangles.GetFirstTriangle(c + 1), c);
+    }
+  });
+
+  // cells with bit equal values, read column by column from the views
+  const vtkIdType firstPoly = poly->GetNumberOfVerts() + poly->GetNumberOfLines();
+  std::vector<MyComponentView> views;
+  std::copy_if(cellValues.begin(), cellValues.end(), std::back_inserter(views),
+    [&](const MyComponentView& view) { return view.GetNumberOfValues() >= firstPoly + numCells; });
+  std::vector<vtkIdType> cellGroups(numCells, 0);
+  if (!views.empty())
+  {
+    const size_t numValues = views.size();
+    std::vector<uint64_t> values(numValues * numCells);
+    MyParallelFor(parallel, numCells, [&](vtkIdType begin, vtkIdType end) {
+      std::vector<double> column(end - begin);
+      for (size_t k = 0; k < numValues; ++k)
+      {
+        views[k].Load(firstPoly + begin, end - begin, column.data());
+        for (vtkIdType c = begin; c < end; ++c) values[k * numCells + c] = Bits(column[c - begin]);
+      }
+    });
+    cellGroups = GroupItems(
+      numCells, parallel,
+      [&](vtkIdType c) {
+        uint64_t h = 0;
+        for (size_t k = 0; k < numValues; ++k) h = Mix(h, values[k * numCells + c]);
+        return h;
+      },
+      [&](vtkIdType a, vtkIdType b) {
+        for (size_t k = 0; k < numValues; ++k)
+        {
+          if (values[k * numCells + a] != values[k * numCells + b]) return false;
+        }
+        return true;
+      });
+  }
+
+  // corners sharing a point and a cell group share a vertex
+  auto groupOf = [&](vtkIdType corner) { return cellGroups[triangleCells[corner / 3]]; };
+  const std::vector<vtkIdType> firstCorner = GroupItems(
+    numCorners, parallel,
+    [&](vtkIdType k) { return Mix(Mix(0, cornerPoints[k]), groupOf(k)); },
+    [&](vtkIdType a, vtkIdType b) { return cornerPoints[a] == cornerPoints[b] && groupOf(a) == groupOf(b); });
+
+  // new ids in order of the first corners: count per block, scan, fill
+  const vtkIdType numBlocks = (numCorners + MyParallelGrain - 1) / MyParallelGrain;
+  std::vector<vtkIdType> firstNewId(numBlocks + 1, 0);
+  MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      vtkIdType count = 0;
+      for (vtkIdType k = b * MyParallelGrain, last = std::min(numCorners, k + MyParallelGrain); k < last; ++k)
+      {
+        count += firstCorner[k] == k;
+      }
+      firstNewId[b + 1] = count;
+    }
+  }, 1);
+  std::partial_sum(firstNewId.begin(), firstNewId.end(), firstNewId.begin());
+  const vtkIdType numVertices = firstNewId[numBlocks];
+
+  result.Triangles.resize(numCorners);
+  result.VertexPoints.resize(numVertices);
+  result.VertexCells.resize(numVertices);
+  MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      vtkIdType newId = firstNewId[b];
+      for (vtkIdType k = b * MyParallelGrain, last = std::min(numCorners, k + MyParallelGrain); k < last; ++k)
+      {
+        if (firstCorner[k] != k) continue;
+        result.Triangles[k] = newId;
+        result.VertexPoints[newId] = cornerPoints[k];
+        result.VertexCells[newId] = firstPoly + triangleCells[k / 3];
+        ++newId;
+      }
+    }
+  }, 1);
+  // first corners precede the others of their vertex, so their ids are all set
+  MyParallelFor(parallel, numCorners, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType k = begin; k < end; ++k)
+    {
+      if (firstCorner[k] != k) result.Triangles[k] = result.Triangles[firstCorner[k]];
+    }
+  });
+  return result;
+}
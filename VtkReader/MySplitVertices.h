@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vtkPolyData.h>
+
+#include <vector>
+
+#include "MyComponentView.h"
+
+struct MySplitVerticesOptions
+{
+  // hash and number with vtkSMPTools
+  bool Parallel = true;
+};
+
+struct MySplitVerticesResult
+{
+  // fan triangulation of the polys, 3 indices per triangle into the new vertices
+  std::vector<vtkIdType> Triangles;
+
+  // per new vertex: the point it copies and the first polygon using it, as a
+  // cell data id (verts and lines come first in cell data)
+  std::vector<vtkIdType> VertexPoints;
+  std::vector<vtkIdType> VertexCells;
+};
+
+// Vertices for flat shaded cell attributes, in place of three fresh vertices
+// per triangle or one vertex per point whose attributes the last cell
+// overwrites. A point gets one vertex per distinct tuple of cellValues among
+// the polygons using it, so neighbouring cells with equal values keep sharing
+// their vertices. cellValues are compared bit for bit, one value per view;
+// views with fewer values than the polydata has cells are ignored.
+//
+// Two hash tables on all threads: one groups cells with equal values, the
+// other (point id, cell group) pairs; each keeps the lowest cell or corner of
+// a group, so new vertices are numbered in order of their first use whatever
+// the thread schedule. With no cellValues, the vertices are the used points.
+MySplitVerticesResult MySplitVertices(vtkPolyData* poly, const std::vector<MyComponentView>& cellValues,
+  const MySplitVerticesOptions& options = {});
@@ -0,0 +1,308 @@
+#include "MyStageProfile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+#include "MyTrace.h"
+
+#ifndef MY_STAGE_COUNT_ALLOCATIONS
+#define MY_STAGE_COUNT_ALLOCATIONS 0
+#endif
+
+namespace {
+
+std::atomic<int64_t> AllocatedBytes{ 0 };
+
+const std::chrono::steady_clock::time_point ProcessStart = std::chrono::steady_clock::now();
+
+int64_t WallNow()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - ProcessStart)
+    .count();
+}
+
+#ifdef _WIN32
+int64_t FileTimeNanoseconds(const FILETIME& time)
+{
+  return ((static_cast<int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 100;
+}
+#endif
+
+int64_t CpuNow()
+{
+#ifdef _WIN32
+  FILETIME creation, exit, kernel, user;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0;
+  return FileTimeNanoseconds(kernel) + FileTimeNanoseconds(user);
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+  auto nanoseconds = [](const timeval& t) { return static_cast<int64_t>(t.tv_sec) * 1000000000 + t.tv_usec * 1000; };
+  return nanoseconds(usage.ru_utime) + nanoseconds(usage.ru_stime);
+#endif
+}
+
+int64_t PeakRssNow()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+  return static_cast<int64_t>(counters.PeakWorkingSetSize);
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+  return static_cast<int64_t>(usage.ru_maxrss); // bytes
+#else
+  return static_cast<int64_t>(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+#endif
+}
+
+int64_t RssNow()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+  return static_cast<int64_t>(counters.WorkingSetSize);
+#elif defined(__APPLE__)
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+    return 0;
+  return static_cast<int64_t>(info.resident_size);
+#else
+  // second field of statm: resident pages
+  std::FILE* statm = std::fopen("/proc/self/statm", "r");
+  if (!statm) return 0;
+  long long size = 0, resident = 0;
+  const int read = std::fscanf(statm, "%lld %lld", &size, &resident);
+  std::fclose(statm);
+  return read == 2 ? resident * sysconf(_SC_PAGESIZE) : 0;
+#endif
+}
+
+unsigned ThreadId()
+{
+  static std::atomic<unsigned> next{ 0 };
+  thread_local const unsigned id = next.fetch_add(1, std::memory_order_relaxed);
+  return id;
+}
+
+thread_local int OpenStages = 0;
+
+std::mutex SamplesMutex;
+std::vector<MyStageSample> Samples;
+
+// JSON string contents; stage names are literals, but nothing stops quotes
+std::string Escape(const char* text)
+{
+  std::string escaped;
+  for (const char* c = text; *c; ++c)
+  {
+    if (*c == '"' || *c == '\\') escaped += '\\';
+    if (static_cast<unsigned char>(*c) < 0x20) continue;
+    escaped += *c;
+  }
+  return escaped;
+}
+
+// MY_PROFILE and MY_PROFILE_TRACE: enabled from the start, written at exit
+struct EnvironmentProfile
+{
+  const char* SummaryPath = std::getenv("MY_PROFILE");
+  const char* TracePath = std::getenv("MY_PROFILE_TRACE");
+
+  EnvironmentProfile()
+  {
+    if (this->SummaryPath || this->TracePath) MySetStageProfiling(true);
+  }
+
+  ~EnvironmentProfile()
+  {
+    if (this->SummaryPath && !MyWriteStageSummaryJson(this->SummaryPath))
+    {
+      std::fprintf(stderr, "MyStageProfile: cannot write %s\n", this->SummaryPath);
+    }
+    if (this->TracePath && !MyWriteStageChromeTrace(this->TracePath))
+    {
+      std::fprintf(stderr, "MyStageProfile: cannot write %s\n", this->TracePath);
+    }
+  }
+};
+
+} // namespace
+
+std::atomic<bool> MyStageProfilingEnabled{ false };
+
+namespace {
+const EnvironmentProfile Environment;
+} // namespace
+
+#if MY_STAGE_COUNT_ALLOCATIONS
+// Counting replacements of the global allocation functions: malloc and free
+// as the default ones, plus the requested size while profiling is enabled
+namespace {
+void* CountedAllocate(std::size_t size)
+{
+  if (MyStageProfilingEnabled.load(std::memory_order_relaxed))
+  {
+    AllocatedBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+  }
+  return std::malloc(size ? size : 1);
+}
+} // namespace
+
+void* operator new(std::size_t size)
+{
+  if (void* p = CountedAllocate(size)) return p;
+  throw std::bad_alloc();
+}
+void* operator new[](std::size_t size)
+{
+  if (void* p = CountedAllocate(size)) return p;
+  throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+#endif
+
+MyStage::MyStage(const char* name)
+  : Name(name)
+  , Active(MyStageProfilingEnabled.load(std::memory_order_relaxed))
+{
+  if (!this->Active) return;
+  ++OpenStages;
+  this->StartPeakRss = PeakRssNow();
+  this->StartRss = RssNow();
+  this->StartAllocated = AllocatedBytes.load(std::memory_order_relaxed);
+  this->StartCpu = CpuNow();
+  this->StartWall = WallNow();
+}
+
+void MyStage::Stop()
+{
+  if (!this->Active) return;
+  this->Active = false;
+  const int64_t wall = WallNow();
+  const int64_t cpu = CpuNow();
+  const int64_t allocated = AllocatedBytes.load(std::memory_order_relaxed);
+  const int64_t rss = RssNow();
+  const int64_t peakRss = PeakRssNow();
+  --OpenStages;
+
+  const MyStageSample sample = { this->Name, OpenStages, ThreadId(), this->StartWall, wall - this->StartWall,
+    cpu - this->StartCpu, MY_STAGE_COUNT_ALLOCATIONS ? allocated - this->StartAllocated : -1, rss - this->StartRss,
+    peakRss - this->StartPeakRss };
+  {
+    std::lock_guard<std::mutex> lock(SamplesMutex);
+    Samples.push_back(sample);
+  }
+  MY_TRACE(MyTraceDebug,
+    "stage %s wall=%.3f ms process cpu=%.3f ms c++ heap allocated=%lld rss %+lld peak rss +%lld", sample.Name,
+    sample.WallNanoseconds * 1.e-6, sample.ProcessCpuNanoseconds * 1.e-6,
+    static_cast<long long>(sample.CppHeapAllocatedBytes), static_cast<long long>(sample.RssDeltaBytes),
+    static_cast<long long>(sample.PeakRssDeltaBytes));
+}
+
+std::vector<MyStageSample> MyGetStageSamples()
+{
+  std::lock_guard<std::mutex> lock(SamplesMutex);
+  return Samples;
+}
+
+void MyResetStageSamples()
+{
+  std::lock_guard<std::mutex> lock(SamplesMutex);
+  Samples.clear();
+}
+
+bool MyWriteStageSummaryJson(const char* path)
+{
+  struct Total
+  {
+    const char* Name;
+    int Depth;
+    int64_t Count = 0, Wall = 0, Cpu = 0, Allocated = 0, Rss = 0, PeakRss = 0;
+  };
+  std::vector<Total> totals;
+  const std::vector<MyStageSample> samples = MyGetStageSamples();
+  for (const MyStageSample& sample : samples)
+  {
+    auto total = totals.begin();
+    while (total != totals.end() && std::string(total->Name) != sample.Name) ++total;
+    if (total == totals.end()) total = totals.insert(totals.end(), Total{ sample.Name, sample.Depth });
+    ++total->Count;
+    total->Wall += sample.WallNanoseconds;
+    total->Cpu += sample.ProcessCpuNanoseconds;
+    total->Allocated = sample.CppHeapAllocatedBytes < 0 ? -1 : total->Allocated + sample.CppHeapAllocatedBytes;
+    total->Rss += sample.RssDeltaBytes;
+    total->PeakRss += sample.PeakRssDeltaBytes;
+  }
+
+  std::FILE* file = std::fopen(path, "w");
+  if (!file) return false;
+  std::fprintf(file, "{\n  \"stages\": [");
+  for (size_t i = 0; i < totals.size(); ++i)
+  {
+    const Total& total = totals[i];
+    std::fprintf(file,
+      "%s\n    { \"name\": \"%s\", \"depth\": %d, \"count\": %lld, \"wall_ms\": %.3f, "
+      "\"process_cpu_ms\": %.3f, \"cpp_heap_allocated_bytes\": ",
+      i ? "," : "", Escape(total.Name).c_str(), total.Depth, static_cast<long long>(total.Count), total.Wall * 1.e-6,
+      total.Cpu * 1.e-6);
+    if (total.Allocated < 0) std::fprintf(file, "null");
+    else std::fprintf(file, "%lld", static_cast<long long>(total.Allocated));
+    std::fprintf(file, ", \"rss_delta_bytes\": %lld, \"peak_rss_delta_bytes\": %lld }",
+      static_cast<long long>(total.Rss), static_cast<long long>(total.PeakRss));
+  }
+  std::fprintf(file, "\n  ]\n}\n");
+  return std::fclose(file) == 0;
+}
+
+bool MyWriteStageChromeTrace(const char* path)
+{
+  const std::vector<MyStageSample> samples = MyGetStageSamples();
+  std::FILE* file = std::fopen(path, "w");
+  if (!file) return false;
+  std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  for (size_t i = 0; i < samples.size(); ++i)
+  {
+    const MyStageSample& sample = samples[i];
+    std::fprintf(file,
+      "%s\n{\"name\":\"%s\",\"cat\":\"stage\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+      "\"args\":{\"process_cpu_ms\":%.3f,\"cpp_heap_allocated_bytes\":",
+      i ? "," : "", Escape(sample.Name).c_str(), sample.Thread, sample.StartNanoseconds * 1.e-3,
+      sample.WallNanoseconds * 1.e-3, sample.ProcessCpuNanoseconds * 1.e-6);
+    if (sample.CppHeapAllocatedBytes < 0) std::fprintf(file, "null");
+    else std::fprintf(file, "%lld", static_cast<long long>(sample.CppHeapAllocatedBytes));
+    std::fprintf(file, ",\"rss_delta_bytes\":%lld,\"peak_rss_delta_bytes\":%lld}}",
+      static_cast<long long>(sample.RssDeltaBytes), static_cast<long long>(sample.PeakRssDeltaBytes));
+  }
+  std::fprintf(file, "\n]}\n");
+  return std::fclose(file) == 0;
+}
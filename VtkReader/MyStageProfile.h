@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// One finished stage
+struct MyStageSample
+{
+  const char* Name;         // the literal given to MY_STAGE
+  int Depth;                // stages open on the thread around this one
+  unsigned Thread;          // small id of the thread that ran the stage
+  int64_t StartNanoseconds; // since the first stage of the process
+  int64_t WallNanoseconds;
+  // user + system time of the whole process over the stage: worker threads
+  // and whatever else the process ran meanwhile, not this stage alone
+  int64_t ProcessCpuNanoseconds;
+  // requested through C++ operator new by all threads, -1 when not counted;
+  // VTK arrays allocate with malloc and are missing here, see MyStage
+  int64_t CppHeapAllocatedBytes;
+  int64_t RssDeltaBytes;     // change of the resident set size, every allocator
+  int64_t PeakRssDeltaBytes; // how far the stage raised the peak resident set size
+};
+
+// Off until enabled here or by the environment: MY_PROFILE=<file> writes the
+// JSON summary and MY_PROFILE_TRACE=<file> the Chrome trace at exit.
+extern std::atomic<bool> MyStageProfilingEnabled;
+
+inline void MySetStageProfiling(bool enabled)
+{
+  MyStageProfilingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+// Samples so far, in order of completion
+std::vector<MyStageSample> MyGetStageSamples();
+void MyResetStageSamples();
+
+// Per stage name, in order of first use: count, wall and process CPU
+// milliseconds, C++ heap bytes, RSS and peak RSS deltas summed over its
+// samples. The keys name what is measured: "process_cpu_ms",
+// "cpp_heap_allocated_bytes", "rss_delta_bytes", "peak_rss_delta_bytes".
+bool MyWriteStageSummaryJson(const char* path);
+
+// Every sample as a complete ("X") trace_event, for chrome://tracing or
+// Perfetto, with the same keys as the summary in its args
+bool MyWriteStageChromeTrace(const char* path);
+
+// Times the enclosing scope, or up to Stop(), as one stage when profiling is
+// enabled; a disabled profiler costs one relaxed load. C++ heap bytes are
+// counted only when MyStageProfile.cpp is built with
+// MY_STAGE_COUNT_ALLOCATIONS (the CMake option of that name, off by default),
+// which replaces the global operator new of the whole program, and only
+// through operator new: VTK arrays allocate with malloc and show in the RSS
+// deltas only, which every stage samples.
+class MyStage
+{
+public:
+  explicit MyStage(const char* name);
+  ~MyStage() { this->Stop(); }
+
+  // ends the stage before the scope does; later calls do nothing
+  void Stop();
+
+  MyStage(const MyStage&) = delete;
+  MyStage& operator=(const MyStage&) = delete;
+
+private:
+  const char* Name;
+  bool Active;
+  int64_t StartWall = 0;
+  int64_t StartCpu = 0;
+  int64_t StartAllocated = 0;
+  int64_t StartRss = 0;
+  int64_t StartPeakRss = 0;
+};
+
+#define MY_STAGE_JOIN2(a, b) a##b
+#define MY_STAGE_JOIN(a, b) MY_STAGE_JOIN2(a, b)
+
+// MY_STAGE("tangents"); times the rest of the scope
+#define MY_STAGE(name) MyStage MY_STAGE_JOIN(myStage, __LINE__)(name)
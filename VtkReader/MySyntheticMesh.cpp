@@ -0,0 +1,547 @@
+#include "MySyntheticMesh.h"
+#include "MyByteSwap.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Buffered file output counting its bytes; numbers as text or binary
+class Output
+{
+public:
+  explicit Output(const char* fileName)
+    : File(std::fopen(fileName, "wb"))
+  {
+    this->Buffer.resize(Capacity);
+  }
+  ~Output() { this->Close(); }
+
+  bool IsOpen() const { return this->File != nullptr; }
+  uint64_t GetBytes() const { return this->Bytes + this->Used; }
+
+  Output& operator<<(std::string_view text)
+  {
+    this->Write(text.data(), text.size());
+    return *this;
+  }
+  Output& operator<<(const char* text) { return *this << std::string_view(text); }
+  Output& operator<<(const std::string& text) { return *this << std::string_view(text); }
+
+  Output& operator<<(char c)
+  {
+    *this->Reserve(1) = c;
+    this->Used += 1;
+    return *this;
+  }
+
+  // shortest text that reads back to the same value
+  template <typename T>
+  Output& operator<<(T value)
+  {
+    char* out = this->Reserve(32);
+    auto [end, ec] = std::to_chars(out, out + 32, value);
+    this->Used += end - out;
+    return *this;
+  }
+
+  template <typename T>
+  void Raw(const T* values, size_t count)
+  {
+    this->Write(values, count * sizeof(T));
+  }
+
+  template <typename T>
+  void BigEndian(const T* values, size_t count)
+  {
+    constexpr size_t chunk = Capacity / sizeof(T);
+    for (size_t begin = 0; begin < count; begin += chunk)
+    {
+      const size_t n = std::min(chunk, count - begin);
+      MyCopyBigEndian(this->Reserve(n * sizeof(T)), values + begin, n, sizeof(T));
+      this->Used += n * sizeof(T);
+    }
+  }
+
+  bool Close()
+  {
+    if (!this->File) return false;
+    this->Flush();
+    const bool closed = std::fclose(this->File) == 0;
+    this->File = nullptr;
+    return closed && !this->Failed;
+  }
+
+private:
+  static constexpr size_t Capacity = 1 << 22;
+
+  char* Reserve(size_t bytes)
+  {
+    if (this->Used + bytes > Capacity) this->Flush();
+    return this->Buffer.data() + this->Used;
+  }
+
+  void Write(const void* data, size_t bytes)
+  {
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0)
+    {
+      const size_t n = std::min(bytes, Capacity);
+      std::memcpy(this->Reserve(n), p, n);
+      this->Used += n;
+      p += n;
+      bytes -= n;
+    }
+  }
+
+  void Flush()
+  {
+    if (this->File && this->Used && std::fwrite(this->Buffer.data(), 1, this->Used, this->File) != this->Used)
+    {
+      this->Failed = true;
+    }
+    this->Bytes += this->Used;
+    this->Used = 0;
+  }
+
+  std::FILE* File;
+  std::vector<char> Buffer;
+  size_t Used = 0;
+  uint64_t Bytes = 0;
+  bool Failed = false;
+};
+
+// splitmix64: a fixed sequence per seed on every platform
+double NextUniform(uint64_t& state)
+{
+  uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  z ^= z >> 31;
+  return static_cast<double>(z >> 11) * 0x1.0p-53;
+}
+
+// The grid squares, row by row, as cells. Every pass with the same options
+// gives the same cells.
+class CellWalker
+{
+public:
+  explicit CellWalker(const MySyntheticMeshOptions& options)
+    : NumberOfCells(std::max<vtkIdType>(options.NumberOfCells, 0))
+    , Seed(options.Seed)
+  {
+    double quads = std::max(options.QuadShare, 0.0);
+    const double triangles = std::max(options.TriangleShare, 0.0);
+    const double polygons = std::max(options.PolygonShare, 0.0);
+    if (quads + triangles + polygons <= 0.0) quads = 1.0;
+
+    // a square gives one quad or two triangles, two squares one polygon:
+    // squares are drawn so that the cells come out in the given shares
+    const double quadSquares = quads, triangleSquares = 0.5 * triangles, polygonSquares = polygons;
+    const double squares = quadSquares + triangleSquares + polygonSquares;
+    this->QuadThreshold = quadSquares / squares;
+    this->TriangleThreshold = (quadSquares + triangleSquares) / squares;
+
+    // a roughly square grid
+    const double squaresPerCell = (quads + 0.5 * triangles + 2.0 * polygons) / (quads + triangles + polygons);
+    this->Columns = std::max<vtkIdType>(
+      2, static_cast<vtkIdType>(std::ceil(std::sqrt(static_cast<double>(this->NumberOfCells) * squaresPerCell))));
+  }
+
+  vtkIdType GetPointsPerRow() const { return this->Columns + 1; }
+
+  // cell(ids, numberOfIds) per cell; returns the number of rows of squares used
+  template <typename F>
+  vtkIdType ForEach(F&& cell) const
+  {
+    uint64_t state = this->Seed;
+    const vtkIdType nx = this->GetPointsPerRow();
+    vtkIdType emitted = 0, row = 0, column = 0;
+    while (emitted < this->NumberOfCells)
+    {
+      if (column == this->Columns)
+      {
+        column = 0;
+        ++row;
+      }
+      const vtkIdType b = row * nx + column; // bottom left point of the square
+      const vtkIdType t = b + nx;            // top left
+      const double u = NextUniform(state);
+      if (u >= this->TriangleThreshold && column + 2 <= this->Columns)
+      {
+        const vtkIdType ids[6] = { b + 1, b + 2, t + 2, t + 1, t, b };
+        cell(ids, 6);
+        ++emitted;
+        column += 2;
+      }
+      else if (u >= this->QuadThreshold && u < this->TriangleThreshold)
+      {
+        const vtkIdType first[3] = { b, b + 1, t + 1 };
+        const vtkIdType second[3] = { b, t + 1, t };
+        cell(first, 3);
+        if (++emitted < this->NumberOfCells)
+        {
+          cell(second, 3);
+          ++emitted;
+        }
+        ++column;
+      }
+      else
+      {
+        // also a polygon that would not fit the row
+        const vtkIdType ids[4] = { b, b + 1, t + 1, t };
+        cell(ids, 4);
+        ++emitted;
+        ++column;
+      }
+    }
+    return this->NumberOfCells > 0 ? row + 1 : 0;
+  }
+
+private:
+  vtkIdType NumberOfCells;
+  uint64_t Seed;
+  double QuadThreshold = 1.0;
+  double TriangleThreshold = 1.0;
+  vtkIdType Columns = 2;
+};
+
+// array values, functions of the tuple so every format holds the same numbers
+float PointValue(int array, vtkIdType point, int component)
+{
+  return static_cast<float>((point + 131 * array + 17 * component) % 1001) / 1000.0f;
+}
+
+float CellValue(int array, vtkIdType cell, int component)
+{
+  return static_cast<float>((cell * (array + 1) + 7 * component) % 97);
+}
+
+float FieldValue(int array, vtkIdType tuple, int component)
+{
+  return static_cast<float>((tuple + 13 * array + component) % 13);
+}
+
+// tuples * components values of value(tuple, component): a tuple per line
+// as text, big-endian for legacy binary, host order for appended XML
+template <typename T, typename ValueF>
+void WriteValues(Output& out, MySyntheticFormat format, vtkIdType tuples, int components, ValueF&& value)
+{
+  if (format == MySyntheticFormat::LegacyAscii)
+  {
+    for (vtkIdType i = 0; i < tuples; ++i)
+    {
+      for (int c = 0; c < components; ++c)
+      {
+        if (c) out << ' ';
+        out << value(i, c);
+      }
+      out << '\n';
+    }
+    return;
+  }
+
+  constexpr vtkIdType chunkTuples = 1 << 14;
+  std::vector<T> chunk(static_cast<size_t>(chunkTuples) * components);
+  for (vtkIdType begin = 0; begin < tuples; begin += chunkTuples)
+  {
+    const vtkIdType end = std::min(tuples, begin + chunkTuples);
+    T* p = chunk.data();
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      for (int c = 0; c < components; ++c) *p++ = value(i, c);
+    }
+    const size_t count = static_cast<size_t>(p - chunk.data());
+    if (format == MySyntheticFormat::LegacyBinary) out.BigEndian(chunk.data(), count);
+    else out.Raw(chunk.data(), count);
+  }
+}
+
+// height field over the grid, as in the other benchmarks
+template <typename PointF>
+void ForEachPoint(vtkIdType nx, vtkIdType numPoints, PointF&& point)
+{
+  std::vector<float> waveX(nx);
+  for (vtkIdType i = 0; i < nx; ++i) waveX[i] = 0.25f * std::sin(0.01f * static_cast<float>(i));
+  for (vtkIdType p = 0; p < numPoints; ++p)
+  {
+    const vtkIdType i = p % nx, j = p / nx;
+    point(0.001f * static_cast<float>(i), 0.001f * static_cast<float>(j),
+      waveX[i] * std::cos(0.01f * static_cast<float>(j)));
+  }
+}
+
+void WritePoints(Output& out, MySyntheticFormat format, vtkIdType nx, vtkIdType numPoints)
+{
+  if (format == MySyntheticFormat::LegacyAscii)
+  {
+    ForEachPoint(nx, numPoints, [&](float x, float y, float z) { out << x << ' ' << y << ' ' << z << '\n'; });
+    return;
+  }
+
+  std::vector<float> chunk;
+  chunk.reserve(3 << 14);
+  auto flush = [&] {
+    if (format == MySyntheticFormat::LegacyBinary) out.BigEndian(chunk.data(), chunk.size());
+    else out.Raw(chunk.data(), chunk.size());
+    chunk.clear();
+  };
+  ForEachPoint(nx, numPoints, [&](float x, float y, float z) {
+    chunk.insert(chunk.end(), { x, y, z });
+    if (chunk.size() == chunk.capacity()) flush();
+  });
+  flush();
+}
+
+// name components tuples float, then the values, per array of a FIELD block
+template <typename ValueF>
+void WriteLegacyField(Output& out, MySyntheticFormat format, const char* prefix, int first, int count, int components,
+  vtkIdType tuples, ValueF&& value)
+{
+  if (count <= 0) return;
+  out << "FIELD FieldData " << count << '\n';
+  for (int a = first; a < first + count; ++a)
+  {
+    out << prefix << a << ' ' << components << ' ' << tuples << " float\n";
+    WriteValues<float>(out, format, tuples, components, [&](vtkIdType i, int c) { return value(a, i, c); });
+    if (format == MySyntheticFormat::LegacyBinary) out << '\n';
+  }
+}
+
+// SCALARS for the first array, a FIELD block for the others
+template <typename ValueF>
+void WriteLegacyAttributes(Output& out, MySyntheticFormat format, const char* section, const char* prefix, int arrays,
+  int components, vtkIdType tuples, ValueF&& value)
+{
+  if (arrays <= 0) return;
+  out << section << ' ' << tuples << '\n';
+  out << "SCALARS " << prefix << 0 << " float " << components << "\nLOOKUP_TABLE default\n";
+  WriteValues<float>(out, format, tuples, components, [&](vtkIdType i, int c) { return value(0, i, c); });
+  if (format == MySyntheticFormat::LegacyBinary) out << '\n';
+  WriteLegacyField(out, format, prefix, 1, arrays - 1, components, tuples, value);
+}
+
+void WriteLegacy(Output& out, MySyntheticFormat format, const MySyntheticMeshOptions& options, const CellWalker& walker,
+  const MySyntheticMeshInfo& info, vtkIdType fieldTuples, int components)
+{
+  const bool binary = format == MySyntheticFormat::LegacyBinary;
+  out << "# vtk DataFile Version 3.0\nsynthetic mesh\n" << (binary ? "BINARY" : "ASCII") << "\nDATASET POLYDATA\n";
+  WriteLegacyField(out, format, "field_", 0, options.FieldArrays, components, fieldTuples, FieldValue);
+
+  out << "POINTS " << info.NumberOfPoints << " float\n";
+  WritePoints(out, format, walker.GetPointsPerRow(), info.NumberOfPoints);
+  if (binary) out << '\n';
+
+  // classic layout: the point count of every cell, then its ids
+  out << "POLYGONS " << info.NumberOfCells << ' ' << info.NumberOfCells + info.ConnectivitySize << '\n';
+  if (binary)
+  {
+    std::vector<int32_t> chunk;
+    chunk.reserve(1 << 16);
+    walker.ForEach([&](const vtkIdType* ids, int n) {
+      chunk.push_back(n);
+      for (int k = 0; k < n; ++k) chunk.push_back(static_cast<int32_t>(ids[k]));
+      if (chunk.size() + 8 > chunk.capacity())
+      {
+        out.BigEndian(chunk.data(), chunk.size());
+        chunk.clear();
+      }
+    });
+    out.BigEndian(chunk.data(), chunk.size());
+    out << '\n';
+  }
+  else
+  {
+    walker.ForEach([&](const vtkIdType* ids, int n) {
+      out << n;
+      for (int k = 0; k < n; ++k) out << ' ' << ids[k];
+      out << '\n';
+    });
+  }
+
+  WriteLegacyAttributes(
+    out, format, "CELL_DATA", "cell_", options.CellArrays, components, info.NumberOfCells, CellValue);
+  WriteLegacyAttributes(
+    out, format, "POINT_DATA", "point_", options.PointArrays, components, info.NumberOfPoints, PointValue);
+}
+
+// <DataArray .../> of one appended array, with its tuple count in FieldData;
+// offset moves past its header and bytes
+void WriteXmlArray(Output& out, const char* type, const std::string& name, int components, vtkIdType tuples,
+  uint64_t bytes, uint64_t& offset, bool fieldData = false)
+{
+  out << (fieldData ? "      " : "        ") << "<DataArray type=\"" << type << '"';
+  if (!name.empty()) out << " Name=\"" << name << '"';
+  out << " NumberOfComponents=\"" << components << '"';
+  if (fieldData) out << " NumberOfTuples=\"" << tuples << '"';
+  out << " format=\"appended\" offset=\"" << offset << "\"/>\n";
+  offset += sizeof(uint64_t) + bytes;
+}
+
+template <typename T, typename ValueF>
+void WriteAppended(Output& out, vtkIdType tuples, int components, ValueF&& value)
+{
+  const uint64_t bytes = static_cast<uint64_t>(tuples) * components * sizeof(T);
+  out.Raw(&bytes, 1);
+  WriteValues<T>(out, MySyntheticFormat::XmlAppended, tuples, components, value);
+}
+
+void WriteXml(Output& out, const MySyntheticMeshOptions& options, const CellWalker& walker,
+  const MySyntheticMeshInfo& info, vtkIdType fieldTuples, int components)
+{
+  const vtkIdType numPoints = info.NumberOfPoints, numCells = info.NumberOfCells;
+  const uint64_t valueBytes = sizeof(float) * components;
+
+  // appended data in the order of the DataArray elements
+  uint64_t offset = 0;
+  out << "<?xml version=\"1.0\"?>\n<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\""
+      << (std::endian::native == std::endian::little ? "LittleEndian" : "BigEndian")
+      << "\" header_type=\"UInt64\">\n  <PolyData>\n";
+  if (options.FieldArrays > 0)
+  {
+    out << "    <FieldData>\n";
+    for (int a = 0; a < options.FieldArrays; ++a)
+    {
+      WriteXmlArray(out, "Float32", "field_" + std::to_string(a), components, fieldTuples, valueBytes * fieldTuples,
+        offset, true);
+    }
+    out << "    </FieldData>\n";
+  }
+  out << "    <Piece NumberOfPoints=\"" << numPoints
+      << "\" NumberOfVerts=\"0\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"" << numCells << "\">\n";
+
+  out << "      <PointData" << (options.PointArrays > 0 ? " Scalars=\"point_0\"" : "") << ">\n";
+  for (int a = 0; a < options.PointArrays; ++a)
+  {
+    WriteXmlArray(out, "Float32", "point_" + std::to_string(a), components, numPoints, valueBytes * numPoints, offset);
+  }
+  out << "      </PointData>\n";
+  out << "      <CellData" << (options.CellArrays > 0 ? " Scalars=\"cell_0\"" : "") << ">\n";
+  for (int a = 0; a < options.CellArrays; ++a)
+  {
+    WriteXmlArray(out, "Float32", "cell_" + std::to_string(a), components, numCells, valueBytes * numCells, offset);
+  }
+  out << "      </CellData>\n      <Points>\n";
+  WriteXmlArray(out, "Float32", "Points", 3, numPoints, 3 * sizeof(float) * numPoints, offset);
+  out << "      </Points>\n      <Polys>\n";
+  WriteXmlArray(out, "Int64", "connectivity", 1, info.ConnectivitySize, sizeof(int64_t) * info.ConnectivitySize,
+    offset);
+  WriteXmlArray(out, "Int64", "offsets", 1, numCells, sizeof(int64_t) * numCells, offset);
+  out << "      </Polys>\n    </Piece>\n  </PolyData>\n  <AppendedData encoding=\"raw\">\n   _";
+
+  for (int a = 0; a < options.FieldArrays; ++a)
+  {
+    WriteAppended<float>(out, fieldTuples, components, [&](vtkIdType i, int c) { return FieldValue(a, i, c); });
+  }
+  for (int a = 0; a < options.PointArrays; ++a)
+  {
+    WriteAppended<float>(out, numPoints, components, [&](vtkIdType i, int c) { return PointValue(a, i, c); });
+  }
+  for (int a = 0; a < options.CellArrays; ++a)
+  {
+    WriteAppended<float>(out, numCells, components, [&](vtkIdType i, int c) { return CellValue(a, i, c); });
+  }
+
+  uint64_t bytes = 3 * sizeof(float) * static_cast<uint64_t>(numPoints);
+  out.Raw(&bytes, 1);
+  WritePoints(out, MySyntheticFormat::XmlAppended, walker.GetPointsPerRow(), numPoints);
+
+  std::vector<int64_t> chunk;
+  chunk.reserve(1 << 16);
+  auto flush = [&] {
+    out.Raw(chunk.data(), chunk.size());
+    chunk.clear();
+  };
+  bytes = sizeof(int64_t) * static_cast<uint64_t>(info.ConnectivitySize);
+  out.Raw(&bytes, 1);
+  walker.ForEach([&](const vtkIdType* ids, int n) {
+    chunk.insert(chunk.end(), ids, ids + n);
+    if (chunk.size() + 8 > chunk.capacity()) flush();
+  });
+  flush();
+
+  bytes = sizeof(int64_t) * static_cast<uint64_t>(numCells);
+  out.Raw(&bytes, 1);
+  int64_t end = 0;
+  walker.ForEach([&](const vtkIdType*, int n) {
+    chunk.push_back(end += n);
+    if (chunk.size() == chunk.capacity()) flush();
+  });
+  flush();
+
+  out << "\n  </AppendedData>\n</VTKFile>\n";
+}
+
+} // namespace
+
+const char* MySyntheticExtension(MySyntheticFormat format)
+{
+  return format == MySyntheticFormat::XmlAppended ? ".vtp" : ".vtk";
+}
+
+const char* MySyntheticFormatName(MySyntheticFormat format)
+{
+  switch (format)
+  {
+    case MySyntheticFormat::LegacyAscii: return "ascii";
+    case MySyntheticFormat::LegacyBinary: return "binary";
+    case MySyntheticFormat::XmlAppended: return "vtp";
+  }
+  return "";
+}
+
+bool MyWriteSyntheticMesh(const char* fileName, MySyntheticFormat format, const MySyntheticMeshOptions& options,
+  MySyntheticMeshInfo* info)
+{
+  const CellWalker walker(options);
+  const int components = std::clamp(options.Components, 1, 4);
+  MySyntheticMeshOptions clamped = options;
+  clamped.PointArrays = std::max(options.PointArrays, 0);
+  clamped.CellArrays = std::max(options.CellArrays, 0);
+  clamped.FieldArrays = std::max(options.FieldArrays, 0);
+
+  // a counting pass: the headers come before the cells
+  MySyntheticMeshInfo mesh;
+  const vtkIdType rows = walker.ForEach([&](const vtkIdType*, int n) {
+    ++mesh.NumberOfCells;
+    mesh.ConnectivitySize += n;
+    mesh.NumberOfTriangles += n == 3;
+    mesh.NumberOfQuads += n == 4;
+    mesh.NumberOfPolygons += n > 4;
+  });
+  mesh.NumberOfPoints = rows > 0 ? walker.GetPointsPerRow() * (rows + 1) : 0;
+  const vtkIdType fieldTuples = options.FieldTuples > 0 ? options.FieldTuples : mesh.NumberOfCells;
+
+  if (format != MySyntheticFormat::XmlAppended &&
+      std::max(mesh.NumberOfPoints, mesh.NumberOfCells + mesh.ConnectivitySize) > std::numeric_limits<int32_t>::max())
+  {
+    std::cerr << "MySyntheticMesh: too large for 32-bit legacy cells: " << fileName << std::endl;
+    return false;
+  }
+
+  Output out(fileName);
+  if (!out.IsOpen())
+  {
+    std::cerr << "MySyntheticMesh: cannot write " << fileName << std::endl;
+    return false;
+  }
+  if (format == MySyntheticFormat::XmlAppended) WriteXml(out, clamped, walker, mesh, fieldTuples, components);
+  else WriteLegacy(out, format, clamped, walker, mesh, fieldTuples, components);
+  mesh.FileBytes = out.GetBytes();
+  if (!out.Close())
+  {
+    std::cerr << "MySyntheticMesh: cannot write " << fileName << std::endl;
+    return false;
+  }
+  if (info) *info = mesh;
+  return true;
+}
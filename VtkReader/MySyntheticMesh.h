@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vtkType.h>
+
+// File layouts MyWriteSyntheticMesh can produce, all read by MyVtkIO
+enum class MySyntheticFormat
+{
+  LegacyAscii,  // "# vtk DataFile Version 3.0", classic "npts id0 id1 ..." cells
+  LegacyBinary, // same sections, big-endian bodies
+  XmlAppended,  // .vtp, one piece, raw <AppendedData> in host byte order
+};
+
+// ".vtk" or ".vtp"
+const char* MySyntheticExtension(MySyntheticFormat format);
+
+// "ascii", "binary" or "vtp"
+const char* MySyntheticFormatName(MySyntheticFormat format);
+
+struct MySyntheticMeshOptions
+{
+  // exact number of polys written
+  vtkIdType NumberOfCells = 1000000;
+
+  // Shares of quads, triangles and polygons among the cells; they need not sum
+  // to 1. A polygon is the hexagon around two neighbouring grid squares,
+  // listed from its bottom middle point so no fan triangle is degenerate.
+  double QuadShare = 1.0;
+  double TriangleShare = 0.0;
+  double PolygonShare = 0.0;
+
+  // float arrays "point_<i>", "cell_<i>" and "field_<i>". The first point and
+  // cell arrays are the active scalars, the rest are plain arrays. Field
+  // arrays belong to the dataset and have FieldTuples tuples, one per cell when 0.
+  int PointArrays = 1;
+  int CellArrays = 1;
+  int FieldArrays = 0;
+  int Components = 1; // 1 to 4, every array
+  vtkIdType FieldTuples = 0;
+
+  // picks the cell kind of every grid square; same seed, same file
+  uint64_t Seed = 1;
+};
+
+// What a written file holds
+struct MySyntheticMeshInfo
+{
+  vtkIdType NumberOfPoints = 0;
+  vtkIdType NumberOfCells = 0;
+  vtkIdType NumberOfQuads = 0;
+  vtkIdType NumberOfTriangles = 0;
+  vtkIdType NumberOfPolygons = 0;
+  vtkIdType ConnectivitySize = 0; // point ids over all cells
+  uint64_t FileBytes = 0;
+};
+
+// Procedural polydata of any size for benchmarks, in place of the 8 point
+// cubes in data/. Points are a height field over a grid of nx columns, just
+// enough rows for the cells; walking the grid row by row, every square becomes
+// a quad or two triangles, or joins the next square into a polygon, chosen
+// pseudo-randomly by the shares. Points and cells are streamed to the file
+// through a buffer, so the whole mesh is never held in memory. Array values
+// are functions of the point or cell id.
+//
+// Returns false when the file cannot be written or the mesh does not fit the
+// classic 32-bit legacy cell layout.
+bool MyWriteSyntheticMesh(const char* fileName, MySyntheticFormat format, const MySyntheticMeshOptions& options,
+  MySyntheticMeshInfo* info = nullptr);
@@ -0,0 +1,161 @@
+#include "MyTangents.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include "MyParallelFor.h"
+
+namespace {
+
+struct Vec3
+{
+  double X, Y, Z;
+};
+
+Vec3 Sub(const Vec3& a, const Vec3& b) { return { a.X - b.X, a.Y - b.Y, a.Z - b.Z }; }
+Vec3 Scale(double s, const Vec3& a) { return { s * a.X, s * a.Y, s * a.Z }; }
+double Dot(const Vec3& a, const Vec3& b) { return a.X * b.X + a.Y * b.Y + a.Z * b.Z; }
+Vec3 Cross(const Vec3& a, const Vec3& b)
+{
+  return { a.Y * b.Z - a.Z * b.Y, a.Z * b.X - a.X * b.Z, a.X * b.Y - a.Y * b.X };
+}
+
+// MikkTSpace's NotZero
+bool NotZero(double x) { return std::fabs(x) > 1.e-20; }
+
+// a unit, or left alone when it is too short to normalize
+Vec3 Normalize(const Vec3& a)
+{
+  const double length = std::sqrt(Dot(a, a));
+  return NotZero(length) ? Scale(1.0 / length, a) : a;
+}
+
+// a without its component along unit n
+Vec3 Project(const Vec3& n, const Vec3& a) { return Sub(a, Scale(Dot(n, a), n)); }
+
+template <typename T>
+Vec3 Load3(const T* values, vtkIdType i)
+{
+  return { double(values[3 * i]), double(values[3 * i + 1]), double(values[3 * i + 2]) };
+}
+
+// Directions of increasing u and v over one triangle, normalized and turned
+// by the orientation of its uvs, as MikkTSpace's InitTriInfo
+template <typename T>
+void TriangleFrame(const T* positions, const T* uvs, const vtkIdType ids[3], Vec3& os, Vec3& ot)
+{
+  const Vec3 p1 = Load3(positions, ids[0]);
+  const Vec3 d1 = Sub(Load3(positions, ids[1]), p1);
+  const Vec3 d2 = Sub(Load3(positions, ids[2]), p1);
+  const double t21x = double(uvs[2 * ids[1]]) - double(uvs[2 * ids[0]]);
+  const double t21y = double(uvs[2 * ids[1] + 1]) - double(uvs[2 * ids[0] + 1]);
+  const double t31x = double(uvs[2 * ids[2]]) - double(uvs[2 * ids[0]]);
+  const double t31y = double(uvs[2 * ids[2] + 1]) - double(uvs[2 * ids[0] + 1]);
+
+  const double signedArea = t21x * t31y - t21y * t31x;
+  os = Sub(Scale(t31y, d1), Scale(t21y, d2));
+  ot = Sub(Scale(t21x, d2), Scale(t31x, d1));
+  if (!NotZero(signedArea))
+  {
+    // no uv area, nothing to orient
+    os = ot = { 0.0, 0.0, 0.0 };
+    return;
+  }
+  const double orientation = signedArea > 0.0 ? 1.0 : -1.0;
+  const double lengthS = std::sqrt(Dot(os, os)), lengthT = std::sqrt(Dot(ot, ot));
+  if (NotZero(lengthS)) os = Scale(orientation / lengthS, os);
+  if (NotZero(lengthT)) ot = Scale(orientation / lengthT, ot);
+}
+
+// some unit vector perpendicular to unit n
+Vec3 AnyPerpendicular(const Vec3& n)
+{
+  const Vec3 axis = std::fabs(n.X) <= std::fabs(n.Y) && std::fabs(n.X) <= std::fabs(n.Z) ? Vec3{ 1.0, 0.0, 0.0 } :
+    std::fabs(n.Y) <= std::fabs(n.Z) ? Vec3{ 0.0, 1.0, 0.0 } : Vec3{ 0.0, 0.0, 1.0 };
+  return Normalize(Project(n, axis));
+}
+
+} // namespace
+
+template <typename T, typename IndexT>
+void MyComputeTangents(const T* positions, const T* normals, const T* uvs, vtkIdType numVertices,
+  const IndexT* triangles, vtkIdType numTriangles, T* tangents, float* signs, const MyTangentOptions& options)
+{
+  const bool parallel = options.Parallel;
+  const vtkIdType numCorners = 3 * numTriangles;
+
+  // 1. u and v directions of every triangle
+  std::vector<Vec3> frames(2 * numTriangles);
+  MyParallelFor(parallel, numTriangles, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType t = begin; t < end; ++t)
+    {
+      const vtkIdType ids[3] = { vtkIdType(triangles[3 * t]), vtkIdType(triangles[3 * t + 1]),
+        vtkIdType(triangles[3 * t + 2]) };
+      TriangleFrame(positions, uvs, ids, frames[2 * t], frames[2 * t + 1]);
+    }
+  });
+
+  // 2. vertex -> corners, filled concurrently and sorted back into corner order
+  std::vector<std::atomic<vtkIdType>> fill(numVertices + 1);
+  MyParallelFor(parallel, numCorners, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) fill[vtkIdType(triangles[i]) + 1].fetch_add(1, std::memory_order_relaxed);
+  });
+  std::vector<vtkIdType> firstLink(numVertices + 1, 0);
+  for (vtkIdType v = 0; v < numVertices; ++v)
+  {
+    firstLink[v + 1] = firstLink[v] + fill[v + 1].load(std::memory_order_relaxed);
+    fill[v].store(firstLink[v], std::memory_order_relaxed);
+  }
+  std::vector<vtkIdType> links(numCorners);
+  MyParallelFor(parallel, numCorners, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      links[fill[vtkIdType(triangles[i])].fetch_add(1, std::memory_order_relaxed)] = i;
+    }
+  });
+
+  // 3. angle weighted sums in the tangent plane of every vertex, then the
+  // tangent and the handedness of the summed v directions
+  MyParallelFor(parallel, numVertices, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType v = begin; v < end; ++v)
+    {
+      std::sort(links.begin() + firstLink[v], links.begin() + firstLink[v + 1]);
+      const Vec3 n = Load3(normals, v);
+      const Vec3 p = Load3(positions, v);
+      Vec3 sumS = { 0.0, 0.0, 0.0 }, sumT = { 0.0, 0.0, 0.0 };
+      for (vtkIdType l = firstLink[v]; l < firstLink[v + 1]; ++l)
+      {
+        const vtkIdType corner = links[l], t = corner / 3, k = corner % 3;
+        const Vec3 os = Normalize(Project(n, frames[2 * t]));
+        const Vec3 ot = Normalize(Project(n, frames[2 * t + 1]));
+
+        // angle between the two edges leaving this corner, in the tangent plane
+        const Vec3 e1 = Normalize(Project(n, Sub(Load3(positions, vtkIdType(triangles[3 * t + (k + 2) % 3])), p)));
+        const Vec3 e2 = Normalize(Project(n, Sub(Load3(positions, vtkIdType(triangles[3 * t + (k + 1) % 3])), p)));
+        const double angle = std::acos(std::clamp(Dot(e1, e2), -1.0, 1.0));
+
+        sumS = { sumS.X + angle * os.X, sumS.Y + angle * os.Y, sumS.Z + angle * os.Z };
+        sumT = { sumT.X + angle * ot.X, sumT.Y + angle * ot.Y, sumT.Z + angle * ot.Z };
+      }
+
+      Vec3 tangent = Project(n, sumS);
+      const double length = std::sqrt(Dot(tangent, tangent));
+      tangent = NotZero(length) ? Scale(1.0 / length, tangent) : AnyPerpendicular(n);
+      tangents[3 * v] = static_cast<T>(tangent.X);
+      tangents[3 * v + 1] = static_cast<T>(tangent.Y);
+      tangents[3 * v + 2] = static_cast<T>(tangent.Z);
+      signs[v] = Dot(Cross(n, tangent), sumT) < 0.0 ? -1.0f : 1.0f;
+    }
+  });
+}
+
+template void MyComputeTangents<float, int32_t>(const float*, const float*, const float*, vtkIdType, const int32_t*,
+  vtkIdType, float*, float*, const MyTangentOptions&);
+template void MyComputeTangents<float, vtkIdType>(const float*, const float*, const float*, vtkIdType,
+  const vtkIdType*, vtkIdType, float*, float*, const MyTangentOptions&);
+template void MyComputeTangents<double, int32_t>(const double*, const double*, const double*, vtkIdType,
+  const int32_t*, vtkIdType, double*, float*, const MyTangentOptions&);
+template void MyComputeTangents<double, vtkIdType>(const double*, const double*, const double*, vtkIdType,
+  const vtkIdType*, vtkIdType, double*, float*, const MyTangentOptions&);
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vtkType.h>
+
+#include <cstdint>
+
+struct MyTangentOptions
+{
+  // per-triangle and per-vertex passes with vtkSMPTools
+  bool Parallel = true;
+};
+
+// Per-vertex tangent frames the way MikkTSpace builds them, in place of one
+// tangent per triangle overwriting the tangents of its corners. Every triangle
+// gets the directions of increasing u and v from its positions and uvs; at
+// every corner they are projected onto the plane of the vertex normal and
+// weighted by the corner angle, then summed per vertex. The tangent is the
+// normalized sum of the u directions and the sign tells which way the summed v
+// directions point: bitangent = sign * cross(normal, tangent), so
+// FProcMeshTangent(tangent, sign < 0) and UE's CalculateTangentsForMesh need
+// not run again.
+//
+// Vertices are not split. Where MikkTSpace would split a vertex whose
+// triangles disagree on handedness, the angle weighted majority wins.
+// Triangles touching a vertex are summed in triangle order, so the result does
+// not depend on the thread schedule. A vertex with no usable uvs gets some
+// tangent perpendicular to its normal and sign +1.
+//
+// positions and normals hold 3 values, uvs 2 values per vertex; normals are
+// expected to be unit length. tangents receives 3 values and signs 1 per vertex.
+// Built for float and double values with int32_t or vtkIdType indices.
+template <typename T, typename IndexT>
+void MyComputeTangents(const T* positions, const T* normals, const T* uvs, vtkIdType numVertices,
+  const IndexT* triangles, vtkIdType numTriangles, T* tangents, float* signs, const MyTangentOptions& options = {});
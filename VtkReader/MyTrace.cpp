@@ -0,0 +1,214 @@
+#include "MyTrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t RingRecords = 1024; // power of two
+constexpr std::chrono::milliseconds FlushInterval(20);
+
+int InitialLevel()
+{
+  const char* level = std::getenv("MY_TRACE");
+  return level ? std::clamp(std::atoi(level), int(MyTraceOff), int(MyTraceVerbose)) : int(MyTraceInfo);
+}
+
+struct Record
+{
+  int64_t Nanoseconds;
+  int Level;
+  char Text[244];
+};
+
+// Single producer, single consumer: the owning thread moves Head, the
+// flusher moves Tail, each publishing its records with release
+struct Ring
+{
+  Record Records[RingRecords];
+  std::atomic<uint64_t> Head{ 0 };
+  std::atomic<uint64_t> Tail{ 0 };
+  std::atomic<uint64_t> Dropped{ 0 };
+  std::atomic<bool> Finished{ false };
+  unsigned Thread = 0;
+};
+
+class Tracer
+{
+public:
+  ~Tracer()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->WakeMutex);
+      this->Stop = true;
+    }
+    this->Wake.notify_one();
+    if (this->Flusher.joinable()) this->Flusher.join();
+    this->Drain();
+  }
+
+  std::shared_ptr<Ring> Register()
+  {
+    auto ring = std::make_shared<Ring>();
+    std::lock_guard<std::mutex> lock(this->RingsMutex);
+    ring->Thread = this->NextThread++;
+    this->Rings.push_back(ring);
+    if (!this->Flusher.joinable()) this->Flusher = std::thread([this] { this->Run(); });
+    return ring;
+  }
+
+  void WakeFlusher() { this->Wake.notify_one(); }
+
+  void SetSink(std::FILE* sink)
+  {
+    std::lock_guard<std::mutex> lock(this->DrainMutex);
+    this->Sink = sink;
+  }
+
+  int64_t Now() const
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->Start)
+      .count();
+  }
+
+  // everything published so far, all threads merged by time
+  void Drain()
+  {
+    std::lock_guard<std::mutex> drainLock(this->DrainMutex);
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+      std::lock_guard<std::mutex> lock(this->RingsMutex);
+      rings = this->Rings;
+    }
+
+    struct Pending
+    {
+      const Record* Line;
+      unsigned Thread;
+    };
+    std::vector<Pending> pending;
+    std::vector<uint64_t> heads(rings.size());
+    for (size_t r = 0; r < rings.size(); ++r)
+    {
+      Ring& ring = *rings[r];
+      const uint64_t tail = ring.Tail.load(std::memory_order_relaxed);
+      heads[r] = ring.Head.load(std::memory_order_acquire);
+      for (uint64_t i = tail; i < heads[r]; ++i) pending.push_back({ &ring.Records[i & (RingRecords - 1)], ring.Thread });
+    }
+    std::stable_sort(pending.begin(), pending.end(),
+      [](const Pending& a, const Pending& b) { return a.Line->Nanoseconds < b.Line->Nanoseconds; });
+
+    static const char levelNames[] = "-EIDV";
+    std::FILE* sink = this->Sink ? this->Sink : stderr;
+    for (const Pending& p : pending)
+    {
+      std::fprintf(sink, "[%10.3f ms] %c T%u %s\n", p.Line->Nanoseconds * 1.e-6, levelNames[p.Line->Level], p.Thread,
+        p.Line->Text);
+    }
+    for (size_t r = 0; r < rings.size(); ++r)
+    {
+      rings[r]->Tail.store(heads[r], std::memory_order_release);
+      if (const uint64_t dropped = rings[r]->Dropped.exchange(0, std::memory_order_relaxed))
+      {
+        std::fprintf(sink, "MyTrace: T%u dropped %llu lines, ring full\n", rings[r]->Thread,
+          static_cast<unsigned long long>(dropped));
+      }
+    }
+    if (!pending.empty()) std::fflush(sink);
+
+    // rings of exited threads go once drained
+    std::lock_guard<std::mutex> lock(this->RingsMutex);
+    this->Rings.erase(std::remove_if(this->Rings.begin(), this->Rings.end(),
+                        [](const std::shared_ptr<Ring>& ring) {
+                          return ring->Finished.load(std::memory_order_acquire) &&
+                            ring->Tail.load(std::memory_order_relaxed) == ring->Head.load(std::memory_order_acquire);
+                        }),
+      this->Rings.end());
+  }
+
+private:
+  void Run()
+  {
+    std::unique_lock<std::mutex> lock(this->WakeMutex);
+    while (!this->Stop)
+    {
+      this->Wake.wait_for(lock, FlushInterval);
+      lock.unlock();
+      this->Drain();
+      lock.lock();
+    }
+  }
+
+  const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+  std::mutex RingsMutex;
+  std::vector<std::shared_ptr<Ring>> Rings;
+  unsigned NextThread = 0;
+  std::mutex DrainMutex;
+  std::FILE* Sink = nullptr;
+  std::mutex WakeMutex;
+  std::condition_variable Wake;
+  bool Stop = false;
+  std::thread Flusher;
+};
+
+Tracer& GetTracer()
+{
+  static Tracer tracer;
+  return tracer;
+}
+
+// the calling thread's ring, handed back to the tracer when the thread exits
+struct LocalRing
+{
+  std::shared_ptr<Ring> Owned = GetTracer().Register();
+  ~LocalRing() { this->Owned->Finished.store(true, std::memory_order_release); }
+};
+
+} // namespace
+
+std::atomic<int> MyTraceRuntimeLevel{ InitialLevel() };
+
+void MySetTraceSink(std::FILE* sink)
+{
+  GetTracer().SetSink(sink);
+}
+
+void MyTraceWrite(int level, const char* format, ...)
+{
+  Tracer& tracer = GetTracer();
+  thread_local LocalRing local;
+  Ring& ring = *local.Owned;
+
+  const uint64_t head = ring.Head.load(std::memory_order_relaxed);
+  const uint64_t used = head - ring.Tail.load(std::memory_order_acquire);
+  if (used >= RingRecords)
+  {
+    ring.Dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  Record& record = ring.Records[head & (RingRecords - 1)];
+  record.Nanoseconds = tracer.Now();
+  record.Level = std::clamp(level, int(MyTraceOff), int(MyTraceVerbose));
+  va_list arguments;
+  va_start(arguments, format);
+  std::vsnprintf(record.Text, sizeof(record.Text), format, arguments);
+  va_end(arguments);
+  ring.Head.store(head + 1, std::memory_order_release);
+
+  // half full: do not wait for the next interval
+  if (used + 1 == RingRecords / 2) tracer.WakeFlusher();
+}
+
+void MyFlushTrace()
+{
+  GetTracer().Drain();
+}
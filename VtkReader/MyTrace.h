@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+
+// Trace levels, most important first
+enum MyTraceLevel : int
+{
+  MyTraceOff = 0,
+  MyTraceError = 1,
+  MyTraceInfo = 2,   // a summary line per stage
+  MyTraceDebug = 3,  // details of a stage
+  MyTraceVerbose = 4 // anything else, never per point or per cell
+};
+
+// Highest level compiled in. Sites above it are discarded at compile time,
+// arguments included; define it to MyTraceError or 0 for release builds.
+#ifndef MY_TRACE_LEVEL
+#define MY_TRACE_LEVEL 3
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MY_TRACE_FORMAT(formatIndex, firstArgument) __attribute__((format(printf, formatIndex, firstArgument)))
+#else
+#define MY_TRACE_FORMAT(formatIndex, firstArgument)
+#endif
+
+// Runtime level, from the MY_TRACE environment variable (0-4) or MyTraceInfo
+extern std::atomic<int> MyTraceRuntimeLevel;
+
+inline bool MyTraceEnabled(int level)
+{
+  return level <= MyTraceRuntimeLevel.load(std::memory_order_relaxed);
+}
+
+inline void MySetTraceLevel(int level)
+{
+  MyTraceRuntimeLevel.store(level, std::memory_order_relaxed);
+}
+
+// Where flushed lines go, stderr by default. The sink is written by the
+// flusher thread only, never by the threads tracing.
+void MySetTraceSink(std::FILE* sink);
+
+// Formats one line into the calling thread's ring buffer: no lock, no
+// allocation after the thread's first line, no I/O. A full ring drops the
+// line and counts it. A background thread flushes all rings every few
+// milliseconds, lines in time order; use MY_TRACE instead of calling this.
+void MyTraceWrite(int level, const char* format, ...) MY_TRACE_FORMAT(2, 3);
+
+// Writes out every buffered line now, e.g. before the process reports an error
+void MyFlushTrace();
+
+// true where a site of this level would write; constant false when compiled
+// out, so summaries computed only for tracing can go behind it
+#define MY_TRACE_ENABLED(level) ((level) <= MY_TRACE_LEVEL && MyTraceEnabled(level))
+
+// printf style trace line, e.g. MY_TRACE(MyTraceInfo, "MyRead points=%lld", n)
+#define MY_TRACE(level, ...)                                                                                         \
+  do                                                                                                                 \
+  {                                                                                                                  \
+    if constexpr ((level) <= MY_TRACE_LEVEL)                                                                         \
+    {                                                                                                                \
+      if (MyTraceEnabled(level)) MyTraceWrite((level), __VA_ARGS__);                                                 \
+    }                                                                                                                \
+  } while (0)
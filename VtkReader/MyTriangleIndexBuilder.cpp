@@ -0,0 +1,39 @@
+#include "MyTriangleIndexBuilder.h"
+
+MyTriangleIndexBuilder::MyTriangleIndexBuilder(vtkCellArray* cells, bool parallel)
+  : Cells(cells)
+  , Parallel(parallel)
+  , FirstTriangle(this->Cells.GetNumberOfCells() + 1, 0)
+{
+  // triangles per cell and per block of cells, then the block totals are
+  // scanned and every block scans its own cells from its block start
+  const vtkIdType numCells = this->Cells.GetNumberOfCells();
+  const vtkIdType numBlocks = (numCells + MyParallelGrain - 1) / MyParallelGrain;
+  std::vector<vtkIdType> blockStart(numBlocks + 1, 0);
+  MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      vtkIdType sum = 0;
+      for (vtkIdType c = b * MyParallelGrain, last = std::min(numCells, c + MyParallelGrain); c < last; ++c)
+      {
+        const vtkIdType n = this->Cells.Size(c);
+        this->FirstTriangle[c + 1] = n >= 3 ? n - 2 : 0;
+        sum += this->FirstTriangle[c + 1];
+      }
+      blockStart[b + 1] = sum;
+    }
+  }, 1);
+  for (vtkIdType b = 0; b < numBlocks; ++b) blockStart[b + 1] += blockStart[b];
+
+  MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      vtkIdType first = blockStart[b];
+      for (vtkIdType c = b * MyParallelGrain, last = std::min(numCells, c + MyParallelGrain); c < last; ++c)
+      {
+        first += this->FirstTriangle[c + 1];
+        this->FirstTriangle[c + 1] = first;
+      }
+    }
+  }, 1);
+}
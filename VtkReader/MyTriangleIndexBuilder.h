@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "MyCellArrayView.h"
+#include "MyParallelFor.h"
+
+// Index buffer of the fan triangulation of a vtkCellArray, read straight from
+// its offsets and connectivity. The constructor counts the triangles of every
+// cell and prefix sums them into output positions; Fill then writes each cell
+// at its own position from all threads. Cells with fewer than three points
+// produce no triangles.
+class MyTriangleIndexBuilder
+{
+public:
+  explicit MyTriangleIndexBuilder(vtkCellArray* cells, bool parallel = true);
+
+  vtkIdType GetNumberOfCells() const { return this->Cells.GetNumberOfCells(); }
+  vtkIdType GetNumberOfTriangles() const { return this->FirstTriangle.back(); }
+
+  // the triangles of cellId are [GetFirstTriangle(cellId), GetFirstTriangle(cellId + 1))
+  vtkIdType GetFirstTriangle(vtkIdType cellId) const { return this->FirstTriangle[cellId]; }
+
+  // Writes 3 * GetNumberOfTriangles() indices, (v0, vj, vj+1) per triangle
+  template <typename IndexT>
+  void Fill(IndexT* triangles) const
+  {
+    MyParallelFor(this->Parallel, this->GetNumberOfCells(), [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType c = begin; c < end; ++c)
+      {
+        const vtkIdType b = this->Cells.Begin(c), n = this->Cells.Size(c);
+        IndexT* out = triangles + 3 * this->FirstTriangle[c];
+        const IndexT v0 = static_cast<IndexT>(this->Cells.Id(b));
+        for (vtkIdType j = 1; j + 1 < n; ++j, out += 3)
+        {
+          out[0] = v0;
+          out[1] = static_cast<IndexT>(this->Cells.Id(b + j));
+          out[2] = static_cast<IndexT>(this->Cells.Id(b + j + 1));
+        }
+      }
+    });
+  }
+
+  template <typename IndexT>
+  std::vector<IndexT> Build() const
+  {
+    std::vector<IndexT> triangles(3 * this->GetNumberOfTriangles());
+    this->Fill(triangles.data());
+    return triangles;
+  }
+
+private:
+  MyCellArrayView Cells;
+  bool Parallel;
+  std::vector<vtkIdType> FirstTriangle; // one per cell plus the total
+};
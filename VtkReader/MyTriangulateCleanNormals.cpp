@@ -0,0 +1,522 @@
+#include "MyTriangulateCleanNormals.h"
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkTypeInt64Array.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "MyCellArrayView.h"
+#include "MyParallelFor.h"
+#include "MyWeldPoints.h"
+
+namespace {
+
+vtkIdType TrianglesOf(vtkIdType npts)
+{
+  return npts >= 3 ? npts - 2 : 0;
+}
+
+// vtkTriangle::ComputeNormal, rounded to float like vtkPolyDataNormals' cell normals
+void FaceNormal(const double* v1, const double* v2, const double* v3, float* out)
+{
+  const double ax = v3[0] - v2[0], ay = v3[1] - v2[1], az = v3[2] - v2[2];
+  const double bx = v1[0] - v2[0], by = v1[1] - v2[1], bz = v1[2] - v2[2];
+  double n[3] = { ay * bz - az * by, az * bx - ax * bz, ax * by - ay * bx };
+  const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+  if (length != 0.0)
+  {
+    n[0] /= length;
+    n[1] /= length;
+    n[2] /= length;
+  }
+  out[0] = static_cast<float>(n[0]);
+  out[1] = static_cast<float>(n[1]);
+  out[2] = static_cast<float>(n[2]);
+}
+
+// Newell normal, not normalized
+void PolygonNormal(const double* xyz, const std::vector<vtkIdType>& ids, double* normal)
+{
+  normal[0] = normal[1] = normal[2] = 0.0;
+  for (size_t i = 0, n = ids.size(); i < n; ++i)
+  {
+    const double* p = xyz + 3 * ids[i];
+    const double* q = xyz + 3 * ids[(i + 1) % n];
+    normal[0] += (p[1] - q[1]) * (p[2] + q[2]);
+    normal[1] += (p[2] - q[2]) * (p[0] + q[0]);
+    normal[2] += (p[0] - q[0]) * (p[1] + q[1]);
+  }
+}
+
+// ids.size() - 2 triangles in the winding of the polygon: a fan from the
+// first point when the polygon is convex, ear clipping in its plane when not,
+// so non-convex outlines get no triangles outside of them. A polygon too
+// degenerate to have an ear left is fanned from there on.
+void TriangulatePolygon(const double* xyz, const std::vector<vtkIdType>& ids, std::vector<int>& ring, vtkIdType* out)
+{
+  const int n = static_cast<int>(ids.size());
+  auto emit = [&](int a, int b, int c) {
+    out[0] = ids[a];
+    out[1] = ids[b];
+    out[2] = ids[c];
+    out += 3;
+  };
+  if (n == 3)
+  {
+    emit(0, 1, 2);
+    return;
+  }
+
+  // project on the coordinate plane the polygon faces most, counterclockwise
+  double normal[3];
+  PolygonNormal(xyz, ids, normal);
+  int axis = 0;
+  for (int k = 1; k < 3; ++k)
+  {
+    if (std::abs(normal[k]) > std::abs(normal[axis])) axis = k;
+  }
+  const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+  const double sign = normal[axis] < 0.0 ? -1.0 : 1.0;
+  auto turn = [&](int a, int b, int c) {
+    const double* pa = xyz + 3 * ids[a];
+    const double* pb = xyz + 3 * ids[b];
+    const double* pc = xyz + 3 * ids[c];
+    return sign * ((pb[u] - pa[u]) * (pc[v] - pb[v]) - (pb[v] - pa[v]) * (pc[u] - pb[u]));
+  };
+
+  bool convex = true;
+  for (int i = 0; i < n && convex; ++i) convex = turn(i, (i + 1) % n, (i + 2) % n) >= 0.0;
+
+  ring.resize(n);
+  for (int i = 0; i < n; ++i) ring[i] = i;
+  while (!convex && ring.size() > 3)
+  {
+    const int m = static_cast<int>(ring.size());
+    int ear = -1;
+    for (int i = 0; i < m && ear < 0; ++i)
+    {
+      const int a = ring[(i + m - 1) % m], b = ring[i], c = ring[(i + 1) % m];
+      if (turn(a, b, c) <= 0.0) continue;
+      bool empty = true;
+      for (int j = 0; j < m && empty; ++j)
+      {
+        const int p = ring[j];
+        if (p == a || p == b || p == c) continue;
+        empty = !(turn(a, b, p) >= 0.0 && turn(b, c, p) >= 0.0 && turn(c, a, p) >= 0.0);
+      }
+      if (empty) ear = i;
+    }
+    if (ear < 0) break;
+    emit(ring[(ear + m - 1) % m], ring[ear], ring[(ear + 1) % m]);
+    ring.erase(ring.begin() + ear);
+  }
+  for (size_t j = 1; j + 1 < ring.size(); ++j) emit(ring[0], ring[j], ring[j + 1]);
+}
+
+} // namespace
+
+vtkSmartPointer<vtkPolyData> MyTriangulateCleanNormals(vtkPolyData* input, const MyTriangulateCleanNormalsOptions& options)
+{
+  auto output = vtkSmartPointer<vtkPolyData>::New();
+  vtkPoints* inPoints = input ? input->GetPoints() : nullptr;
+  if (!inPoints) return output;
+  const bool parallel = options.Parallel;
+
+  const vtkIdType numInPoints = inPoints->GetNumberOfPoints();
+  std::vector<double> xyz(3 * numInPoints);
+  vtkDataArray* inCoords = inPoints->GetData();
+  MyParallelFor(parallel, numInPoints, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) inCoords->GetTuple(i, xyz.data() + 3 * i);
+  });
+
+  // 1. triangulate: triangles per source cell, prefix sum, then every cell
+  // writes its triangles into its own slice
+  const MyCellArrayView polys(input->GetPolys()), strips(input->GetStrips());
+  const vtkIdType numPolys = polys.GetNumberOfCells();
+  const vtkIdType numSources = numPolys + strips.GetNumberOfCells();
+  const vtkIdType firstPolyCellId = input->GetNumberOfVerts() + input->GetNumberOfLines();
+
+  std::vector<vtkIdType> firstTriangle(numSources + 1);
+  MyParallelFor(parallel, numSources, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType c = begin; c < end; ++c)
+    {
+      firstTriangle[c] = TrianglesOf(c < numPolys ? polys.Size(c) : strips.Size(c - numPolys));
+    }
+  });
+  vtkIdType numTriangles = 0;
+  for (vtkIdType& first : firstTriangle)
+  {
+    const vtkIdType n = first;
+    first = numTriangles;
+    numTriangles += n;
+  }
+
+  std::vector<vtkIdType> corners(3 * numTriangles);
+  std::vector<vtkIdType> sourceCell(numTriangles);
+  MyParallelFor(parallel, numSources, [&](vtkIdType begin, vtkIdType end) {
+    std::vector<vtkIdType> ids;
+    std::vector<int> ring;
+    for (vtkIdType c = begin; c < end; ++c)
+    {
+      vtkIdType t = firstTriangle[c];
+      vtkIdType* out = corners.data() + 3 * t;
+      if (c < numPolys)
+      {
+        const vtkIdType b = polys.Begin(c), n = polys.Size(c);
+        if (n < 3) continue;
+        ids.resize(n);
+        for (vtkIdType j = 0; j < n; ++j) ids[j] = polys.Id(b + j);
+        TriangulatePolygon(xyz.data(), ids, ring, out);
+        std::fill_n(sourceCell.begin() + t, n - 2, firstPolyCellId + c);
+      }
+      else
+      {
+        // vtkTriangleStrip::DecomposeStrip, odd triangles flipped to keep the winding
+        const vtkIdType s = c - numPolys, b = strips.Begin(s), n = strips.Size(s);
+        for (vtkIdType j = 0; j + 2 < n; ++j, ++t, out += 3)
+        {
+          out[0] = strips.Id(b + j + (j & 1));
+          out[1] = strips.Id(b + j + 1 - (j & 1));
+          out[2] = strips.Id(b + j + 2);
+          sourceCell[t] = firstPolyCellId + c;
+        }
+      }
+    }
+  });
+
+  // 2. weld: MyComputeWeldMap groups the points; a triangle with two corners
+  // in one group collapsed and is dropped.
+
+  MyWeldPointsOptions weldOptions;
+  weldOptions.Tolerance = options.Tolerance;
+  weldOptions.Parallel = parallel;
+  std::vector<vtkIdType> group;
+  const vtkIdType numGroups = MyComputeWeldMap(xyz.data(), numInPoints, weldOptions, group);
+
+  // 3. drop triangles that collapsed, blockwise count + prefix sum + fill
+  const vtkIdType numBlocks = (numTriangles + MyParallelGrain - 1) / MyParallelGrain;
+  std::vector<vtkIdType> firstKept(numBlocks + 1);
+  auto collapsed = [&](vtkIdType t) {
+    const vtkIdType* c = corners.data() + 3 * t;
+    const vtkIdType g0 = group[c[0]], g1 = group[c[1]], g2 = group[c[2]];
+    return g0 == g1 || g1 == g2 || g0 == g2;
+  };
+  MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      vtkIdType kept = 0;
+      for (vtkIdType t = b * MyParallelGrain, last = std::min(numTriangles, t + MyParallelGrain); t < last; ++t)
+      {
+        kept += !collapsed(t);
+      }
+      firstKept[b] = kept;
+    }
+  }, 1);
+  vtkIdType numKept = 0;
+  for (vtkIdType& first : firstKept)
+  {
+    const vtkIdType n = first;
+    first = numKept;
+    numKept += n;
+  }
+
+  // Groups get output ids in order of first use by a kept triangle, the way
+  // vtkCleanPolyData inserts into its locator, and keep the data of that
+  // first point. Points only collapsed triangles used get none, so every
+  // output point has at least one triangle. Collapsed triangles are marked
+  // with a first corner of -1 for the fill.
+  std::vector<vtkIdType> outId(numGroups, -1);
+  std::vector<vtkIdType> sourcePoint;
+  for (vtkIdType t = 0; t < numTriangles; ++t)
+  {
+    vtkIdType* c = corners.data() + 3 * t;
+    if (collapsed(t))
+    {
+      c[0] = -1;
+      continue;
+    }
+    for (int k = 0; k < 3; ++k)
+    {
+      vtkIdType& id = outId[group[c[k]]];
+      if (id < 0)
+      {
+        id = static_cast<vtkIdType>(sourcePoint.size());
+        sourcePoint.push_back(c[k]);
+      }
+      c[k] = id;
+    }
+  }
+  std::vector<vtkIdType>().swap(group);
+
+  vtkNew<vtkTypeInt64Array> offsets, connectivity;
+  offsets->SetNumberOfValues(numKept + 1);
+  connectivity->SetNumberOfValues(3 * numKept);
+  vtkTypeInt64* outOffsets = offsets->GetPointer(0);
+  vtkTypeInt64* outConnectivity = connectivity->GetPointer(0);
+  vtkNew<vtkIdList> fromCells, toCells;
+  fromCells->SetNumberOfIds(numKept);
+  toCells->SetNumberOfIds(numKept);
+  MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      vtkIdType k = firstKept[b];
+      for (vtkIdType t = b * MyParallelGrain, last = std::min(numTriangles, t + MyParallelGrain); t < last; ++t)
+      {
+        if (corners[3 * t] < 0) continue;
+        std::copy_n(corners.data() + 3 * t, 3, outConnectivity + 3 * k);
+        outOffsets[k] = 3 * k;
+        fromCells->SetId(k, sourceCell[t]);
+        toCells->SetId(k, k);
+        ++k;
+      }
+    }
+  }, 1);
+  outOffsets[numKept] = 3 * numKept;
+  std::vector<vtkIdType>().swap(corners);
+
+  // 4. normals, in the steps of vtkPolyDataNormals: orientation, float face
+  // normals, splitting at feature edges, then point normals summed per point
+  // over its triangles in triangle order and normalized in float
+  vtkIdType numOutPoints = static_cast<vtkIdType>(sourcePoint.size());
+  std::vector<float> faceNormals, pointNormals;
+  if ((options.ComputePointNormals || options.ComputeCellNormals) && numKept > 0)
+  {
+    // point -> corners of its triangles, filled concurrently and sorted back
+    // into triangle order
+    std::vector<std::atomic<vtkIdType>> fill(numOutPoints + 1);
+    MyParallelFor(parallel, 3 * numKept, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i) fill[outConnectivity[i] + 1].fetch_add(1, std::memory_order_relaxed);
+    });
+    std::vector<vtkIdType> firstLink(numOutPoints + 1, 0);
+    for (vtkIdType i = 0; i < numOutPoints; ++i)
+    {
+      firstLink[i + 1] = firstLink[i] + fill[i + 1].load(std::memory_order_relaxed);
+      fill[i].store(firstLink[i], std::memory_order_relaxed);
+    }
+    std::vector<vtkIdType> links(3 * numKept);
+    MyParallelFor(parallel, 3 * numKept, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        links[fill[outConnectivity[i]].fetch_add(1, std::memory_order_relaxed)] = i;
+      }
+    });
+    std::vector<std::atomic<vtkIdType>>().swap(fill);
+    MyParallelFor(parallel, numOutPoints, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i) std::sort(links.begin() + firstLink[i], links.begin() + firstLink[i + 1]);
+    });
+
+    if (options.Consistency)
+    {
+      // breadth first from the first triangle of every connected part, like
+      // vtkPolyDataNormals::TraverseAndOrder: a neighbour across an edge (p, q)
+      // that does not run it as q -> p is reversed. Non-manifold edges are
+      // crossed to every neighbour.
+      std::vector<char> visited(numKept, 0);
+      std::vector<vtkIdType> wave;
+      for (vtkIdType seed = 0; seed < numKept; ++seed)
+      {
+        if (visited[seed]) continue;
+        visited[seed] = 1;
+        wave.assign(1, seed);
+        for (size_t w = 0; w < wave.size(); ++w)
+        {
+          const vtkTypeInt64* c = outConnectivity + 3 * wave[w];
+          for (int e = 0; e < 3; ++e)
+          {
+            const vtkIdType p = c[e], q = c[(e + 1) % 3];
+            for (vtkIdType l = firstLink[p]; l < firstLink[p + 1]; ++l)
+            {
+              const vtkIdType neighbor = links[l] / 3;
+              if (visited[neighbor]) continue;
+              vtkTypeInt64* d = outConnectivity + 3 * neighbor;
+              const int k = d[0] == q ? 0 : d[1] == q ? 1 : d[2] == q ? 2 : -1;
+              if (k < 0) continue;
+              if (d[(k + 1) % 3] != p)
+              {
+                // the links hold corners, so the two swapped points trade theirs
+                const vtkIdType a = 3 * neighbor, b = a + 2;
+                std::replace(links.begin() + firstLink[d[0]], links.begin() + firstLink[d[0] + 1], a, b);
+                std::replace(links.begin() + firstLink[d[2]], links.begin() + firstLink[d[2] + 1], b, a);
+                std::swap(d[0], d[2]);
+              }
+              visited[neighbor] = 1;
+              wave.push_back(neighbor);
+            }
+          }
+        }
+      }
+    }
+
+    faceNormals.resize(3 * numKept);
+    MyParallelFor(parallel, numKept, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType t = begin; t < end; ++t)
+      {
+        const vtkTypeInt64* c = outConnectivity + 3 * t;
+        FaceNormal(xyz.data() + 3 * sourcePoint[c[0]], xyz.data() + 3 * sourcePoint[c[1]],
+          xyz.data() + 3 * sourcePoint[c[2]], faceNormals.data() + 3 * t);
+      }
+    });
+
+    if (options.ComputePointNormals)
+    {
+      // Splitting: around every point, triangles reached from each other over
+      // manifold edges whose face normals are within the feature angle form a
+      // region; the first region keeps the point, every other one gets a copy
+      // appended after all points, as vtkPolyDataNormals::MarkAndSplit does.
+      // Regions are labelled per link, so one point never writes another's.
+      std::vector<int> region;
+      std::vector<vtkIdType> firstCopy(numOutPoints + 1, 0);
+      if (options.Splitting)
+      {
+        const double cosAngle = std::cos(options.FeatureAngle * 3.14159265358979323846 / 180.0);
+        region.assign(3 * numKept, -1);
+        MyParallelFor(parallel, numOutPoints, [&](vtkIdType begin, vtkIdType end) {
+          std::vector<std::pair<vtkIdType, vtkIdType>> edges; // (other point, link), sorted
+          std::vector<vtkIdType> stack;
+          for (vtkIdType i = begin; i < end; ++i)
+          {
+            const vtkIdType first = firstLink[i], last = firstLink[i + 1];
+            edges.clear();
+            for (vtkIdType l = first; l < last; ++l)
+            {
+              const vtkIdType t = links[l] / 3, k = links[l] % 3;
+              edges.emplace_back(outConnectivity[3 * t + (k + 1) % 3], l);
+              edges.emplace_back(outConnectivity[3 * t + (k + 2) % 3], l);
+            }
+            std::sort(edges.begin(), edges.end());
+
+            int numRegions = 0;
+            for (vtkIdType l = first; l < last; ++l)
+            {
+              if (region[l] >= 0) continue;
+              region[l] = numRegions;
+              stack.assign(1, l);
+              while (!stack.empty())
+              {
+                const vtkIdType from = stack.back();
+                stack.pop_back();
+                const vtkIdType t = links[from] / 3, k = links[from] % 3;
+                const vtkIdType others[2] = { outConnectivity[3 * t + (k + 1) % 3],
+                  outConnectivity[3 * t + (k + 2) % 3] };
+                for (vtkIdType other : others)
+                {
+                  // the edge (i, other) is manifold when exactly two triangles of i share it
+                  auto range = std::equal_range(edges.begin(), edges.end(), std::make_pair(other, vtkIdType(0)),
+                    [](const auto& a, const auto& b) { return a.first < b.first; });
+                  if (range.second - range.first != 2) continue;
+                  const vtkIdType to = range.first->second == from ? (range.first + 1)->second : range.first->second;
+                  if (region[to] >= 0) continue;
+                  const float* a = faceNormals.data() + 3 * t;
+                  const float* b = faceNormals.data() + 3 * (links[to] / 3);
+                  if (a[0] * b[0] + a[1] * b[1] + a[2] * b[2] <= cosAngle) continue;
+                  region[to] = numRegions;
+                  stack.push_back(to);
+                }
+              }
+              ++numRegions;
+            }
+            firstCopy[i] = numRegions - 1;
+          }
+        });
+      }
+      vtkIdType numCopies = 0;
+      for (vtkIdType& first : firstCopy)
+      {
+        const vtkIdType n = first;
+        first = numOutPoints + numCopies;
+        numCopies += n;
+      }
+      sourcePoint.resize(numOutPoints + numCopies);
+      pointNormals.resize(3 * (numOutPoints + numCopies));
+
+      // sums per region, copies take the data of their point and their
+      // triangles' corners are renumbered through the links
+      MyParallelFor(parallel, numOutPoints, [&](vtkIdType begin, vtkIdType end) {
+        std::vector<float> sums;
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          const vtkIdType numRegions = firstCopy[i + 1] - firstCopy[i] + 1;
+          sums.assign(3 * numRegions, 0.0f);
+          for (vtkIdType l = firstLink[i]; l < firstLink[i + 1]; ++l)
+          {
+            const int r = region.empty() ? 0 : region[l];
+            const float* f = faceNormals.data() + 3 * (links[l] / 3);
+            sums[3 * r] += f[0];
+            sums[3 * r + 1] += f[1];
+            sums[3 * r + 2] += f[2];
+            if (r > 0) outConnectivity[links[l]] = firstCopy[i] + r - 1;
+          }
+          for (vtkIdType r = 0; r < numRegions; ++r)
+          {
+            const vtkIdType id = r == 0 ? i : firstCopy[i] + r - 1;
+            if (r > 0) sourcePoint[id] = sourcePoint[i];
+            // vtkMath::Normalize(float*)
+            float* n = sums.data() + 3 * r;
+            const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            if (length != 0.0f)
+            {
+              n[0] /= length;
+              n[1] /= length;
+              n[2] /= length;
+            }
+            std::copy_n(n, 3, pointNormals.data() + 3 * id);
+          }
+        }
+      });
+      numOutPoints += numCopies;
+    }
+  }
+
+  // 5. points and attributes of the first point of every group, in the input precision
+  vtkNew<vtkPoints> points;
+  points->SetDataType(inPoints->GetDataType());
+  points->SetNumberOfPoints(numOutPoints);
+  vtkDataArray* outCoords = points->GetData();
+  vtkNew<vtkIdList> fromPoints, toPoints;
+  fromPoints->SetNumberOfIds(numOutPoints);
+  toPoints->SetNumberOfIds(numOutPoints);
+  MyParallelFor(parallel, numOutPoints, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      outCoords->SetTuple(i, xyz.data() + 3 * sourcePoint[i]);
+      fromPoints->SetId(i, sourcePoint[i]);
+      toPoints->SetId(i, i);
+    }
+  });
+  output->SetPoints(points);
+
+  vtkNew<vtkCellArray> triangles;
+  triangles->SetData(offsets, connectivity);
+  output->SetPolys(triangles);
+
+  vtkPointData* outPD = output->GetPointData();
+  if (!pointNormals.empty()) outPD->CopyNormalsOff();
+  outPD->CopyAllocate(input->GetPointData(), numOutPoints);
+  outPD->CopyData(input->GetPointData(), fromPoints, toPoints);
+  vtkCellData* outCD = output->GetCellData();
+  if (options.ComputeCellNormals && !faceNormals.empty()) outCD->CopyNormalsOff();
+  outCD->CopyAllocate(input->GetCellData(), numKept);
+  outCD->CopyData(input->GetCellData(), fromCells, toCells);
+
+  auto normalsOf = [](const std::vector<float>& values) {
+    vtkNew<vtkFloatArray> normals;
+    normals->SetName("Normals");
+    normals->SetNumberOfComponents(3);
+    normals->SetNumberOfTuples(static_cast<vtkIdType>(values.size() / 3));
+    std::copy(values.begin(), values.end(), normals->GetPointer(0));
+    return vtkSmartPointer<vtkFloatArray>(normals);
+  };
+  if (!pointNormals.empty()) outPD->SetNormals(normalsOf(pointNormals));
+  if (options.ComputeCellNormals && !faceNormals.empty()) outCD->SetNormals(normalsOf(faceNormals));
+  return output;
+}
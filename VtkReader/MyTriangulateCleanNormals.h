@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+
+struct MyTriangulateCleanNormalsOptions
+{
+  // add point "Normals" the way vtkPolyDataNormals does; the splitting
+  // settings below only apply with it, all default to that filter's defaults
+  bool ComputePointNormals = true;
+
+  // duplicate points along edges sharper than FeatureAngle (degrees) so each
+  // side gets its own normal
+  bool Splitting = true;
+  double FeatureAngle = 30.0;
+
+  // reverse triangles to the winding of their neighbours before the normals
+  bool Consistency = true;
+
+  // add cell "Normals", the float face normal of every output triangle
+  bool ComputeCellNormals = false;
+
+  // absolute merge distance, see MyWeldPoints; 0 welds equal coordinates only
+  double Tolerance = 0.0;
+
+  // run the per-cell and per-point passes with vtkSMPTools
+  bool Parallel = true;
+};
+
+// One stage in place of vtkTriangleFilter -> vtkCleanPolyData -> vtkPolyDataNormals.
+// Polygons are triangulated and strips decomposed, points are welded by
+// MyWeldPoints and numbered in order of first use, triangles that collapse
+// after welding are dropped, and the normals follow vtkPolyDataNormals:
+// orientation made consistent from the first triangle of every connected
+// part, points split at feature edges with the copies appended after all
+// points, float face normals summed into point normals. No intermediate
+// polydata of every filter is materialized.
+//
+// Convex polygons are fanned from their first point, non-convex ones are ear
+// clipped in their plane, so no triangle lies outside the outline. The
+// diagonals can still differ from vtkTriangleFilter's, which splits quads
+// along the shorter one and ear clips every polygon by its own rules.
+//
+// With Tolerance 0 and polydata made only of triangles the result matches
+// that chain bit for bit with Splitting and Consistency off: same point
+// order, same triangles, same float normals. With them on it follows the same
+// rules, but where a point has several non-manifold fans, or a surface is
+// not orientable, the split copies and flipped triangles can come out in a
+// different order.
+// Other differences from the chain:
+// verts and lines are not passed through and collapsed triangles are dropped
+// rather than turned into lines, together with the points only they used, so
+// only polys come out and every point belongs to one.
+vtkSmartPointer<vtkPolyData> MyTriangulateCleanNormals(vtkPolyData* input,
+  const MyTriangulateCleanNormalsOptions& options = {});
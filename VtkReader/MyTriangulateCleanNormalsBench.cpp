@@ -0,0 +1,259 @@
+// Time and memory of vtkTriangleFilter -> vtkCleanPolyData -> vtkPolyDataNormals,
+// all three with their defaults, against the fused MyTriangulateCleanNormals,
+// on a synthetic grid where every quad is two triangles with their own four
+// points, so the clean step has work to do. A ridge along the middle is
+// sharper than the feature angle and every seventh second triangle is
+// reversed, so splitting and consistency have work too. Also checks that both
+// paths give the same points, triangles and normals, and before timing that a
+// triangle collapsed by welding leaves no point behind.
+//
+// Memory is the growth of the peak resident set size while one path runs, in
+// a child process of its own per path and size: the bench starts itself with
+// --peak-rss <path> <quads>. It counts everything either path allocates,
+// VTK arrays included, not only what it leaves behind.
+//
+// usage: MyTriangulateCleanNormalsBench [number of quads ...]
+//        defaults to 100K, 1M and 10M quads
+#include <vtkCellArray.h>
+#include <vtkCleanPolyData.h>
+#include <vtkFloatArray.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkTriangleFilter.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#define popen _popen
+#define pclose _pclose
+#else
+#include <sys/resource.h>
+#endif
+
+#include "MyTriangulateCleanNormals.h"
+
+namespace {
+
+vtkSmartPointer<vtkPolyData> TriangleSoup(vtkIdType numQuads)
+{
+  const vtkIdType nx = static_cast<vtkIdType>(std::sqrt(static_cast<double>(numQuads)));
+  const vtkIdType ny = numQuads / nx;
+
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(4 * nx * ny);
+  vtkNew<vtkCellArray> polys;
+  polys->AllocateExact(2 * nx * ny, 6 * nx * ny);
+
+  auto z = [nx](vtkIdType i, vtkIdType j) {
+    return 0.25 * std::sin(0.01 * i) * std::cos(0.01 * j) + 0.001 * std::abs(static_cast<double>(i - nx / 2));
+  };
+  vtkIdType id = 0;
+  for (vtkIdType j = 0; j < ny; ++j)
+  {
+    for (vtkIdType i = 0; i < nx; ++i)
+    {
+      const vtkIdType corner[4][2] = { { i, j }, { i + 1, j }, { i + 1, j + 1 }, { i, j + 1 } };
+      vtkIdType ids[4];
+      for (int k = 0; k < 4; ++k, ++id)
+      {
+        points->SetPoint(id, 0.001 * corner[k][0], 0.001 * corner[k][1], z(corner[k][0], corner[k][1]));
+        ids[k] = id;
+      }
+      const vtkIdType second[3] = { ids[0], (i + j) % 7 ? ids[2] : ids[3], (i + j) % 7 ? ids[3] : ids[2] };
+      polys->InsertNextCell(3, ids);
+      polys->InsertNextCell(3, second);
+    }
+  }
+
+  auto poly = vtkSmartPointer<vtkPolyData>::New();
+  poly->SetPoints(points);
+  poly->SetPolys(polys);
+  return poly;
+}
+
+template <typename F>
+double Seconds(F&& run)
+{
+  auto begin = std::chrono::steady_clock::now();
+  run();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int64_t PeakRssBytes()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+  return static_cast<int64_t>(counters.PeakWorkingSetSize);
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+  return static_cast<int64_t>(usage.ru_maxrss);
+#else
+  return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+vtkSmartPointer<vtkPolyData> Chained(vtkPolyData* input)
+{
+  vtkNew<vtkTriangleFilter> triangleFilter;
+  triangleFilter->SetInputData(input);
+  vtkNew<vtkCleanPolyData> clean;
+  clean->SetInputConnection(triangleFilter->GetOutputPort());
+  vtkNew<vtkPolyDataNormals> normalsFilter;
+  normalsFilter->SetInputConnection(clean->GetOutputPort());
+  normalsFilter->Update();
+  return normalsFilter->GetOutput();
+}
+
+// megabytes the peak RSS of a fresh process grows by while one path runs,
+// -1 when the child did not report
+double PeakRssGrowthMB(const char* self, const char* path, vtkIdType numQuads)
+{
+  const std::string command =
+    "\"" + std::string(self) + "\" --peak-rss " + path + " " + std::to_string(static_cast<long long>(numQuads));
+  std::FILE* child = popen(command.c_str(), "r");
+  if (!child) return -1.0;
+  long long bytes = -1;
+  if (std::fscanf(child, "%lld", &bytes) != 1) bytes = -1;
+  pclose(child);
+  return bytes < 0 ? -1.0 : bytes / (1024.0 * 1024.0);
+}
+
+double Median(std::vector<double> values)
+{
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+bool SameOutput(vtkPolyData* a, vtkPolyData* b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() || a->GetNumberOfPolys() != b->GetNumberOfPolys()) return false;
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double p[3], q[3];
+    a->GetPoint(i, p);
+    b->GetPoint(i, q);
+    if (std::memcmp(p, q, sizeof(p)) != 0) return false;
+  }
+
+  vtkNew<vtkIdList> cellA, cellB;
+  for (vtkIdType c = 0; c < a->GetNumberOfPolys(); ++c)
+  {
+    a->GetPolys()->GetCellAtId(c, cellA);
+    b->GetPolys()->GetCellAtId(c, cellB);
+    if (cellA->GetNumberOfIds() != cellB->GetNumberOfIds()) return false;
+    for (vtkIdType k = 0; k < cellA->GetNumberOfIds(); ++k)
+    {
+      if (cellA->GetId(k) != cellB->GetId(k)) return false;
+    }
+  }
+
+  auto* normalsA = vtkFloatArray::SafeDownCast(a->GetPointData()->GetNormals());
+  auto* normalsB = vtkFloatArray::SafeDownCast(b->GetPointData()->GetNormals());
+  return normalsA && normalsB && normalsA->GetNumberOfValues() == normalsB->GetNumberOfValues() &&
+    std::memcmp(normalsA->GetPointer(0), normalsB->GetPointer(0), normalsA->GetNumberOfValues() * sizeof(float)) == 0;
+}
+
+// Triangles (0 1 2) and (0 3 4) with point 3 welded onto point 0: the second
+// collapses and point 4, used by nothing else, must go with it, with every
+// point left having its triangle and normal
+bool CollapsedTriangleDropsItsPoints()
+{
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0.0, 0.0, 0.0);
+  points->InsertNextPoint(1.0, 0.0, 0.0);
+  points->InsertNextPoint(0.0, 1.0, 0.0);
+  points->InsertNextPoint(0.0, 0.0, 0.0);
+  points->InsertNextPoint(5.0, 5.0, 5.0);
+  vtkNew<vtkCellArray> polys;
+  const vtkIdType kept[3] = { 0, 1, 2 }, collapsed[3] = { 0, 3, 4 };
+  polys->InsertNextCell(3, kept);
+  polys->InsertNextCell(3, collapsed);
+  vtkNew<vtkPolyData> input;
+  input->SetPoints(points);
+  input->SetPolys(polys);
+
+  for (bool parallel : { false, true })
+  {
+    MyTriangulateCleanNormalsOptions options;
+    options.Parallel = parallel;
+    vtkSmartPointer<vtkPolyData> output = MyTriangulateCleanNormals(input, options);
+    vtkDataArray* normals = output->GetPointData()->GetNormals();
+    if (output->GetNumberOfPoints() != 3 || output->GetNumberOfPolys() != 1 || !normals ||
+      normals->GetNumberOfTuples() != 3 || normals->GetComponent(2, 2) != 1.0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  if (argc == 4 && std::strcmp(argv[1], "--peak-rss") == 0)
+  {
+    vtkSmartPointer<vtkPolyData> input = TriangleSoup(std::stoll(argv[3]));
+    const int64_t before = PeakRssBytes();
+    vtkSmartPointer<vtkPolyData> output =
+      std::strcmp(argv[2], "chained") == 0 ? Chained(input) : MyTriangulateCleanNormals(input);
+    std::printf("%lld\n", static_cast<long long>(PeakRssBytes() - before));
+    return output->GetNumberOfPoints() > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  if (!CollapsedTriangleDropsItsPoints())
+  {
+    std::cerr << "MyTriangulateCleanNormals kept the point of a collapsed triangle\n";
+    return EXIT_FAILURE;
+  }
+
+  std::vector<vtkIdType> sizes;
+  for (int i = 1; i < argc; ++i) sizes.push_back(std::stoll(argv[i]));
+  if (sizes.empty()) sizes = { 100000, 1000000, 10000000 };
+  constexpr int runs = 5;
+
+  std::printf("%12s %12s %12s %8s %12s %12s %10s\n", "quads", "chained(s)", "fused(s)", "speedup", "chained(MB)",
+    "fused(MB)", "output");
+  for (vtkIdType numQuads : sizes)
+  {
+    vtkSmartPointer<vtkPolyData> input = TriangleSoup(numQuads);
+
+    std::vector<double> chainedTimes, fusedTimes;
+    vtkSmartPointer<vtkPolyData> chained, fused;
+    for (int run = 0; run < runs; ++run)
+    {
+      chainedTimes.push_back(Seconds([&] { chained = Chained(input); }));
+      fusedTimes.push_back(Seconds([&] { fused = MyTriangulateCleanNormals(input); }));
+    }
+    const double chainedMB = PeakRssGrowthMB(argv[0], "chained", numQuads);
+    const double fusedMB = PeakRssGrowthMB(argv[0], "fused", numQuads);
+
+    const double chainedSeconds = Median(chainedTimes);
+    const double fusedSeconds = Median(fusedTimes);
+    std::printf("%12lld %12.3f %12.3f %7.1fx %12.1f %12.1f %10s\n", static_cast<long long>(numQuads), chainedSeconds,
+      fusedSeconds, chainedSeconds / fusedSeconds, chainedMB, fusedMB, SameOutput(chained, fused) ? "identical" : "DIFFERS");
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+#include "MyVertexColorizer.h"
+
+#include <vtkCellData.h>
+#include <vtkMath.h>
+#include <vtkPointData.h>
+
+#include <cstring>
+
+#include "MyCellArrayView.h"
+#include "MyParallelFor.h"
+
+MyVertexColorizer::MyVertexColorizer(vtkPolyData* poly, bool parallel)
+  : Poly(poly)
+  , Parallel(parallel)
+{
+}
+
+vtkDataArray* MyVertexColorizer::FindArray(const char* arrayName) const
+{
+  if (!this->Poly || !arrayName) return nullptr;
+  if (vtkDataArray* array = this->Poly->GetPointData()->GetArray(arrayName)) return array;
+  return this->Poly->GetCellData()->GetArray(arrayName);
+}
+
+const std::vector<vtkIdType>& MyVertexColorizer::GetVertexCells() const
+{
+  std::call_once(this->VertexCellsOnce, [this] {
+    this->VertexCells.assign(this->GetNumberOfVertices(), -1);
+
+    // cell data is ordered verts, lines, polys, strips
+    const vtkIdType firstPoly = this->Poly->GetNumberOfVerts() + this->Poly->GetNumberOfLines();
+    const MyCellArrayView polys(this->Poly->GetPolys());
+    for (vtkIdType c = 0; c < polys.GetNumberOfCells(); ++c)
+    {
+      for (vtkIdType i = polys.Begin(c), end = polys.Begin(c + 1); i < end; ++i)
+      {
+        this->VertexCells[polys.Id(i)] = firstPoly + c;
+      }
+    }
+  });
+  return this->VertexCells;
+}
+
+bool MyVertexColorizer::Colorize(const char* arrayName, const MyColorMap& colorMap, void* colors,
+  MyColorFormat format, int component) const
+{
+  vtkDataArray* array = this->FindArray(arrayName);
+  if (!array) return false;
+
+  const MyComponentView values(array, component);
+  if (this->Poly->GetPointData()->GetArray(arrayName) == array)
+  {
+    colorMap.Map(values, colors, format);
+    return true;
+  }
+
+  const int size = MyColorFormatSize(format);
+  std::vector<uint8_t> cellColors(size * (values.GetNumberOfValues() + 1));
+  colorMap.Map(values, cellColors.data(), format);
+  const double nan = vtkMath::Nan();
+  uint8_t* nanColor = cellColors.data() + size * values.GetNumberOfValues();
+  colorMap.Map(&nan, 1, nanColor, format);
+
+  const std::vector<vtkIdType>& vertexCells = this->GetVertexCells();
+  uint8_t* out = static_cast<uint8_t*>(colors);
+  const vtkIdType numCells = values.GetNumberOfValues();
+  MyParallelFor(this->Parallel, static_cast<vtkIdType>(vertexCells.size()), [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType v = begin; v < end; ++v)
+    {
+      const vtkIdType c = vertexCells[v];
+      std::memcpy(out + size * v, c >= 0 && c < numCells ? &cellColors[size * c] : nanColor, size);
+    }
+  });
+  return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vtkDataArray.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <mutex>
+#include <vector>
+
+#include "MyColorMap.h"
+
+// Recoloring of a mesh already converted from a polydata, whose vertex i is
+// point i of the polydata, without converting its geometry again. Keeps the
+// polydata for its arrays and, once a cell array is colored, the cell each
+// vertex takes its color from: the last polygon using the point, the one the
+// cell based converters let win.
+//
+// Only the color stream is computed: a point array is mapped straight into the
+// vertex colors, a cell array is mapped once per cell and gathered per vertex,
+// both on all threads.
+class MyVertexColorizer
+{
+public:
+  explicit MyVertexColorizer(vtkPolyData* poly, bool parallel = true);
+
+  vtkPolyData* GetPolyData() const { return this->Poly; }
+  vtkIdType GetNumberOfVertices() const { return this->Poly ? this->Poly->GetNumberOfPoints() : 0; }
+
+  // the point array named arrayName, or else the cell array of that name
+  vtkDataArray* FindArray(const char* arrayName) const;
+
+  // GetNumberOfVertices() colors of MyColorFormatSize(format) bytes from
+  // component of FindArray(arrayName). Vertices used by no polygon get the NaN
+  // color when a cell array is colored. False, and colors left alone, when
+  // there is no such array.
+  bool Colorize(const char* arrayName, const MyColorMap& colorMap, void* colors, MyColorFormat format,
+    int component = 0) const;
+
+private:
+  const std::vector<vtkIdType>& GetVertexCells() const;
+
+  vtkSmartPointer<vtkPolyData> Poly;
+  bool Parallel;
+
+  mutable std::once_flag VertexCellsOnce;
+  mutable std::vector<vtkIdType> VertexCells; // -1 for vertices used by no polygon
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <vtkType.h>
+
+#include <array>
+#include <utility>
+
+#include "MyParallelFor.h"
+
+// Streams of a vertex gather, one bit each. The kernel is instantiated once
+// per combination, so what is present is decided once per call, not per vertex.
+enum MyVertexStreams : unsigned
+{
+  MyVertexRemapped = 1u << 0,     // vertex v copies point VertexPoints[v] instead of point v
+  MyVertexPointNormals = 1u << 1, // normals of the point, winning over cell normals
+  MyVertexCellNormals = 1u << 2,  // normals of VertexCells[v]
+  MyVertexPointColors = 1u << 3,  // colors of the point, winning over cell colors
+  MyVertexCellColors = 1u << 4,   // colors of VertexCells[v]
+  MyVertexPlanarUVs = 1u << 5,    // uvs projected from x and y
+  MyVertexAllStreams = (1u << 6) - 1
+};
+
+// Per point and per cell values to gather from; T for coordinates, normals
+// and uvs, ColorT for one color (FColor, a packed uint32_t, 4 floats, ...)
+template <typename T, typename ColorT>
+struct MyVertexSources
+{
+  const T* Points = nullptr;               // xyz per point
+  const vtkIdType* VertexPoints = nullptr; // point of every vertex, null for one vertex per point
+  const vtkIdType* VertexCells = nullptr;  // cell data id of every vertex, needed by cell streams
+  const T* PointNormals = nullptr;         // xyz per point
+  const T* CellNormals = nullptr;          // xyz per cell
+  const ColorT* PointColors = nullptr;
+  const ColorT* CellColors = nullptr;
+
+  // uv = ((x - UVOrigin[0]) / UVSize[0], (y - UVOrigin[1]) / UVSize[1])
+  bool PlanarUVs = false;
+  double UVOrigin[2] = { 0.0, 0.0 };
+  double UVSize[2] = { 1.0, 1.0 };
+};
+
+// Packed per vertex outputs: 3 values for positions and normals, 2 for uvs.
+// A null target is a stream nothing is written to.
+template <typename T, typename ColorT>
+struct MyVertexTargets
+{
+  T* Positions = nullptr;
+  T* Normals = nullptr;
+  ColorT* Colors = nullptr;
+  T* UVs = nullptr;
+};
+
+// Streams a gather from sources into targets fills: present on both sides,
+// point attributes in place of cell attributes, cell attributes only with VertexCells
+template <typename T, typename ColorT>
+unsigned MyGetVertexStreams(const MyVertexSources<T, ColorT>& sources, const MyVertexTargets<T, ColorT>& targets)
+{
+  unsigned streams = sources.VertexPoints ? MyVertexRemapped : 0u;
+  if (targets.Normals && sources.PointNormals) streams |= MyVertexPointNormals;
+  else if (targets.Normals && sources.CellNormals && sources.VertexCells) streams |= MyVertexCellNormals;
+  if (targets.Colors && sources.PointColors) streams |= MyVertexPointColors;
+  else if (targets.Colors && sources.CellColors && sources.VertexCells) streams |= MyVertexCellColors;
+  if (targets.UVs && sources.PlanarUVs) streams |= MyVertexPlanarUVs;
+  return streams;
+}
+
+namespace MyVertexGatherDetail
+{
+
+// Vertices [begin, end) with the streams fixed at compile time: the body has
+// no tests of what is present and writes nothing else
+template <unsigned Streams, typename T, typename ColorT>
+void Gather(const MyVertexSources<T, ColorT>& sources, const MyVertexTargets<T, ColorT>& targets,
+  vtkIdType begin, vtkIdType end)
+{
+  const T* __restrict points = sources.Points;
+  const vtkIdType* __restrict vertexPoints = sources.VertexPoints;
+  const vtkIdType* __restrict vertexCells = sources.VertexCells;
+  T* __restrict positions = targets.Positions;
+  T* __restrict normals = targets.Normals;
+  ColorT* __restrict colors = targets.Colors;
+  T* __restrict uvs = targets.UVs;
+  const double u0 = sources.UVOrigin[0], v0 = sources.UVOrigin[1];
+  const double du = sources.UVSize[0], dv = sources.UVSize[1];
+
+  for (vtkIdType v = begin; v < end; ++v)
+  {
+    vtkIdType p = v;
+    if constexpr ((Streams & MyVertexRemapped) != 0) p = vertexPoints[v];
+    vtkIdType c = 0;
+    if constexpr ((Streams & (MyVertexCellNormals | MyVertexCellColors)) != 0) c = vertexCells[v];
+
+    const T x = points[3 * p], y = points[3 * p + 1], z = points[3 * p + 2];
+    positions[3 * v] = x;
+    positions[3 * v + 1] = y;
+    positions[3 * v + 2] = z;
+
+    if constexpr ((Streams & (MyVertexPointNormals | MyVertexCellNormals)) != 0)
+    {
+      const vtkIdType n = (Streams & MyVertexPointNormals) != 0 ? p : c;
+      const T* __restrict from = (Streams & MyVertexPointNormals) != 0 ? sources.PointNormals : sources.CellNormals;
+      normals[3 * v] = from[3 * n];
+      normals[3 * v + 1] = from[3 * n + 1];
+      normals[3 * v + 2] = from[3 * n + 2];
+    }
+    if constexpr ((Streams & MyVertexPointColors) != 0) colors[v] = sources.PointColors[p];
+    else if constexpr ((Streams & MyVertexCellColors) != 0) colors[v] = sources.CellColors[c];
+    if constexpr ((Streams & MyVertexPlanarUVs) != 0)
+    {
+      uvs[2 * v] = static_cast<T>((x - u0) / du);
+      uvs[2 * v + 1] = static_cast<T>((y - v0) / dv);
+    }
+  }
+}
+
+template <typename T, typename ColorT>
+using Kernel = void (*)(const MyVertexSources<T, ColorT>&, const MyVertexTargets<T, ColorT>&, vtkIdType, vtkIdType);
+
+template <typename T, typename ColorT, unsigned... Streams>
+constexpr std::array<Kernel<T, ColorT>, sizeof...(Streams)> MakeKernels(std::integer_sequence<unsigned, Streams...>)
+{
+  return { &Gather<Streams, T, ColorT>... };
+}
+
+template <typename T, typename ColorT>
+inline constexpr auto Kernels = MakeKernels<T, ColorT>(std::make_integer_sequence<unsigned, MyVertexAllStreams + 1>());
+
+} // namespace MyVertexGatherDetail
+
+// Per vertex positions, normals, colors and uvs in one pass over the vertices,
+// in place of a loop testing every attribute at every vertex and writing
+// placeholders for the missing ones. streams picks the instantiation once;
+// MyGetVertexStreams(sources, targets) is what is available, a smaller set
+// leaves the other targets alone. Positions are always written.
+template <typename T, typename ColorT>
+void MyGatherVertices(unsigned streams, const MyVertexSources<T, ColorT>& sources,
+  const MyVertexTargets<T, ColorT>& targets, vtkIdType numVertices, bool parallel = true)
+{
+  const auto kernel = MyVertexGatherDetail::Kernels<T, ColorT>[streams & MyGetVertexStreams(sources, targets)];
+  MyParallelFor(parallel, numVertices, [&](vtkIdType begin, vtkIdType end) { kernel(sources, targets, begin, end); });
+}
+
+template <typename T, typename ColorT>
+void MyGatherVertices(const MyVertexSources<T, ColorT>& sources, const MyVertexTargets<T, ColorT>& targets,
+  vtkIdType numVertices, bool parallel = true)
+{
+  MyGatherVertices(MyVertexAllStreams, sources, targets, numVertices, parallel);
+}
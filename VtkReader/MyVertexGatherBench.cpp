@@ -0,0 +1,200 @@
+// Time of MyGatherVertices for every combination of vertex streams, the
+// kernel specialized for it against one loop testing every stream at every
+// vertex, on synthetic points and cells with vertices scattered over them.
+// Both run on one thread, the specialized kernel also on all of them. Also
+// checks that both loops give the same vertices.
+//
+// usage: MyVertexGatherBench [number of vertices ...]
+//        defaults to 1M and 10M vertices
+#include <vtkType.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "MyVertexGather.h"
+
+namespace {
+
+using Color = uint32_t;
+
+struct Inputs
+{
+  std::vector<float> Points, PointNormals, CellNormals;
+  std::vector<Color> PointColors, CellColors;
+  std::vector<vtkIdType> VertexPoints, VertexCells;
+};
+
+Inputs SyntheticInputs(vtkIdType numVertices)
+{
+  const vtkIdType numPoints = std::max<vtkIdType>(numVertices, 3);
+  const vtkIdType numCells = std::max<vtkIdType>(numVertices / 2, 1);
+  Inputs in;
+  in.Points.resize(3 * numPoints);
+  in.PointNormals.resize(3 * numPoints);
+  in.PointColors.resize(numPoints);
+  for (vtkIdType p = 0; p < numPoints; ++p)
+  {
+    in.Points[3 * p] = 0.001f * static_cast<float>(p % 1000);
+    in.Points[3 * p + 1] = 0.001f * static_cast<float>(p / 1000);
+    in.Points[3 * p + 2] = std::sin(0.01f * static_cast<float>(p));
+    in.PointNormals[3 * p + 2] = 1.0f;
+    in.PointColors[p] = static_cast<Color>(p * 2654435761u);
+  }
+  in.CellNormals.resize(3 * numCells);
+  in.CellColors.resize(numCells);
+  for (vtkIdType c = 0; c < numCells; ++c)
+  {
+    in.CellNormals[3 * c + 1] = 1.0f;
+    in.CellColors[c] = static_cast<Color>(c * 40503u);
+  }
+
+  // neighbouring vertices a third of the points apart, as far as splitting
+  // moves the copies of a point from one another
+  in.VertexPoints.resize(numVertices);
+  in.VertexCells.resize(numVertices);
+  for (vtkIdType v = 0; v < numVertices; ++v)
+  {
+    in.VertexPoints[v] = (v / 3 + (v % 3) * (numPoints / 3)) % numPoints;
+    in.VertexCells[v] = (v / 2) % numCells;
+  }
+  return in;
+}
+
+MyVertexSources<float, Color> Sources(const Inputs& in, unsigned streams)
+{
+  MyVertexSources<float, Color> sources;
+  sources.Points = in.Points.data();
+  sources.VertexPoints = (streams & MyVertexRemapped) ? in.VertexPoints.data() : nullptr;
+  sources.VertexCells = in.VertexCells.data();
+  sources.PointNormals = (streams & MyVertexPointNormals) ? in.PointNormals.data() : nullptr;
+  sources.CellNormals = (streams & MyVertexCellNormals) ? in.CellNormals.data() : nullptr;
+  sources.PointColors = (streams & MyVertexPointColors) ? in.PointColors.data() : nullptr;
+  sources.CellColors = (streams & MyVertexCellColors) ? in.CellColors.data() : nullptr;
+  sources.PlanarUVs = (streams & MyVertexPlanarUVs) != 0;
+  sources.UVSize[0] = sources.UVSize[1] = 2.0;
+  return sources;
+}
+
+// the loop the kernels replace: every stream tested at every vertex
+void GenericGather(const MyVertexSources<float, Color>& sources, const MyVertexTargets<float, Color>& targets,
+  vtkIdType numVertices)
+{
+  for (vtkIdType v = 0; v < numVertices; ++v)
+  {
+    const vtkIdType p = sources.VertexPoints ? sources.VertexPoints[v] : v;
+    const vtkIdType c = sources.VertexCells ? sources.VertexCells[v] : 0;
+    for (int k = 0; k < 3; ++k) targets.Positions[3 * v + k] = sources.Points[3 * p + k];
+    if (sources.PointNormals)
+    {
+      for (int k = 0; k < 3; ++k) targets.Normals[3 * v + k] = sources.PointNormals[3 * p + k];
+    }
+    else if (sources.CellNormals)
+    {
+      for (int k = 0; k < 3; ++k) targets.Normals[3 * v + k] = sources.CellNormals[3 * c + k];
+    }
+    if (sources.PointColors) targets.Colors[v] = sources.PointColors[p];
+    else if (sources.CellColors) targets.Colors[v] = sources.CellColors[c];
+    if (sources.PlanarUVs)
+    {
+      targets.UVs[2 * v] = static_cast<float>((sources.Points[3 * p] - sources.UVOrigin[0]) / sources.UVSize[0]);
+      targets.UVs[2 * v + 1] = static_cast<float>((sources.Points[3 * p + 1] - sources.UVOrigin[1]) / sources.UVSize[1]);
+    }
+  }
+}
+
+struct Outputs
+{
+  std::vector<float> Positions, Normals, UVs;
+  std::vector<Color> Colors;
+
+  explicit Outputs(vtkIdType numVertices)
+    : Positions(3 * numVertices), Normals(3 * numVertices), UVs(2 * numVertices), Colors(numVertices)
+  {
+  }
+
+  MyVertexTargets<float, Color> Targets()
+  {
+    return { Positions.data(), Normals.data(), Colors.data(), UVs.data() };
+  }
+
+  bool operator==(const Outputs& other) const
+  {
+    return Positions == other.Positions && Normals == other.Normals && UVs == other.UVs && Colors == other.Colors;
+  }
+};
+
+template <typename F>
+double Seconds(F&& run)
+{
+  auto begin = std::chrono::steady_clock::now();
+  run();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+double Median(std::vector<double> values)
+{
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+// which streams a combination has, one letter each
+std::string Describe(unsigned streams)
+{
+  std::string name;
+  name += (streams & MyVertexRemapped) ? 'R' : '-';
+  name += (streams & MyVertexPointNormals) ? 'N' : (streams & MyVertexCellNormals) ? 'n' : '-';
+  name += (streams & MyVertexPointColors) ? 'C' : (streams & MyVertexCellColors) ? 'c' : '-';
+  name += (streams & MyVertexPlanarUVs) ? 'U' : '-';
+  return name;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  std::vector<vtkIdType> sizes;
+  for (int i = 1; i < argc; ++i) sizes.push_back(std::stoll(argv[i]));
+  if (sizes.empty()) sizes = { 1000000, 10000000 };
+  constexpr int runs = 5;
+
+  for (vtkIdType numVertices : sizes)
+  {
+    const Inputs in = SyntheticInputs(numVertices);
+    Outputs generic(numVertices), specialized(numVertices), parallel(numVertices);
+
+    std::printf("%lld vertices, streams R=remapped N/n=point/cell normals C/c=point/cell colors U=uvs\n",
+      static_cast<long long>(numVertices));
+    std::printf("%6s %8s %12s %14s %8s %12s %10s\n", "mask", "streams", "generic(s)", "specialized(s)", "speedup",
+      "parallel(s)", "output");
+    for (unsigned streams = 0; streams <= MyVertexAllStreams; ++streams)
+    {
+      const MyVertexSources<float, Color> sources = Sources(in, streams);
+
+      // both cell and point attributes given: the point ones win, the
+      // combination is the same kernel as the one without the cell bits
+      const unsigned gathered = MyGetVertexStreams(sources, generic.Targets());
+
+      std::vector<double> genericTimes, specializedTimes, parallelTimes;
+      for (int run = 0; run < runs; ++run)
+      {
+        genericTimes.push_back(Seconds([&] { GenericGather(sources, generic.Targets(), numVertices); }));
+        specializedTimes.push_back(
+          Seconds([&] { MyGatherVertices(sources, specialized.Targets(), numVertices, false); }));
+        parallelTimes.push_back(Seconds([&] { MyGatherVertices(sources, parallel.Targets(), numVertices); }));
+      }
+
+      const double genericSeconds = Median(genericTimes);
+      const double specializedSeconds = Median(specializedTimes);
+      std::printf("%6u %8s %12.4f %14.4f %7.2fx %12.4f %10s\n", streams, Describe(gathered).c_str(), genericSeconds,
+        specializedSeconds, genericSeconds / specializedSeconds, Median(parallelTimes),
+        generic == specialized && generic == parallel ? "identical" : "DIFFERS");
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,311 @@
+#include "MyVtkCellStream.h"
+
+#include <algorithm>
+#include <iostream>
+
+bool MyVtkCellStream::Fail(std::string_view what)
+{
+  std::cerr << "MyCellStream: " << what << std::endl;
+  this->Error = true;
+  return false;
+}
+
+bool MyVtkCellStream::Open(const char* fileName, vtkIdType cellsPerChunk, const std::vector<std::string>& arrayNames)
+{
+  if (!this->File.Open(fileName))
+  {
+    std::cerr << "Error: Could not open VTK file: " << fileName << std::endl;
+    this->Error = true;
+    return false;
+  }
+  this->CellsPerChunk = std::max<vtkIdType>(cellsPerChunk, 1);
+
+  if (!this->WalkSections(arrayNames)) return false;
+  if (this->Points.empty()) return this->Fail("no POINTS section");
+
+  this->PointStamps.assign(static_cast<size_t>(this->NumberOfPoints), 0);
+  this->LocalIndex.resize(static_cast<size_t>(this->NumberOfPoints));
+  return true;
+}
+
+// Steps over a VERTICES, LINES or TRIANGLE_STRIPS section, adds its cells to numCells
+bool MyVtkCellStream::SkipCells(MyVtkTokenCursor& cursor, vtkIdType& numCells)
+{
+  vtkIdType count = 0, size = 0;
+  if (!cursor.Value(count) || !cursor.Value(size)) return this->Fail("bad cell header");
+
+  if (MyTokenIs(cursor.PeekToken(), "OFFSETS"))
+  {
+    cursor.Token();
+    cursor.Token();
+    cursor.Pos = MyFindNumericBodyEnd(cursor.Pos, cursor.End);
+    if (!MyTokenIs(cursor.Token(), "CONNECTIVITY")) return this->Fail("missing CONNECTIVITY");
+    cursor.Token();
+    count = std::max<vtkIdType>(count - 1, 0);
+  }
+  cursor.Pos = MyFindNumericBodyEnd(cursor.Pos, cursor.End);
+  numCells += count;
+  return true;
+}
+
+// Leaves CellCursor (and OffsetCursor) at the first polygon and cursor behind the section
+bool MyVtkCellStream::OpenPolygons(MyVtkTokenCursor& cursor)
+{
+  vtkIdType count = 0, size = 0;
+  if (!cursor.Value(count) || !cursor.Value(size)) return this->Fail("bad POLYGONS header");
+
+  if (MyTokenIs(cursor.PeekToken(), "OFFSETS"))
+  {
+    // 5.x layout: count offsets starting at 0, size point ids
+    cursor.Token();
+    cursor.Token();
+    this->NewLayout = true;
+    this->NumberOfPolys = std::max<vtkIdType>(count - 1, 0);
+    this->NumberOfPolyIds = size;
+    this->OffsetCursor = cursor;
+    if (!this->OffsetCursor.Value(this->PreviousOffset)) return this->Fail("truncated OFFSETS");
+
+    cursor.Pos = MyFindNumericBodyEnd(cursor.Pos, cursor.End);
+    if (!MyTokenIs(cursor.Token(), "CONNECTIVITY")) return this->Fail("missing CONNECTIVITY");
+    cursor.Token();
+  }
+  else
+  {
+    // classic layout: size counts the leading npts of every cell too
+    this->NumberOfPolys = count;
+    this->NumberOfPolyIds = size - count;
+  }
+
+  this->CellCursor = cursor;
+  cursor.Pos = MyFindNumericBodyEnd(cursor.Pos, cursor.End);
+  return true;
+}
+
+bool MyVtkCellStream::ReadLookupTable(MyVtkTokenCursor& cursor)
+{
+  std::string name(cursor.Token());
+  int numEntries = 0;
+  if (!cursor.Value(numEntries) || numEntries <= 0) return this->Fail("bad LOOKUP_TABLE");
+
+  vtkNew<vtkLookupTable> lut;
+  lut->SetNumberOfTableValues(numEntries);
+  for (int i = 0; i < numEntries; ++i)
+  {
+    double rgba[4];
+    if (!cursor.Values(rgba, 4)) return this->Fail("truncated LOOKUP_TABLE");
+    lut->SetTableValue(i, rgba);
+  }
+  this->LookupTables[name] = lut.Get();
+  return true;
+}
+
+bool MyVtkCellStream::WalkSections(const std::vector<std::string>& arrayNames)
+{
+  MyVtkTokenCursor cursor(this->File.View());
+  constexpr std::string_view magic = "# vtk DataFile Version";
+  if (cursor.RestOfLine().substr(0, magic.size()) != magic) return this->Fail("not a legacy vtk file");
+  cursor.RestOfLine(); // title
+  if (!MyTokenIs(cursor.Token(), "ASCII")) return this->Fail("only ASCII files are streamed");
+  if (!MyTokenIs(cursor.Token(), "DATASET") || !MyTokenIs(cursor.Token(), "POLYDATA"))
+  {
+    return this->Fail("dataset is not POLYDATA");
+  }
+
+  enum { NoData, PointData, CellData } association = NoData;
+  vtkIdType numTuples = 0;
+
+  // keep a requested array: point arrays are read now, cell arrays get a cursor
+  auto takeArray = [&](std::string name, int numComps, vtkIdType tuples) {
+    const size_t count = static_cast<size_t>(tuples) * numComps;
+    bool wanted = association != NoData && std::find(arrayNames.begin(), arrayNames.end(), name) != arrayNames.end();
+    if (wanted && association == PointData)
+    {
+      if (tuples != this->NumberOfPoints) return this->Fail("point array size does not match POINTS");
+      this->PointArrays.push_back({ std::move(name), numComps, std::vector<float>(count) });
+      return cursor.Values(this->PointArrays.back().Values.data(), count) || this->Fail("truncated point array");
+    }
+    if (wanted)
+    {
+      if (tuples < this->CellsBeforePolys + this->NumberOfPolys) return this->Fail("cell array shorter than the cells");
+      StreamedArray array{ std::move(name), numComps, cursor };
+      if (!array.Cursor.SkipTokens(static_cast<size_t>(this->CellsBeforePolys) * numComps))
+      {
+        return this->Fail("truncated cell array");
+      }
+      this->CellArrays.push_back(std::move(array));
+    }
+    return cursor.SkipTokens(count) || this->Fail("truncated array");
+  };
+
+  while (!cursor.AtEnd())
+  {
+    std::string_view keyword = cursor.Token();
+    bool ok = true;
+
+    if (MyTokenIs(keyword, "POINTS"))
+    {
+      ok = cursor.Value(this->NumberOfPoints) && MyVtkLegacyTypeId(cursor.Token()) != 0;
+      this->Points.resize(static_cast<size_t>(this->NumberOfPoints) * 3);
+      ok = ok && cursor.Values(this->Points.data(), this->Points.size());
+      if (!ok) return this->Fail("bad POINTS");
+    }
+    else if (MyTokenIs(keyword, "VERTICES") || MyTokenIs(keyword, "LINES") || MyTokenIs(keyword, "TRIANGLE_STRIPS"))
+    {
+      vtkIdType strips = 0;
+      ok = this->SkipCells(cursor, MyTokenIs(keyword, "TRIANGLE_STRIPS") ? strips : this->CellsBeforePolys);
+    }
+    else if (MyTokenIs(keyword, "POLYGONS"))
+    {
+      ok = this->OpenPolygons(cursor);
+    }
+    else if (MyTokenIs(keyword, "POINT_DATA") || MyTokenIs(keyword, "CELL_DATA"))
+    {
+      association = MyTokenIs(keyword, "POINT_DATA") ? PointData : CellData;
+      ok = cursor.Value(numTuples);
+    }
+    else if (MyTokenIs(keyword, "LOOKUP_TABLE")) ok = this->ReadLookupTable(cursor);
+    else if (MyTokenIs(keyword, "METADATA"))
+    {
+      cursor.RestOfLine();
+      while (cursor.Pos < cursor.End && !cursor.RestOfLine().empty()) {}
+    }
+    else if (MyTokenIs(keyword, "FIELD"))
+    {
+      cursor.Token();
+      int numArrays = 0;
+      ok = cursor.Value(numArrays);
+      for (int i = 0; ok && i < numArrays; ++i)
+      {
+        std::string name = MyDecodeVtkName(cursor.Token());
+        if (MyTokenIs(name, "NULL_ARRAY")) continue;
+        int numComps = 0;
+        vtkIdType tuples = 0;
+        ok = cursor.Value(numComps) && cursor.Value(tuples) && MyVtkLegacyTypeId(cursor.Token()) != 0 &&
+          takeArray(std::move(name), numComps, tuples);
+      }
+    }
+    else
+    {
+      // SCALARS, COLOR_SCALARS, VECTORS, NORMALS, TEXTURE_COORDINATES, TENSORS, ...
+      std::string name = MyDecodeVtkName(cursor.Token());
+      int numComps = 3;
+      if (MyTokenIs(keyword, "SCALARS"))
+      {
+        MyVtkTokenCursor line(cursor.RestOfLine());
+        line.Token();
+        numComps = 1;
+        if (!line.AtEnd()) line.Value(numComps);
+        if (MyTokenIs(cursor.PeekToken(), "LOOKUP_TABLE"))
+        {
+          cursor.Token();
+          cursor.Token();
+        }
+      }
+      else if (MyTokenIs(keyword, "COLOR_SCALARS")) ok = cursor.Value(numComps);
+      else
+      {
+        if (MyTokenIs(keyword, "TEXTURE_COORDINATES")) ok = cursor.Value(numComps);
+        else if (MyTokenIs(keyword, "TENSORS")) numComps = 9;
+        else if (MyTokenIs(keyword, "TENSORS6")) numComps = 6;
+        else if (MyTokenIs(keyword, "GLOBAL_IDS") || MyTokenIs(keyword, "PEDIGREE_IDS")) numComps = 1;
+        else if (!MyTokenIs(keyword, "VECTORS") && !MyTokenIs(keyword, "NORMALS")) return this->Fail("unsupported section");
+        ok = ok && MyVtkLegacyTypeId(cursor.Token()) != 0;
+      }
+      ok = ok && takeArray(std::move(name), numComps, numTuples);
+    }
+
+    if (!ok) return this->Error ? false : this->Fail("bad section header");
+  }
+  return true;
+}
+
+vtkIdType MyVtkCellStream::LocalPoint(vtkIdType pointId, MyMeshChunk& chunk)
+{
+  if (this->PointStamps[pointId] != this->Stamp)
+  {
+    this->PointStamps[pointId] = this->Stamp;
+    this->LocalIndex[pointId] = static_cast<vtkIdType>(chunk.PointIds.size());
+    chunk.PointIds.push_back(pointId);
+
+    const float* p = &this->Points[3 * pointId];
+    chunk.Points.insert(chunk.Points.end(), p, p + 3);
+    for (size_t a = 0; a < this->PointArrays.size(); ++a)
+    {
+      const ResidentArray& array = this->PointArrays[a];
+      const float* tuple = &array.Values[pointId * array.NumberOfComponents];
+      std::vector<float>& values = chunk.PointArrays[a].Values;
+      values.insert(values.end(), tuple, tuple + array.NumberOfComponents);
+    }
+  }
+  return this->LocalIndex[pointId];
+}
+
+bool MyVtkCellStream::Next(MyMeshChunk& chunk)
+{
+  if (this->Error || this->CellsRead >= this->NumberOfPolys) return false;
+  const vtkIdType numCells = std::min(this->CellsPerChunk, this->NumberOfPolys - this->CellsRead);
+
+  // clear() keeps the capacity of the previous chunk
+  chunk.FirstCell = this->CellsRead;
+  chunk.Offsets.clear();
+  chunk.Connectivity.clear();
+  chunk.PointIds.clear();
+  chunk.Points.clear();
+  chunk.PointArrays.resize(this->PointArrays.size());
+  for (size_t a = 0; a < this->PointArrays.size(); ++a)
+  {
+    chunk.PointArrays[a].Name = this->PointArrays[a].Name;
+    chunk.PointArrays[a].NumberOfComponents = this->PointArrays[a].NumberOfComponents;
+    chunk.PointArrays[a].Values.clear();
+  }
+
+  // a new stamp invalidates every local index of the previous chunk
+  if (++this->Stamp == 0)
+  {
+    std::fill(this->PointStamps.begin(), this->PointStamps.end(), 0u);
+    this->Stamp = 1;
+  }
+
+  chunk.Offsets.reserve(static_cast<size_t>(numCells) + 1);
+  chunk.Offsets.push_back(0);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    vtkIdType npts = 0;
+    if (this->NewLayout)
+    {
+      vtkIdType offset = 0;
+      if (!this->OffsetCursor.Value(offset) || offset < this->PreviousOffset) return this->Fail("bad OFFSETS");
+      npts = offset - this->PreviousOffset;
+      this->PreviousOffset = offset;
+    }
+    else if (!this->CellCursor.Value(npts) || npts < 0)
+    {
+      return this->Fail("bad cell size");
+    }
+
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      vtkIdType pointId = -1;
+      if (!this->CellCursor.Value(pointId) || pointId < 0 || pointId >= this->NumberOfPoints)
+      {
+        return this->Fail("point id out of range");
+      }
+      chunk.Connectivity.push_back(this->LocalPoint(pointId, chunk));
+    }
+    chunk.Offsets.push_back(static_cast<vtkIdType>(chunk.Connectivity.size()));
+  }
+
+  chunk.CellArrays.resize(this->CellArrays.size());
+  for (size_t a = 0; a < this->CellArrays.size(); ++a)
+  {
+    StreamedArray& array = this->CellArrays[a];
+    MyMeshChunkArray& out = chunk.CellArrays[a];
+    out.Name = array.Name;
+    out.NumberOfComponents = array.NumberOfComponents;
+    out.Values.resize(static_cast<size_t>(numCells) * array.NumberOfComponents);
+    if (!array.Cursor.Values(out.Values.data(), out.Values.size())) return this->Fail("truncated cell array");
+  }
+
+  this->CellsRead += numCells;
+  return true;
+}
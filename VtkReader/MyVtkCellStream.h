@@ -0,0 +1,124 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <vtkSmartPointer.h>
+#include <vtkLookupTable.h>
+
+#include "MyMappedFile.h"
+#include "MyVtkTokenCursor.h"
+
+// One POINT_DATA or CELL_DATA array restricted to the points or cells of a chunk
+struct MyMeshChunkArray
+{
+  std::string Name;
+  int NumberOfComponents = 0;
+  std::vector<float> Values;
+};
+
+// A run of consecutive polygons and the points they use, numbered locally
+struct MyMeshChunk
+{
+  vtkIdType FirstCell = 0;             // polygon index of the first cell in the file
+  std::vector<vtkIdType> Offsets;      // cells + 1 entries into Connectivity
+  std::vector<vtkIdType> Connectivity; // local point indices
+  std::vector<vtkIdType> PointIds;     // local point index -> point id in the file
+  std::vector<float> Points;           // xyz per local point
+  std::vector<MyMeshChunkArray> PointArrays; // tuples per local point
+  std::vector<MyMeshChunkArray> CellArrays;  // tuples per chunk cell
+
+  vtkIdType GetNumberOfCells() const
+  {
+    return this->Offsets.empty() ? 0 : static_cast<vtkIdType>(this->Offsets.size()) - 1;
+  }
+
+  const MyMeshChunkArray* FindPointArray(std::string_view name) const { return Find(this->PointArrays, name); }
+  const MyMeshChunkArray* FindCellArray(std::string_view name) const { return Find(this->CellArrays, name); }
+
+private:
+  static const MyMeshChunkArray* Find(const std::vector<MyMeshChunkArray>& arrays, std::string_view name)
+  {
+    for (const MyMeshChunkArray& array : arrays)
+    {
+      if (array.Name == name) return &array;
+    }
+    return nullptr;
+  }
+};
+
+// Reads the POLYGONS of a legacy ASCII polydata file a fixed number of cells
+// at a time. Points and the requested point arrays stay resident since cells
+// may reference any of them; connectivity and cell arrays are parsed chunk by
+// chunk straight out of the mapped file, so at most one chunk of cells is
+// ever materialized. VERTICES, LINES and TRIANGLE_STRIPS are stepped over.
+class MyVtkCellStream
+{
+public:
+  // arrayNames: POINT_DATA and CELL_DATA arrays to deliver with every chunk
+  bool Open(const char* fileName, vtkIdType cellsPerChunk = 1 << 20,
+    const std::vector<std::string>& arrayNames = {});
+
+  // Fill chunk with the next cells, reusing its buffers.
+  // Returns false after the last chunk or on a parse error, see Failed().
+  bool Next(MyMeshChunk& chunk);
+
+  bool Failed() const { return this->Error; }
+
+  vtkIdType GetNumberOfPoints() const { return this->NumberOfPoints; }
+  vtkIdType GetNumberOfCells() const { return this->NumberOfPolys; }
+
+  // triangles of a fan triangulation of all polygons
+  vtkIdType GetNumberOfTriangles() const { return this->NumberOfPolyIds - 2 * this->NumberOfPolys; }
+
+  const std::map<std::string, vtkSmartPointer<vtkLookupTable>>& GetLookupTables() const { return this->LookupTables; }
+
+private:
+  struct ResidentArray
+  {
+    std::string Name;
+    int NumberOfComponents = 0;
+    std::vector<float> Values;
+  };
+
+  struct StreamedArray
+  {
+    std::string Name;
+    int NumberOfComponents = 0;
+    MyVtkTokenCursor Cursor; // at the values of the next chunk's first cell
+  };
+
+  bool Fail(std::string_view what);
+  bool WalkSections(const std::vector<std::string>& arrayNames);
+  bool SkipCells(MyVtkTokenCursor& cursor, vtkIdType& numCells);
+  bool OpenPolygons(MyVtkTokenCursor& cursor);
+  bool ReadLookupTable(MyVtkTokenCursor& cursor);
+  vtkIdType LocalPoint(vtkIdType pointId, MyMeshChunk& chunk);
+
+  MyMappedFile File;
+  vtkIdType CellsPerChunk = 0;
+  bool Error = false;
+
+  vtkIdType NumberOfPoints = 0;
+  std::vector<float> Points;
+  std::vector<ResidentArray> PointArrays;
+  std::vector<StreamedArray> CellArrays;
+  std::map<std::string, vtkSmartPointer<vtkLookupTable>> LookupTables;
+
+  // cells of VERTICES and LINES come first in CELL_DATA
+  vtkIdType CellsBeforePolys = 0;
+  vtkIdType NumberOfPolys = 0;
+  vtkIdType NumberOfPolyIds = 0;
+  vtkIdType CellsRead = 0;
+  bool NewLayout = false;          // 5.x OFFSETS/CONNECTIVITY
+  MyVtkTokenCursor CellCursor;     // classic "npts ids", or CONNECTIVITY
+  MyVtkTokenCursor OffsetCursor;   // OFFSETS
+  vtkIdType PreviousOffset = 0;
+
+  // file point id -> local index of the current chunk, valid while Stamps match
+  std::vector<unsigned int> PointStamps;
+  std::vector<vtkIdType> LocalIndex;
+  unsigned int Stamp = 0;
+};
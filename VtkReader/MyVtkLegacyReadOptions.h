@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <vtkType.h>
+
+// How MyReadLegacyPolyData reads a legacy .vtk file
+struct MyVtkLegacyReadOptions
+{
+  // Parse large numeric bodies (POINTS, cells, attributes) with vtkSMPTools.
+  // The body is cut at newline boundaries, every chunk counts its values and
+  // a prefix sum over the counts places each chunk in the output arrays.
+  bool Parallel = false;
+
+  // bodies with fewer values stay on the calling thread
+  vtkIdType ParallelMinValues = 1 << 17;
+
+  // Names of the POINT_DATA, CELL_DATA and FIELD arrays to load, empty loads all.
+  // Bodies of other arrays are stepped over without converting a value.
+  std::vector<std::string> ArrayNames;
+
+  bool WantsArray(const std::string& name) const
+  {
+    if (this->ArrayNames.empty()) return true;
+    for (const std::string& arrayName : this->ArrayNames)
+    {
+      if (arrayName == name) return true;
+    }
+    return false;
+  }
+};
@@ -0,0 +1,759 @@
+#include "MyVtkLegacyReader.h"
+#include "MyByteSwap.h"
+#include "MyMappedFile.h"
+#include "MyVtkTokenCursor.h"
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkFieldData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSMPTools.h>
+#include <vtkTypeInt64Array.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+int MyVtkLegacyTypeId(std::string_view typeName)
+{
+  struct TypeName { std::string_view Name; int Id; };
+  static const TypeName types[] = {
+    { "float", VTK_FLOAT },
+    { "double", VTK_DOUBLE },
+    { "int", VTK_INT },
+    { "unsigned_int", VTK_UNSIGNED_INT },
+    { "short", VTK_SHORT },
+    { "unsigned_short", VTK_UNSIGNED_SHORT },
+    { "char", VTK_SIGNED_CHAR },
+    { "unsigned_char", VTK_UNSIGNED_CHAR },
+    { "long", VTK_LONG },
+    { "unsigned_long", VTK_UNSIGNED_LONG },
+    { "vtktypeint32", VTK_TYPE_INT32 },
+    { "vtktypeuint32", VTK_TYPE_UINT32 },
+    { "vtktypeint64", VTK_TYPE_INT64 },
+    { "vtktypeuint64", VTK_TYPE_UINT64 },
+    { "vtkidtype", VTK_ID_TYPE },
+  };
+  for (const TypeName& type : types)
+  {
+    if (MyTokenIs(typeName, type.Name)) return type.Id;
+  }
+  return 0;
+}
+
+size_t MyVtkLegacyBinarySize(int typeId)
+{
+  // vtkDataWriter writes vtkIdType arrays as 32-bit ints
+  if (typeId == VTK_ID_TYPE) return 4;
+  switch (typeId)
+  {
+    vtkTemplateMacro(return sizeof(VTK_TT));
+  }
+  return 0;
+}
+
+namespace {
+
+// [begin, end) cut into about numChunks pieces, every cut right after a newline
+std::vector<const char*> SplitAtNewlines(const char* begin, const char* end, size_t numChunks)
+{
+  std::vector<const char*> bounds{ begin };
+  const size_t bytes = static_cast<size_t>(end - begin);
+  for (size_t i = 1; i < numChunks; ++i)
+  {
+    const char* cut = begin + bytes / numChunks * i;
+    if (cut <= bounds.back()) continue;
+    const char* eol = static_cast<const char*>(std::memchr(cut, '\n', end - cut));
+    if (!eol || eol + 1 >= end) break;
+    bounds.push_back(eol + 1);
+  }
+  bounds.push_back(end);
+  return bounds;
+}
+
+size_t CountTokens(const char* p, const char* end)
+{
+  size_t count = 0;
+  bool inToken = false;
+  for (; p < end; ++p)
+  {
+    bool space = MyVtkTokenCursor::IsSpace(*p);
+    count += (!space && !inToken);
+    inToken = !space;
+  }
+  return count;
+}
+
+// Exclusive prefix sum in place, returns the total
+size_t PrefixSum(std::vector<size_t>& counts)
+{
+  size_t total = 0;
+  for (size_t& count : counts)
+  {
+    size_t n = count;
+    count = total;
+    total += n;
+  }
+  return total;
+}
+
+// Two passes over the chunks: count the values of every chunk, then
+// convert each chunk straight into its slice of out.
+template <typename T>
+bool ParallelValues(const std::vector<const char*>& bounds, T* out, size_t count)
+{
+  const vtkIdType numChunks = static_cast<vtkIdType>(bounds.size()) - 1;
+  std::vector<size_t> first(numChunks);
+  vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      first[chunk] = CountTokens(bounds[chunk], bounds[chunk + 1]);
+    }
+  });
+  if (PrefixSum(first) != count) return false;
+  first.push_back(count);
+
+  std::atomic<bool> ok{ true };
+  vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      MyVtkTokenCursor cursor(bounds[chunk], bounds[chunk + 1]);
+      if (!cursor.Values(out + first[chunk], first[chunk + 1] - first[chunk])) ok = false;
+    }
+  });
+  return ok;
+}
+
+// Classic "npts id0 id1 ..." cells, one cell per line as every VTK writer does.
+// Returns false when a chunk boundary splits a cell or the counts do not
+// match the header, the caller then parses the body sequentially.
+bool ParallelCells(const std::vector<const char*>& bounds, vtkTypeInt64* offset, vtkTypeInt64* ids,
+  vtkIdType numCells, vtkTypeInt64 connectivitySize)
+{
+  const vtkIdType numChunks = static_cast<vtkIdType>(bounds.size()) - 1;
+  std::vector<size_t> firstCell(numChunks), firstId(numChunks);
+  std::atomic<bool> ok{ true };
+  vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      MyVtkTokenCursor cursor(bounds[chunk], bounds[chunk + 1]);
+      size_t cells = 0, cellIds = 0;
+      while (!cursor.AtEnd())
+      {
+        vtkTypeInt64 npts = 0;
+        if (!cursor.Value(npts) || npts < 0 || !cursor.SkipTokens(static_cast<size_t>(npts)))
+        {
+          ok = false;
+          break;
+        }
+        ++cells;
+        cellIds += static_cast<size_t>(npts);
+      }
+      firstCell[chunk] = cells;
+      firstId[chunk] = cellIds;
+    }
+  });
+  if (!ok || PrefixSum(firstCell) != static_cast<size_t>(numCells) ||
+      PrefixSum(firstId) != static_cast<size_t>(connectivitySize))
+  {
+    return false;
+  }
+
+  offset[0] = 0;
+  vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      MyVtkTokenCursor cursor(bounds[chunk], bounds[chunk + 1]);
+      vtkTypeInt64 pos = static_cast<vtkTypeInt64>(firstId[chunk]);
+      for (size_t cellId = firstCell[chunk]; !cursor.AtEnd(); ++cellId)
+      {
+        vtkTypeInt64 npts = 0;
+        cursor.Value(npts);
+        if (!cursor.Values(ids + pos, static_cast<size_t>(npts))) ok = false;
+        pos += npts;
+        offset[cellId + 1] = pos;
+      }
+    }
+  });
+  return ok;
+}
+
+vtkSmartPointer<vtkDataArray> NewArray(int typeId, int numComps, vtkIdType numTuples, const std::string& name)
+{
+  auto array = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(typeId));
+  array->SetNumberOfComponents(numComps);
+  array->SetNumberOfTuples(numTuples);
+  if (!name.empty()) array->SetName(name.c_str());
+  return array;
+}
+
+class LegacyParser
+{
+public:
+  LegacyParser(std::string_view content, MyVtkLoadResult& result, const MyVtkLegacyReadOptions& options)
+    : Cursor(content), Result(result), Options(options)
+  {
+  }
+
+  bool Parse();
+
+private:
+  bool Fail(std::string_view what)
+  {
+    std::cerr << "MyLegacyReader: " << what << std::endl;
+    return false;
+  }
+
+  bool ParseHeader();
+  bool ReadPoints();
+  bool ReadCells(vtkSmartPointer<vtkCellArray>& cells);
+  bool ReadAttribute(std::string_view keyword);
+  bool ReadField(vtkFieldData* fieldData);
+  bool ReadLookupTable();
+  void AddAttribute(vtkDataArray* array, std::string_view keyword, bool& activeAssigned);
+
+  // checks a header's counts against the rest of the file before anything is allocated
+  bool HasBody(vtkIdType numTuples, int numComps, int typeId);
+
+  // numeric bodies, in parallel when the options ask for it and the body is large.
+  // typeId is the type named in the file, only BINARY bodies depend on it.
+  template <typename T>
+  bool ReadValues(T* out, size_t count, int typeId);
+  bool ReadArrayValues(vtkDataArray* array, size_t count, int typeId);
+  // bodies of arrays left out by Options.ArrayNames: stepped over, not converted
+  bool SkipValues(size_t count, int typeId);
+
+  // BINARY: big-endian values starting on the line after the section header
+  const char* BinaryBody(size_t count, int typeId);
+  template <typename T>
+  bool ReadBinaryValues(T* out, size_t count, int typeId);
+  bool ReadClassicCells(vtkTypeInt64* offset, vtkTypeInt64* ids, vtkIdType numCells, vtkTypeInt64 connectivitySize);
+  std::vector<const char*> ParallelChunks(size_t count);
+
+  MyVtkTokenCursor Cursor;
+  MyVtkLoadResult& Result;
+  const MyVtkLegacyReadOptions& Options;
+
+  vtkNew<vtkPolyData> Poly;
+  vtkSmartPointer<vtkCellArray> Verts, Lines, Polys, Strips;
+  vtkDataSetAttributes* Attributes = nullptr;
+  vtkIdType AttributeTuples = 0;
+  int Version[2] = { 0, 0 };
+  bool Binary = false;
+
+  // the first array of each kind becomes the active one, like vtkDataReader
+  bool HasScalars = false, HasVectors = false, HasNormals = false;
+  bool HasTCoords = false, HasTensors = false;
+};
+
+bool LegacyParser::ParseHeader()
+{
+  std::string_view line = this->Cursor.RestOfLine();
+  constexpr std::string_view magic = "# vtk DataFile Version";
+  if (line.substr(0, magic.size()) != magic) return this->Fail("not a legacy vtk file");
+
+  MyVtkTokenCursor version(line.substr(magic.size()));
+  std::string_view number = version.Token();
+  auto dot = number.find('.');
+  std::from_chars(number.data(), number.data() + number.size(), this->Version[0]);
+  if (dot != std::string_view::npos)
+  {
+    std::from_chars(number.data() + dot + 1, number.data() + number.size(), this->Version[1]);
+  }
+
+  this->Cursor.RestOfLine(); // title
+  std::string_view format = this->Cursor.Token();
+  this->Binary = MyTokenIs(format, "BINARY");
+  if (!this->Binary && !MyTokenIs(format, "ASCII")) return this->Fail("unknown file format");
+
+  if (!MyTokenIs(this->Cursor.Token(), "DATASET") || !MyTokenIs(this->Cursor.Token(), "POLYDATA"))
+  {
+    return this->Fail("dataset is not POLYDATA");
+  }
+  return true;
+}
+
+std::vector<const char*> LegacyParser::ParallelChunks(size_t count)
+{
+  if (!this->Options.Parallel || count < static_cast<size_t>(this->Options.ParallelMinValues)) return {};
+
+  const int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  if (numThreads < 2) return {};
+
+  const char* begin = this->Cursor.Pos;
+  const char* end = MyFindNumericBodyEnd(begin, this->Cursor.End);
+  // a few chunks per thread keeps them busy when lines differ in length
+  size_t numChunks = static_cast<size_t>(numThreads) * 8;
+  numChunks = std::min(numChunks, static_cast<size_t>(end - begin) / (64 * 1024) + 1);
+  if (numChunks < 2) return {};
+  return SplitAtNewlines(begin, end, numChunks);
+}
+
+bool LegacyParser::HasBody(vtkIdType numTuples, int numComps, int typeId)
+{
+  // ASCII takes at least one character per value
+  const size_t valueSize = this->Binary ? MyVtkLegacyBinarySize(typeId) : 1;
+  if (!valueSize) return this->Fail("unsupported binary type");
+  if (numTuples < 0 || numComps < 0) return this->Fail("negative count in section header");
+
+  const size_t available = static_cast<size_t>(this->Cursor.End - this->Cursor.Pos);
+  const size_t tupleSize = valueSize * static_cast<size_t>(numComps);
+  if (tupleSize && static_cast<size_t>(numTuples) > available / tupleSize)
+  {
+    return this->Fail("section header counts more data than the file holds");
+  }
+  return true;
+}
+
+const char* LegacyParser::BinaryBody(size_t count, int typeId)
+{
+  const size_t valueSize = MyVtkLegacyBinarySize(typeId);
+  this->Cursor.RestOfLine();
+  const size_t available = static_cast<size_t>(this->Cursor.End - this->Cursor.Pos);
+  if (!valueSize || count > available / valueSize)
+  {
+    this->Fail("truncated binary section");
+    return nullptr;
+  }
+  const char* data = this->Cursor.Pos;
+  this->Cursor.Pos += count * valueSize;
+  return data;
+}
+
+template <typename T>
+bool LegacyParser::ReadBinaryValues(T* out, size_t count, int typeId)
+{
+  const size_t valueSize = MyVtkLegacyBinarySize(typeId);
+  const bool floating = typeId == VTK_FLOAT || typeId == VTK_DOUBLE;
+  if (floating != std::is_floating_point_v<T>) return this->Fail("binary type does not match the array");
+
+  const char* data = this->BinaryBody(count, typeId);
+  if (!data) return false;
+
+  if (valueSize == sizeof(T))
+  {
+    // one sequential pass over the mapped pages, split across threads for large bodies
+    const bool parallel = this->Options.Parallel && count >= static_cast<size_t>(this->Options.ParallelMinValues) &&
+      vtkSMPTools::GetEstimatedNumberOfThreads() > 1;
+    if (!parallel)
+    {
+      MyCopyBigEndian(out, data, count, sizeof(T));
+      return true;
+    }
+    vtkSMPTools::For(0, static_cast<vtkIdType>(count), 1 << 16, [&](vtkIdType begin, vtkIdType end) {
+      MyCopyBigEndian(out + begin, data + begin * sizeof(T), static_cast<size_t>(end - begin), sizeof(T));
+    });
+    return true;
+  }
+  if (valueSize == 4 && !floating)
+  {
+    // 32-bit ids (vtkidtype, vtktypeint32 cells) widened to the array type
+    std::vector<vtkTypeInt32> values(count);
+    MyCopyBigEndian(values.data(), data, count, 4);
+    std::copy(values.begin(), values.end(), out);
+    return true;
+  }
+  return this->Fail("binary type does not match the array");
+}
+
+bool LegacyParser::SkipValues(size_t count, int typeId)
+{
+  if (this->Binary) return this->BinaryBody(count, typeId) != nullptr;
+  return this->Cursor.SkipTokens(count) || this->Fail("truncated array");
+}
+
+template <typename T>
+bool LegacyParser::ReadValues(T* out, size_t count, int typeId)
+{
+  if (this->Binary) return this->ReadBinaryValues(out, count, typeId);
+
+  auto bounds = this->ParallelChunks(count);
+  if (bounds.size() > 2 && ParallelValues(bounds, out, count))
+  {
+    this->Cursor.Pos = bounds.back();
+    return true;
+  }
+  return this->Cursor.Values(out, count);
+}
+
+bool LegacyParser::ReadArrayValues(vtkDataArray* array, size_t count, int typeId)
+{
+  switch (array->GetDataType())
+  {
+    vtkTemplateMacro(return this->ReadValues(static_cast<VTK_TT*>(array->GetVoidPointer(0)), count, typeId));
+  }
+  return false;
+}
+
+bool LegacyParser::ReadClassicCells(
+  vtkTypeInt64* offset, vtkTypeInt64* ids, vtkIdType numCells, vtkTypeInt64 connectivitySize)
+{
+  if (this->Binary)
+  {
+    // one block of 32-bit ints, swapped in a single pass and then split
+    std::vector<vtkTypeInt32> cells(static_cast<size_t>(numCells + connectivitySize));
+    if (!this->ReadBinaryValues(cells.data(), cells.size(), VTK_INT)) return false;
+
+    const vtkTypeInt32* p = cells.data();
+    vtkTypeInt64 pos = 0;
+    offset[0] = 0;
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      const vtkTypeInt64 npts = *p++;
+      if (npts < 0 || pos + npts > connectivitySize) return this->Fail("cell size does not match header");
+      std::copy(p, p + npts, ids + pos);
+      p += npts;
+      pos += npts;
+      offset[cellId + 1] = pos;
+    }
+    if (pos != connectivitySize) return this->Fail("cell size does not match header");
+    return true;
+  }
+
+  auto bounds = this->ParallelChunks(static_cast<size_t>(numCells) + connectivitySize);
+  if (bounds.size() > 2 && ParallelCells(bounds, offset, ids, numCells, connectivitySize))
+  {
+    this->Cursor.Pos = bounds.back();
+    return true;
+  }
+
+  vtkTypeInt64 pos = 0;
+  offset[0] = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    vtkTypeInt64 npts = 0;
+    if (!this->Cursor.Value(npts) || npts < 0 || pos + npts > connectivitySize)
+    {
+      return this->Fail("cell size does not match header");
+    }
+    if (!this->Cursor.Values(ids + pos, static_cast<size_t>(npts))) return this->Fail("truncated cells");
+    pos += npts;
+    offset[cellId + 1] = pos;
+  }
+  if (pos != connectivitySize) return this->Fail("cell size does not match header");
+  return true;
+}
+
+bool LegacyParser::ReadPoints()
+{
+  vtkIdType numPoints = 0;
+  if (!this->Cursor.Value(numPoints)) return this->Fail("bad POINTS count");
+  int typeId = MyVtkLegacyTypeId(this->Cursor.Token());
+  if (!typeId) return this->Fail("unsupported POINTS type");
+  if (!this->HasBody(numPoints, 3, typeId)) return false;
+
+  auto data = NewArray(typeId, 3, numPoints, std::string());
+  if (!this->ReadArrayValues(data, static_cast<size_t>(numPoints) * 3, typeId))
+  {
+    return this->Fail("truncated POINTS");
+  }
+
+  vtkNew<vtkPoints> points;
+  points->SetData(data);
+  this->Poly->SetPoints(points);
+  return true;
+}
+
+bool LegacyParser::ReadCells(vtkSmartPointer<vtkCellArray>& cells)
+{
+  vtkIdType numCells = 0, size = 0;
+  if (!this->Cursor.Value(numCells) || !this->Cursor.Value(size)) return this->Fail("bad cell header");
+
+  vtkNew<vtkTypeInt64Array> offsets;
+  vtkNew<vtkTypeInt64Array> connectivity;
+
+  if (MyTokenIs(this->Cursor.PeekToken(), "OFFSETS"))
+  {
+    // 5.x layout: "OFFSETS type" numCells values, "CONNECTIVITY type" size values
+    this->Cursor.Token();
+    int typeId = MyVtkLegacyTypeId(this->Cursor.Token());
+    if (!this->HasBody(numCells, 1, typeId)) return false;
+    offsets->SetNumberOfValues(numCells);
+    if (!this->ReadValues(offsets->GetPointer(0), static_cast<size_t>(numCells), typeId))
+    {
+      return this->Fail("truncated OFFSETS");
+    }
+    if (!MyTokenIs(this->Cursor.Token(), "CONNECTIVITY")) return this->Fail("missing CONNECTIVITY");
+    typeId = MyVtkLegacyTypeId(this->Cursor.Token());
+    if (!this->HasBody(size, 1, typeId)) return false;
+    connectivity->SetNumberOfValues(size);
+    if (!this->ReadValues(connectivity->GetPointer(0), static_cast<size_t>(size), typeId))
+    {
+      return this->Fail("truncated CONNECTIVITY");
+    }
+  }
+  else
+  {
+    // classic layout: every cell is "npts id0 id1 ...", size counts npts too
+    const vtkTypeInt64 connectivitySize = size - numCells;
+    if (numCells < 0 || connectivitySize < 0) return this->Fail("cell size does not match header");
+    if (!this->HasBody(size, 1, VTK_INT)) return false;
+    offsets->SetNumberOfValues(numCells + 1);
+    connectivity->SetNumberOfValues(connectivitySize);
+    if (!this->ReadClassicCells(offsets->GetPointer(0), connectivity->GetPointer(0), numCells, connectivitySize))
+    {
+      return false;
+    }
+  }
+
+  cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetData(offsets, connectivity);
+  return true;
+}
+
+void LegacyParser::AddAttribute(vtkDataArray* array, std::string_view keyword, bool& activeAssigned)
+{
+  if (activeAssigned)
+  {
+    this->Attributes->AddArray(array);
+    return;
+  }
+  activeAssigned = true;
+  if (keyword == "SCALARS") this->Attributes->SetScalars(array);
+  else if (keyword == "VECTORS") this->Attributes->SetVectors(array);
+  else if (keyword == "NORMALS") this->Attributes->SetNormals(array);
+  else if (keyword == "TEXTURE_COORDINATES") this->Attributes->SetTCoords(array);
+  else if (keyword == "TENSORS") this->Attributes->SetTensors(array);
+  else this->Attributes->AddArray(array);
+}
+
+bool LegacyParser::ReadAttribute(std::string_view keyword)
+{
+  if (!this->Attributes) return this->Fail("attribute outside POINT_DATA/CELL_DATA");
+
+  const size_t tuples = static_cast<size_t>(this->AttributeTuples);
+  std::string name = MyDecodeVtkName(this->Cursor.Token());
+
+  if (MyTokenIs(keyword, "SCALARS"))
+  {
+    // SCALARS name type [numComp] then LOOKUP_TABLE name
+    MyVtkTokenCursor line(this->Cursor.RestOfLine());
+    int typeId = MyVtkLegacyTypeId(line.Token());
+    int numComps = 1;
+    if (!line.AtEnd()) line.Value(numComps);
+    if (!typeId) return this->Fail("unsupported SCALARS type");
+
+    std::string tableName = "default";
+    if (MyTokenIs(this->Cursor.PeekToken(), "LOOKUP_TABLE"))
+    {
+      this->Cursor.Token();
+      tableName = this->Cursor.Token();
+    }
+    else if (this->Binary)
+    {
+      // the body would be read as a keyword
+      return this->Fail("SCALARS without LOOKUP_TABLE");
+    }
+    if (!this->HasBody(this->AttributeTuples, numComps, typeId)) return false;
+    if (!this->Options.WantsArray(name)) return this->SkipValues(tuples * numComps, typeId);
+    if (tableName != "default") this->Result.ScalarLookupTableNames[name] = tableName;
+
+    auto array = NewArray(typeId, numComps, this->AttributeTuples, name);
+    if (!this->ReadArrayValues(array, tuples * numComps, typeId)) return this->Fail("truncated SCALARS");
+    this->AddAttribute(array, "SCALARS", this->HasScalars);
+    return true;
+  }
+
+  if (MyTokenIs(keyword, "COLOR_SCALARS"))
+  {
+    int numComps = 0;
+    if (!this->Cursor.Value(numComps)) return this->Fail("bad COLOR_SCALARS");
+    if (!this->HasBody(this->AttributeTuples, numComps, VTK_UNSIGNED_CHAR)) return false;
+    if (!this->Options.WantsArray(name)) return this->SkipValues(tuples * numComps, VTK_UNSIGNED_CHAR);
+    vtkNew<vtkUnsignedCharArray> colors;
+    colors->SetName(name.c_str());
+    colors->SetNumberOfComponents(numComps);
+    colors->SetNumberOfTuples(this->AttributeTuples);
+    unsigned char* out = colors->GetPointer(0);
+    if (this->Binary)
+    {
+      // binary colors are stored as bytes already
+      if (!this->ReadBinaryValues(out, tuples * numComps, VTK_UNSIGNED_CHAR)) return false;
+      this->AddAttribute(colors, "SCALARS", this->HasScalars);
+      return true;
+    }
+    for (size_t i = 0; i < tuples * numComps; ++i)
+    {
+      float value = 0.0f;
+      if (!this->Cursor.Value(value)) return this->Fail("truncated COLOR_SCALARS");
+      out[i] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+    }
+    this->AddAttribute(colors, "SCALARS", this->HasScalars);
+    return true;
+  }
+
+  int numComps = 3;
+  bool* active = nullptr;
+  std::string_view kind;
+  if (MyTokenIs(keyword, "VECTORS")) { active = &this->HasVectors; kind = "VECTORS"; }
+  else if (MyTokenIs(keyword, "NORMALS")) { active = &this->HasNormals; kind = "NORMALS"; }
+  else if (MyTokenIs(keyword, "TENSORS")) { active = &this->HasTensors; kind = "TENSORS"; numComps = 9; }
+  else if (MyTokenIs(keyword, "TENSORS6")) { active = &this->HasTensors; kind = "TENSORS"; numComps = 6; }
+  else if (MyTokenIs(keyword, "TEXTURE_COORDINATES"))
+  {
+    active = &this->HasTCoords;
+    kind = "TEXTURE_COORDINATES";
+    if (!this->Cursor.Value(numComps)) return this->Fail("bad TEXTURE_COORDINATES");
+  }
+  else if (MyTokenIs(keyword, "GLOBAL_IDS") || MyTokenIs(keyword, "PEDIGREE_IDS"))
+  {
+    numComps = 1;
+  }
+  else
+  {
+    return this->Fail("unsupported attribute section");
+  }
+
+  int typeId = MyVtkLegacyTypeId(this->Cursor.Token());
+  if (!typeId) return this->Fail("unsupported attribute type");
+  if (!this->HasBody(this->AttributeTuples, numComps, typeId)) return false;
+  if (!this->Options.WantsArray(name)) return this->SkipValues(tuples * numComps, typeId);
+
+  auto array = NewArray(typeId, numComps, this->AttributeTuples, name);
+  if (!this->ReadArrayValues(array, tuples * numComps, typeId)) return this->Fail("truncated attribute");
+
+  bool unused = true;
+  this->AddAttribute(array, kind, active ? *active : unused);
+  return true;
+}
+
+bool LegacyParser::ReadField(vtkFieldData* fieldData)
+{
+  this->Cursor.Token(); // field name
+  int numArrays = 0;
+  if (!this->Cursor.Value(numArrays)) return this->Fail("bad FIELD header");
+
+  for (int i = 0; i < numArrays; ++i)
+  {
+    std::string name = MyDecodeVtkName(this->Cursor.Token());
+    if (MyTokenIs(name, "NULL_ARRAY")) continue;
+
+    int numComps = 0;
+    vtkIdType numTuples = 0;
+    if (!this->Cursor.Value(numComps) || !this->Cursor.Value(numTuples)) return this->Fail("bad FIELD array");
+    int typeId = MyVtkLegacyTypeId(this->Cursor.Token());
+    if (!typeId) return this->Fail("unsupported FIELD array type");
+    if (!this->HasBody(numTuples, numComps, typeId)) return false;
+    if (!this->Options.WantsArray(name))
+    {
+      if (!this->SkipValues(static_cast<size_t>(numTuples) * numComps, typeId)) return false;
+      continue;
+    }
+
+    auto array = NewArray(typeId, numComps, numTuples, name);
+    if (!this->ReadArrayValues(array, static_cast<size_t>(numTuples) * numComps, typeId))
+    {
+      return this->Fail("truncated FIELD array");
+    }
+    fieldData->AddArray(array);
+  }
+  return true;
+}
+
+bool LegacyParser::ReadLookupTable()
+{
+  std::string name(this->Cursor.Token());
+  int numEntries = 0;
+  if (!this->Cursor.Value(numEntries) || numEntries <= 0) return this->Fail("bad LOOKUP_TABLE");
+  if (!this->HasBody(numEntries, 4, VTK_UNSIGNED_CHAR)) return false;
+
+  vtkNew<vtkLookupTable> lut;
+  lut->SetNumberOfTableValues(numEntries);
+  if (this->Binary)
+  {
+    // 4 unsigned chars per entry
+    const char* rgba = this->BinaryBody(static_cast<size_t>(numEntries) * 4, VTK_UNSIGNED_CHAR);
+    if (!rgba) return false;
+    const auto* bytes = reinterpret_cast<const unsigned char*>(rgba);
+    for (int i = 0; i < numEntries; ++i, bytes += 4)
+    {
+      lut->SetTableValue(i, bytes[0] / 255.0, bytes[1] / 255.0, bytes[2] / 255.0, bytes[3] / 255.0);
+    }
+    this->Result.LookupTables[name] = lut.Get();
+    return true;
+  }
+  for (int i = 0; i < numEntries; ++i)
+  {
+    double rgba[4];
+    if (!this->Cursor.Values(rgba, 4)) return this->Fail("truncated LOOKUP_TABLE");
+    lut->SetTableValue(i, rgba);
+  }
+  this->Result.LookupTables[name] = lut.Get();
+  return true;
+}
+
+bool LegacyParser::Parse()
+{
+  if (!this->ParseHeader()) return false;
+
+  while (!this->Cursor.AtEnd())
+  {
+    std::string_view keyword = this->Cursor.Token();
+    bool ok = true;
+
+    if (MyTokenIs(keyword, "POINTS")) ok = this->ReadPoints();
+    else if (MyTokenIs(keyword, "VERTICES")) ok = this->ReadCells(this->Verts);
+    else if (MyTokenIs(keyword, "LINES")) ok = this->ReadCells(this->Lines);
+    else if (MyTokenIs(keyword, "POLYGONS")) ok = this->ReadCells(this->Polys);
+    else if (MyTokenIs(keyword, "TRIANGLE_STRIPS")) ok = this->ReadCells(this->Strips);
+    else if (MyTokenIs(keyword, "POINT_DATA") || MyTokenIs(keyword, "CELL_DATA"))
+    {
+      bool pointData = MyTokenIs(keyword, "POINT_DATA");
+      ok = this->Cursor.Value(this->AttributeTuples);
+      this->Attributes = pointData ? static_cast<vtkDataSetAttributes*>(this->Poly->GetPointData())
+                                   : static_cast<vtkDataSetAttributes*>(this->Poly->GetCellData());
+      this->HasScalars = this->HasVectors = this->HasNormals = this->HasTCoords = this->HasTensors = false;
+    }
+    else if (MyTokenIs(keyword, "FIELD"))
+    {
+      ok = this->ReadField(this->Attributes ? this->Attributes : this->Poly->GetFieldData());
+    }
+    else if (MyTokenIs(keyword, "LOOKUP_TABLE")) ok = this->ReadLookupTable();
+    else if (MyTokenIs(keyword, "METADATA"))
+    {
+      // informational only, runs until an empty line
+      this->Cursor.RestOfLine();
+      while (this->Cursor.Pos < this->Cursor.End && !this->Cursor.RestOfLine().empty()) {}
+    }
+    else ok = this->ReadAttribute(keyword);
+
+    if (!ok) return false;
+  }
+
+  if (!this->Poly->GetPoints()) return this->Fail("no POINTS section");
+  if (this->Verts) this->Poly->SetVerts(this->Verts);
+  if (this->Lines) this->Poly->SetLines(this->Lines);
+  if (this->Polys) this->Poly->SetPolys(this->Polys);
+  if (this->Strips) this->Poly->SetStrips(this->Strips);
+
+  this->Result.PolyData = this->Poly.Get();
+  MyAttachLookupTables(this->Result);
+  return true;
+}
+
+} // namespace
+
+bool MyReadLegacyPolyData(std::string_view content, MyVtkLoadResult& result, const MyVtkLegacyReadOptions& options)
+{
+  LegacyParser parser(content, result, options);
+  return parser.Parse();
+}
+
+bool MyReadLegacyPolyData(const char* fileName, MyVtkLoadResult& result, const MyVtkLegacyReadOptions& options)
+{
+  MyMappedFile file;
+  if (!file.Open(fileName))
+  {
+    std::cerr << "Error: Could not open VTK file: " << fileName << std::endl;
+    return false;
+  }
+  file.AdviseSequential();
+  return MyReadLegacyPolyData(file.View(), result, options);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string_view>
+
+#include "MyVtkLegacyReadOptions.h"
+#include "MyVtkLoader.h"
+
+// Legacy POLYDATA reader working on a memory mapped file. Numeric bodies of
+// POINTS, cells, POINT_DATA/CELL_DATA attributes and FIELD arrays are
+// tokenized in place and written straight into preallocated typed arrays.
+// BINARY bodies are checked against the file size, then copied out of the
+// mapping and byte swapped in one SIMD pass.
+// Returns false for content it does not handle, so callers can fall back
+// to vtkPolyDataReader.
+bool MyReadLegacyPolyData(const char* fileName, MyVtkLoadResult& result,
+  const MyVtkLegacyReadOptions& options = {});
+
+bool MyReadLegacyPolyData(std::string_view content, MyVtkLoadResult& result,
+  const MyVtkLegacyReadOptions& options = {});
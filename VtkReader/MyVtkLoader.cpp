@@ -0,0 +1,303 @@
+#include "MyVtkLoader.h"
+#include "MyVtkLegacyReader.h"
+#include "MyMappedFile.h"
+
+#include <vtkPolyDataReader.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkFieldData.h>
+
+#include <charconv>
+#include <iostream>
+#include <istream>
+#include <streambuf>
+#include <vector>
+
+namespace {
+
+bool IsSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Split one line into whitespace separated tokens without allocating strings
+std::vector<std::string_view> SplitLine(std::string_view line)
+{
+  std::vector<std::string_view> tokens;
+  size_t i = 0;
+  while (i < line.size())
+  {
+    while (i < line.size() && IsSpace(line[i])) ++i;
+    size_t begin = i;
+    while (i < line.size() && !IsSpace(line[i])) ++i;
+    if (i > begin) tokens.push_back(line.substr(begin, i - begin));
+  }
+  return tokens;
+}
+
+std::string_view LineAt(std::string_view content, size_t pos)
+{
+  size_t end = content.find('\n', pos);
+  if (end == std::string_view::npos) end = content.size();
+  return content.substr(pos, end - pos);
+}
+
+std::string_view PreviousLine(std::string_view content, size_t lineStart)
+{
+  if (lineStart == 0) return {};
+  size_t end = lineStart - 1; // '\n' of the previous line
+  size_t begin = content.rfind('\n', end == 0 ? 0 : end - 1);
+  begin = (begin == std::string_view::npos) ? 0 : begin + 1;
+  return content.substr(begin, end - begin);
+}
+
+bool IsBinaryContent(std::string_view content)
+{
+  // line 1: "# vtk DataFile Version x.x", line 2: title, line 3: ASCII | BINARY
+  size_t pos = 0;
+  for (int line = 0; line < 2 && pos != std::string_view::npos; ++line)
+  {
+    pos = content.find('\n', pos);
+    if (pos != std::string_view::npos) ++pos;
+  }
+  if (pos == std::string_view::npos) return false;
+  return LineAt(content, pos).substr(0, 6) == "BINARY";
+}
+
+// ASCII table body: 4 * numEntries floats, in any line layout
+bool ReadAsciiTable(std::string_view content, size_t pos, int numEntries, vtkLookupTable* lut)
+{
+  const char* p = content.data() + pos;
+  const char* end = content.data() + content.size();
+  for (int i = 0; i < numEntries; ++i)
+  {
+    double rgba[4];
+    for (double& c : rgba)
+    {
+      while (p < end && IsSpace(*p)) ++p;
+      auto [next, ec] = std::from_chars(p, end, c);
+      if (ec != std::errc()) return false;
+      p = next;
+    }
+    lut->SetTableValue(i, rgba);
+  }
+  return true;
+}
+
+// Binary table body: 4 * numEntries unsigned chars
+bool ReadBinaryTable(std::string_view content, size_t pos, int numEntries, vtkLookupTable* lut)
+{
+  if (pos + 4 * static_cast<size_t>(numEntries) > content.size()) return false;
+  auto data = reinterpret_cast<const unsigned char*>(content.data() + pos);
+  for (int i = 0; i < numEntries; ++i, data += 4)
+  {
+    lut->SetTableValue(i, data[0] / 255.0, data[1] / 255.0, data[2] / 255.0, data[3] / 255.0);
+  }
+  return true;
+}
+
+void AttachLookupTables(vtkDataSetAttributes* attributes, const MyVtkLoadResult& result)
+{
+  if (!attributes) return;
+  for (const auto& [arrayName, tableName] : result.ScalarLookupTableNames)
+  {
+    vtkDataArray* array = attributes->GetArray(arrayName.c_str());
+    vtkLookupTable* lut = result.FindLookupTable(tableName);
+    if (array && lut && !array->GetLookupTable())
+    {
+      array->SetLookupTable(lut);
+    }
+  }
+}
+
+// vtkPolyDataReader has no allow-list, drop what the options leave out after the read
+void RemoveUnlistedArrays(vtkFieldData* arrays, const MyVtkLegacyReadOptions& options)
+{
+  if (!arrays) return;
+  for (int i = arrays->GetNumberOfArrays() - 1; i >= 0; --i)
+  {
+    const char* name = arrays->GetArrayName(i);
+    if (!options.WantsArray(name ? name : ""))
+    {
+      arrays->RemoveArray(i);
+    }
+  }
+}
+
+// Read-only stream over memory the caller keeps alive, seekable for the
+// binary sections vtkDataReader steps over
+class MemoryStreamBuffer : public std::streambuf
+{
+public:
+  void SetContent(std::string_view content)
+  {
+    char* begin = const_cast<char*>(content.data());
+    this->setg(begin, begin, begin + content.size());
+  }
+
+protected:
+  pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode) override
+  {
+    if (!(mode & std::ios_base::in)) return pos_type(off_type(-1));
+    char* base = direction == std::ios_base::beg ? this->eback()
+      : direction == std::ios_base::cur          ? this->gptr()
+                                                 : this->egptr();
+    char* target = base + offset;
+    if (target < this->eback() || target > this->egptr()) return pos_type(off_type(-1));
+    this->setg(this->eback(), target, this->egptr());
+    return pos_type(target - this->eback());
+  }
+
+  pos_type seekpos(pos_type position, std::ios_base::openmode mode) override
+  {
+    return this->seekoff(off_type(position), std::ios_base::beg, mode);
+  }
+};
+
+// vtkPolyDataReader parsing content already in memory. ReadFromInputString
+// would copy it into a std::string and again into an istringstream; this
+// reader streams the bytes in place.
+class InPlacePolyDataReader : public vtkPolyDataReader
+{
+public:
+  static InPlacePolyDataReader* New();
+  vtkTypeMacro(InPlacePolyDataReader, vtkPolyDataReader);
+
+  // content must outlive Update(); no file name is needed
+  void SetContent(std::string_view content)
+  {
+    this->Content = content;
+    this->ReadFromInputStringOn();
+    this->Modified();
+  }
+
+  int OpenVTKFile(const char* = nullptr) override
+  {
+    if (this->IS) this->CloseVTKFile();
+    this->Buffer.SetContent(this->Content);
+    this->IS = new std::istream(&this->Buffer);
+    return 1;
+  }
+
+private:
+  std::string_view Content;
+  MemoryStreamBuffer Buffer;
+};
+
+vtkStandardNewMacro(InPlacePolyDataReader);
+
+} // namespace
+
+void MyParseLookupTables(std::string_view content, MyVtkLoadResult& result)
+{
+  const bool binary = IsBinaryContent(content);
+  constexpr std::string_view keyword = "LOOKUP_TABLE";
+
+  for (size_t pos = content.find(keyword); pos != std::string_view::npos;
+       pos = content.find(keyword, pos + keyword.size()))
+  {
+    // keywords only start a line
+    if (pos > 0 && content[pos - 1] != '\n') continue;
+
+    std::string_view line = LineAt(content, pos);
+    auto tokens = SplitLine(line);
+
+    if (tokens.size() == 2)
+    {
+      // reference from a SCALARS section: "LOOKUP_TABLE <name>"
+      auto scalars = SplitLine(PreviousLine(content, pos));
+      if (scalars.size() >= 3 && scalars[0] == "SCALARS")
+      {
+        result.ScalarLookupTableNames[std::string(scalars[1])] = std::string(tokens[1]);
+      }
+      continue;
+    }
+
+    // definition: "LOOKUP_TABLE <name> <size>"
+    int numEntries = 0;
+    if (tokens.size() != 3 ||
+        std::from_chars(tokens[2].data(), tokens[2].data() + tokens[2].size(), numEntries).ec != std::errc() ||
+        numEntries <= 0)
+    {
+      continue;
+    }
+
+    size_t bodyPos = pos + line.size() + 1;
+    vtkNew<vtkLookupTable> lut;
+    lut->SetNumberOfTableValues(numEntries);
+    bool ok = binary ? ReadBinaryTable(content, bodyPos, numEntries, lut)
+                     : ReadAsciiTable(content, bodyPos, numEntries, lut);
+    if (!ok)
+    {
+      std::cerr << "Error, lookup table " << tokens[1] << " could not parse "
+                << numEntries << " entries" << std::endl;
+      continue;
+    }
+    result.LookupTables[std::string(tokens[1])] = lut.Get();
+  }
+}
+
+void MyAttachLookupTables(MyVtkLoadResult& result)
+{
+  if (!result.PolyData) return;
+  AttachLookupTables(result.PolyData->GetPointData(), result);
+  AttachLookupTables(result.PolyData->GetCellData(), result);
+}
+
+bool MyLoadPolyDataWithLookupTables(const char* fileName, MyVtkLoadResult& result,
+  const MyVtkLegacyReadOptions& options)
+{
+  // the only disk read of this file: the fallback parses the same mapping
+  MyMappedFile file;
+  if (!file.Open(fileName))
+  {
+    std::cerr << "Error: Could not open VTK file: " << fileName << std::endl;
+    return false;
+  }
+  file.AdviseSequential();
+  const std::string_view content = file.View();
+
+  // legacy polydata, ASCII or BINARY: tables come out of the same pass
+  if (MyReadLegacyPolyData(content, result, options))
+  {
+    return true;
+  }
+  result = MyVtkLoadResult();
+
+  MyParseLookupTables(content, result);
+
+  // geometry and attributes are parsed by vtkPolyDataReader out of the mapped pages
+  vtkNew<InPlacePolyDataReader> reader;
+  reader->SetContent(content);
+  if (!options.ArrayNames.empty())
+  {
+    // listed arrays may not be the first of their kind
+    reader->ReadAllScalarsOn();
+    reader->ReadAllColorScalarsOn();
+    reader->ReadAllVectorsOn();
+    reader->ReadAllNormalsOn();
+    reader->ReadAllTensorsOn();
+    reader->ReadAllTCoordsOn();
+    reader->ReadAllFieldsOn();
+  }
+  reader->Update();
+
+  result.PolyData = reader->GetOutput();
+  if (!result.PolyData || !result.PolyData->GetPoints())
+  {
+    std::cerr << "MyLoad invalid polydata or no points: " << fileName << std::endl;
+    return false;
+  }
+
+  if (!options.ArrayNames.empty())
+  {
+    RemoveUnlistedArrays(result.PolyData->GetPointData(), options);
+    RemoveUnlistedArrays(result.PolyData->GetCellData(), options);
+    RemoveUnlistedArrays(result.PolyData->GetFieldData(), options);
+  }
+  MyAttachLookupTables(result);
+  return true;
+}
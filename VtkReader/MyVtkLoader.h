@@ -0,0 +1,42 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkLookupTable.h>
+
+#include "MyVtkLegacyReadOptions.h"
+
+// Everything a legacy .vtk file gives us from a single load:
+// the polydata and every named LOOKUP_TABLE section in the file.
+struct MyVtkLoadResult
+{
+  vtkSmartPointer<vtkPolyData> PolyData;
+
+  // "LOOKUP_TABLE <name> <size>" sections keyed by <name>
+  std::map<std::string, vtkSmartPointer<vtkLookupTable>> LookupTables;
+
+  // "SCALARS <array> ..." followed by "LOOKUP_TABLE <name>", keyed by <array>
+  std::map<std::string, std::string> ScalarLookupTableNames;
+
+  vtkLookupTable* FindLookupTable(const std::string& tableName) const
+  {
+    auto it = this->LookupTables.find(tableName);
+    return it != this->LookupTables.end() ? it->second.Get() : nullptr;
+  }
+};
+
+// Read the file from disk once and return geometry and lookup tables together.
+// Named tables are also attached to the scalar arrays that reference them.
+// Legacy polydata goes through MyReadLegacyPolyData, anything else through vtkPolyDataReader.
+bool MyLoadPolyDataWithLookupTables(const char* fileName, MyVtkLoadResult& result,
+  const MyVtkLegacyReadOptions& options = {});
+
+// Collect the LOOKUP_TABLE sections of legacy file content already in memory
+void MyParseLookupTables(std::string_view content, MyVtkLoadResult& result);
+
+// Set result.LookupTables on the arrays named in result.ScalarLookupTableNames
+void MyAttachLookupTables(MyVtkLoadResult& result);
@@ -0,0 +1,60 @@
+#include "MyVtkProbe.h"
+#include "MyMappedFile.h"
+#include "MyVtkTokenCursor.h"
+#include "MyVtkXmlTags.h"
+
+#include <iostream>
+
+namespace {
+
+bool Fail(std::string_view what)
+{
+  std::cerr << "MyProbe: " << what << std::endl;
+  return false;
+}
+
+// Legacy .vtk: the magic line, the title, ASCII or BINARY and DATASET
+bool ProbeLegacyHeader(std::string_view content, MyVtkFileInfo& info)
+{
+  MyVtkTokenCursor cursor(content);
+  constexpr std::string_view magic = "# vtk DataFile Version";
+  if (cursor.RestOfLine().substr(0, magic.size()) != magic) return Fail("not a legacy vtk file");
+  cursor.RestOfLine(); // title
+
+  std::string_view format = cursor.Token();
+  info.Binary = MyTokenIs(format, "BINARY");
+  if (!info.Binary && !MyTokenIs(format, "ASCII")) return Fail("unknown file format");
+  if (!MyTokenIs(cursor.Token(), "DATASET")) return Fail("missing DATASET");
+  info.DataSetType = std::string(cursor.Token());
+  return true;
+}
+
+} // namespace
+
+bool MyProbeVtkFileType(std::string_view content, MyVtkFileInfo& info)
+{
+  info = MyVtkFileInfo();
+  if (content.substr(0, 14) == "# vtk DataFile") return ProbeLegacyHeader(content, info);
+
+  // only the xml declaration and comments may come before the VTKFile element
+  MyXmlTag tag;
+  if (!MyNextXmlTag(content.data(), content.data() + content.size(), tag) || tag.Name != "VTKFile" || tag.Closing)
+  {
+    return Fail("neither a legacy nor an XML vtk file");
+  }
+  info.Xml = true;
+  info.DataSetType = std::string(MyXmlAttribute(tag.Attributes, "type"));
+  return true;
+}
+
+bool MyProbeVtkFileType(const char* fileName, MyVtkFileInfo& info)
+{
+  // mapped, so only the pages holding the header are read from disk
+  MyMappedFile file;
+  if (!file.Open(fileName))
+  {
+    std::cerr << "Error: Could not open VTK file: " << fileName << std::endl;
+    return false;
+  }
+  return MyProbeVtkFileType(file.View(), info);
+}
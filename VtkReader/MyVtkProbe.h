@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// What kind of legacy .vtk or XML file a file is, from its first lines only
+struct MyVtkFileInfo
+{
+  std::string DataSetType; // as written: POLYDATA, UNSTRUCTURED_GRID, ... or PolyData, ...
+  bool Xml = false;
+  bool Binary = false;     // legacy BINARY; not probed for XML files
+
+  bool IsPolyData() const { return this->DataSetType == "POLYDATA" || this->DataSetType == "PolyData"; }
+};
+
+// Only the dataset type and, for legacy files, ASCII or BINARY: the first
+// lines or the VTKFile element, the body is never touched. Cheap enough to
+// pick a loader or reject a file before reading it; the converters size
+// their buffers from the loaded cell arrays, which give exact counts.
+bool MyProbeVtkFileType(const char* fileName, MyVtkFileInfo& info);
+
+bool MyProbeVtkFileType(std::string_view content, MyVtkFileInfo& info);
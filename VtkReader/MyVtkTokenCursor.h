@@ -0,0 +1,189 @@
+#pragma once
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+// In-place tokenizer over legacy .vtk text. Tokens are views into the
+// buffer and numbers go through std::from_chars, so nothing is allocated.
+struct MyVtkTokenCursor
+{
+  const char* Pos = nullptr;
+  const char* End = nullptr;
+
+  MyVtkTokenCursor() = default;
+  MyVtkTokenCursor(const char* begin, const char* end) : Pos(begin), End(end) {}
+  explicit MyVtkTokenCursor(std::string_view content)
+    : Pos(content.data()), End(content.data() + content.size()) {}
+
+  static bool IsSpace(char c)
+  {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\v';
+  }
+
+  void SkipSpace()
+  {
+    while (this->Pos < this->End && IsSpace(*this->Pos)) ++this->Pos;
+  }
+
+  bool AtEnd()
+  {
+    this->SkipSpace();
+    return this->Pos >= this->End;
+  }
+
+  std::string_view Token()
+  {
+    this->SkipSpace();
+    const char* begin = this->Pos;
+    while (this->Pos < this->End && !IsSpace(*this->Pos)) ++this->Pos;
+    return { begin, static_cast<size_t>(this->Pos - begin) };
+  }
+
+  std::string_view PeekToken() const
+  {
+    MyVtkTokenCursor copy = *this;
+    return copy.Token();
+  }
+
+  // remainder of the current line, cursor moves to the start of the next one
+  std::string_view RestOfLine()
+  {
+    const char* begin = this->Pos;
+    const char* eol = static_cast<const char*>(std::memchr(begin, '\n', this->End - begin));
+    const char* end = eol ? eol : this->End;
+    this->Pos = eol ? eol + 1 : this->End;
+    while (end > begin && IsSpace(end[-1])) --end;
+    while (begin < end && IsSpace(*begin)) ++begin;
+    return { begin, static_cast<size_t>(end - begin) };
+  }
+
+  template <typename T>
+  bool Value(T& value)
+  {
+    this->SkipSpace();
+    if (this->Pos < this->End && *this->Pos == '+') ++this->Pos;
+    auto [next, ec] = std::from_chars(this->Pos, this->End, value);
+    if (ec == std::errc())
+    {
+      this->Pos = next;
+      return true;
+    }
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      // denormals and overflow: let strtod saturate the way the stock reader does
+      if (ec == std::errc::result_out_of_range) return this->OutOfRange(value);
+    }
+    return false;
+  }
+
+  template <typename T>
+  bool Values(T* out, size_t count)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (!this->Value(out[i])) return false;
+    }
+    return true;
+  }
+
+  // step over count tokens without converting them
+  bool SkipTokens(size_t count)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (this->Token().empty()) return false;
+    }
+    return true;
+  }
+
+private:
+  template <typename T>
+  bool OutOfRange(T& value)
+  {
+    char buffer[64];
+    const char* begin = this->Pos;
+    const char* end = begin;
+    while (end < this->End && !IsSpace(*end) && end - begin < 63) ++end;
+    std::memcpy(buffer, begin, end - begin);
+    buffer[end - begin] = '\0';
+    value = static_cast<T>(std::strtod(buffer, nullptr));
+    this->Pos = end;
+    return true;
+  }
+};
+
+// legacy keywords are case-insensitive
+inline bool MyTokenIs(std::string_view token, std::string_view keyword)
+{
+  if (token.size() != keyword.size()) return false;
+  for (size_t i = 0; i < token.size(); ++i)
+  {
+    char a = token[i], b = keyword[i];
+    if (a >= 'a' && a <= 'z') a = static_cast<char>(a - 'a' + 'A');
+    if (b >= 'a' && b <= 'z') b = static_cast<char>(b - 'a' + 'A');
+    if (a != b) return false;
+  }
+  return true;
+}
+
+// Numbers start with a digit, sign or dot, or spell nan/inf/infinity.
+// Section keywords and FIELD array names start with any other letter.
+inline bool MyIsNumberStart(const char* p, const char* end)
+{
+  char c = *p;
+  if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.') return true;
+  const char* wordEnd = p;
+  while (wordEnd < end && !MyVtkTokenCursor::IsSpace(*wordEnd)) ++wordEnd;
+  std::string_view word(p, static_cast<size_t>(wordEnd - p));
+  return MyTokenIs(word, "nan") || MyTokenIs(word, "inf") || MyTokenIs(word, "infinity");
+}
+
+// End of the ASCII numeric body starting at begin: the first line that does
+// not start with a number. Only scans line starts, nothing is converted.
+inline const char* MyFindNumericBodyEnd(const char* begin, const char* end)
+{
+  const char* line = begin;
+  while (line < end)
+  {
+    const char* p = line;
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    if (p < end && *p != '\n' && !MyIsNumberStart(p, end)) return line;
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    line = eol ? eol + 1 : end;
+  }
+  return end;
+}
+
+// names in legacy files encode special characters as %XX
+inline std::string MyDecodeVtkName(std::string_view token)
+{
+  std::string name;
+  name.reserve(token.size());
+  for (size_t i = 0; i < token.size(); ++i)
+  {
+    if (token[i] == '%' && i + 2 < token.size())
+    {
+      int code = 0;
+      auto [next, ec] = std::from_chars(token.data() + i + 1, token.data() + i + 3, code, 16);
+      if (ec == std::errc() && next == token.data() + i + 3)
+      {
+        name.push_back(static_cast<char>(code));
+        i += 2;
+        continue;
+      }
+    }
+    name.push_back(token[i]);
+  }
+  return name;
+}
+
+// legacy type names -> VTK_* type ids, 0 when unsupported
+int MyVtkLegacyTypeId(std::string_view typeName);
+
+// bytes per value of a VTK_* type in a BINARY body, 0 when unsupported
+size_t MyVtkLegacyBinarySize(int typeId);
@@ -0,0 +1,461 @@
+#include "MyVtkXmlMappedReader.h"
+#include "MyMappedFile.h"
+#include "MyParallelFor.h"
+#include "MyVtkXmlTags.h"
+
+#include <vtkAOSDataArrayTemplate.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkFieldData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkTypeInt64Array.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Mappings backing adopted arrays, keyed by the pointer handed to SetArray.
+// Never destroyed: arrays may still be freed during static destruction.
+struct MappedArrayRegistry
+{
+  std::mutex Mutex;
+  std::unordered_multimap<void*, std::shared_ptr<MyMappedFile>> Files;
+};
+
+MappedArrayRegistry& MappedArrays()
+{
+  static auto* registry = new MappedArrayRegistry;
+  return *registry;
+}
+
+// vtkAOSDataArrayTemplate free function for adopted arrays, the role CustomVtkFree
+// plays for FMemory buffers. The file is unmapped with the last of its arrays.
+void UnmapVtkArray(void* data)
+{
+  std::shared_ptr<MyMappedFile> file;
+  MappedArrayRegistry& registry = MappedArrays();
+  std::lock_guard<std::mutex> lock(registry.Mutex);
+  auto it = registry.Files.find(data);
+  if (it == registry.Files.end()) return;
+  file = std::move(it->second);
+  registry.Files.erase(it);
+}
+
+// a DataArray element that points into <AppendedData>
+struct AppendedArray
+{
+  std::string Name;
+  std::string_view Section;   // Points, PointData, CellData, FieldData, Verts, Lines, Strips, Polys
+  std::string_view Attribute; // Scalars, Normals, ... when its section marks it active
+  int TypeId = 0;
+  int NumberOfComponents = 1;
+  vtkIdType NumberOfTuples = 0;
+  vtkIdType Offset = 0;
+};
+
+class MappedXmlReader
+{
+public:
+  explicit MappedXmlReader(std::shared_ptr<MyMappedFile> file)
+    : File(std::move(file)), Begin(File->GetWritableData()), End(Begin + File->GetSize())
+  {
+  }
+
+  vtkSmartPointer<vtkPolyData> Read();
+
+private:
+  bool Fail(std::string_view what)
+  {
+    std::cerr << "MyMappedXmlReader: " << what << std::endl;
+    return false;
+  }
+
+  bool ReadHeader();
+  char* Payload(const AppendedArray& array, size_t& bytes);
+  const AppendedArray* Find(std::string_view section, std::string_view name) const;
+  vtkSmartPointer<vtkDataArray> MapArray(const AppendedArray& array);
+  vtkSmartPointer<vtkCellArray> MapCells(std::string_view section, vtkIdType numCells);
+  template <typename ArrayT>
+  vtkSmartPointer<vtkCellArray> MapCells(const AppendedArray& offsets, const AppendedArray& connectivity,
+    vtkIdType numCells);
+  template <typename T>
+  void Adopt(vtkAOSDataArrayTemplate<T>* array, char* data, vtkIdType count);
+  bool AddArrays(std::string_view section, vtkFieldData* fieldData);
+
+  std::shared_ptr<MyMappedFile> File;
+  char* Begin;
+  char* End;
+  char* Data = nullptr; // first byte after the '_' of <AppendedData>
+  size_t HeaderSize = 4;
+  bool Unsupported = false;
+
+  vtkIdType NumberOfPoints = 0;
+  vtkIdType NumberOfVerts = 0, NumberOfLines = 0, NumberOfStrips = 0, NumberOfPolys = 0;
+  std::vector<AppendedArray> Arrays;
+};
+
+bool MappedXmlReader::ReadHeader()
+{
+  constexpr std::string_view hostOrder =
+    std::endian::native == std::endian::little ? "LittleEndian" : "BigEndian";
+
+  std::string_view section, sectionAttributes;
+  int numPieces = 0;
+  MyXmlTag tag;
+  for (const char* p = this->Begin; MyNextXmlTag(p, this->End, tag); p = tag.End)
+  {
+    if (tag.Name == "VTKFile" && !tag.Closing)
+    {
+      if (MyXmlAttribute(tag.Attributes, "type") != "PolyData") return this->Fail("not a PolyData file");
+      std::string_view headerType = MyXmlAttribute(tag.Attributes, "header_type");
+      this->HeaderSize = headerType == "UInt64" ? 8 : 4;
+      if (MyXmlAttribute(tag.Attributes, "byte_order") != hostOrder ||
+          !MyXmlAttribute(tag.Attributes, "compressor").empty() ||
+          (!headerType.empty() && headerType != "UInt32" && headerType != "UInt64"))
+      {
+        return this->Unsupported = true;
+      }
+    }
+    else if (tag.Name == "Piece" && !tag.Closing)
+    {
+      if (++numPieces > 1) return this->Unsupported = true;
+      this->NumberOfPoints = MyXmlNumber<vtkIdType>(tag.Attributes, "NumberOfPoints", 0);
+      this->NumberOfVerts = MyXmlNumber<vtkIdType>(tag.Attributes, "NumberOfVerts", 0);
+      this->NumberOfLines = MyXmlNumber<vtkIdType>(tag.Attributes, "NumberOfLines", 0);
+      this->NumberOfStrips = MyXmlNumber<vtkIdType>(tag.Attributes, "NumberOfStrips", 0);
+      this->NumberOfPolys = MyXmlNumber<vtkIdType>(tag.Attributes, "NumberOfPolys", 0);
+    }
+    else if (tag.Name == "PointData" || tag.Name == "CellData" || tag.Name == "FieldData" ||
+             tag.Name == "Points" || tag.Name == "Verts" || tag.Name == "Lines" ||
+             tag.Name == "Strips" || tag.Name == "Polys")
+    {
+      const bool open = !tag.Closing && !tag.Empty;
+      section = open ? tag.Name : std::string_view();
+      sectionAttributes = open ? tag.Attributes : std::string_view();
+    }
+    else if (tag.Name == "DataArray" && !tag.Closing)
+    {
+      if (MyXmlAttribute(tag.Attributes, "format") != "appended") return this->Unsupported = true;
+
+      AppendedArray array;
+      array.Name = MyXmlAttribute(tag.Attributes, "Name");
+      array.Section = section;
+      array.TypeId = MyXmlTypeId(MyXmlAttribute(tag.Attributes, "type"));
+      array.NumberOfComponents = MyXmlNumber(tag.Attributes, "NumberOfComponents", 1);
+      array.NumberOfTuples = MyXmlNumber<vtkIdType>(tag.Attributes, "NumberOfTuples", 0);
+      array.Offset = MyXmlNumber<vtkIdType>(tag.Attributes, "offset", -1);
+      if (array.TypeId == 0 || array.TypeId == VTK_STRING || array.TypeId == VTK_BIT) return this->Unsupported = true;
+      if (array.NumberOfComponents < 1 || array.Offset < 0) return this->Fail("bad DataArray");
+
+      // <PointData Scalars="name" Normals="name" ...> marks the active attributes
+      for (std::string_view attribute : { "Scalars", "Vectors", "Normals", "Tensors", "TCoords", "GlobalIds", "PedigreeIds" })
+      {
+        if (!array.Name.empty() && MyXmlAttribute(sectionAttributes, attribute) == array.Name)
+        {
+          array.Attribute = attribute;
+          break;
+        }
+      }
+      this->Arrays.push_back(std::move(array));
+    }
+    else if (tag.Name == "AppendedData" && !tag.Closing)
+    {
+      if (MyXmlAttribute(tag.Attributes, "encoding") != "raw") return this->Unsupported = true;
+      char* marker = static_cast<char*>(std::memchr(const_cast<char*>(tag.End), '_', this->End - tag.End));
+      if (!marker) return this->Fail("no '_' before appended data");
+      this->Data = marker + 1;
+      break;
+    }
+  }
+
+  if (!this->Data) this->Unsupported = true; // inline arrays only
+  return true;
+}
+
+// an appended array is its byte count, header_type wide, then the bytes
+char* MappedXmlReader::Payload(const AppendedArray& array, size_t& bytes)
+{
+  const size_t available = static_cast<size_t>(this->End - this->Data);
+  if (static_cast<size_t>(array.Offset) > available || available - array.Offset < this->HeaderSize)
+  {
+    this->Fail("appended offset past the end of the file");
+    return nullptr;
+  }
+  char* header = this->Data + array.Offset;
+  uint64_t count = 0;
+  if (this->HeaderSize == 8)
+  {
+    std::memcpy(&count, header, 8);
+  }
+  else
+  {
+    uint32_t count32 = 0;
+    std::memcpy(&count32, header, 4);
+    count = count32;
+  }
+  if (count > available - array.Offset - this->HeaderSize)
+  {
+    this->Fail("appended array runs past the end of the file");
+    return nullptr;
+  }
+  bytes = static_cast<size_t>(count);
+  return header + this->HeaderSize;
+}
+
+const AppendedArray* MappedXmlReader::Find(std::string_view section, std::string_view name) const
+{
+  for (const AppendedArray& array : this->Arrays)
+  {
+    if (array.Section == section && array.Name == name) return &array;
+  }
+  return nullptr;
+}
+
+template <typename T>
+void MappedXmlReader::Adopt(vtkAOSDataArrayTemplate<T>* array, char* data, vtkIdType count)
+{
+  if (count == 0) return;
+  if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0)
+  {
+    // VTK and vectorized loops assume natural alignment, these bytes get copied
+    array->SetNumberOfValues(count);
+    std::memcpy(array->GetPointer(0), data, static_cast<size_t>(count) * sizeof(T));
+    return;
+  }
+
+  {
+    MappedArrayRegistry& registry = MappedArrays();
+    std::lock_guard<std::mutex> lock(registry.Mutex);
+    registry.Files.emplace(data, this->File);
+  }
+  array->SetArray(reinterpret_cast<T*>(data), count, 0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+  array->SetArrayFreeFunction(&UnmapVtkArray);
+}
+
+vtkSmartPointer<vtkDataArray> MappedXmlReader::MapArray(const AppendedArray& info)
+{
+  size_t bytes = 0;
+  char* data = this->Payload(info, bytes);
+  if (!data) return nullptr;
+
+  auto array = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(info.TypeId));
+  array->SetNumberOfComponents(info.NumberOfComponents);
+  if (!info.Name.empty()) array->SetName(info.Name.c_str());
+
+  const size_t tupleBytes = static_cast<size_t>(array->GetDataTypeSize()) * info.NumberOfComponents;
+  if (bytes != tupleBytes * static_cast<size_t>(info.NumberOfTuples))
+  {
+    this->Fail("array size does not match its tuple count");
+    return nullptr;
+  }
+
+  const vtkIdType count = info.NumberOfTuples * info.NumberOfComponents;
+  switch (info.TypeId)
+  {
+    vtkTemplateMacro(this->Adopt(vtkAOSDataArrayTemplate<VTK_TT>::FastDownCast(array), data, count));
+  }
+  return array;
+}
+
+template <typename ArrayT>
+vtkSmartPointer<vtkCellArray> MappedXmlReader::MapCells(
+  const AppendedArray& offsetsInfo, const AppendedArray& connectivityInfo, vtkIdType numCells)
+{
+  using ValueType = typename ArrayT::ValueType;
+
+  size_t connectivityBytes = 0, offsetsBytes = 0;
+  char* connectivityData = this->Payload(connectivityInfo, connectivityBytes);
+  const char* offsetsData = this->Payload(offsetsInfo, offsetsBytes);
+  if (!connectivityData || !offsetsData) return nullptr;
+
+  const size_t offsetSize = offsetsInfo.TypeId == VTK_INT ? 4 : 8;
+  if (connectivityBytes % sizeof(ValueType) != 0 || offsetsBytes != offsetSize * static_cast<size_t>(numCells))
+  {
+    this->Fail("cell arrays do not match the cell count");
+    return nullptr;
+  }
+  const vtkIdType connectivitySize = static_cast<vtkIdType>(connectivityBytes / sizeof(ValueType));
+
+  // XML stores the end of every cell, vtkCellArray wants a leading 0 too
+  vtkNew<ArrayT> offsets;
+  offsets->SetNumberOfValues(numCells + 1);
+  ValueType* out = offsets->GetPointer(0);
+  out[0] = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    vtkTypeInt64 end = 0;
+    if (offsetSize == 4)
+    {
+      vtkTypeInt32 end32 = 0;
+      std::memcpy(&end32, offsetsData + cellId * 4, 4);
+      end = end32;
+    }
+    else
+    {
+      std::memcpy(&end, offsetsData + cellId * 8, 8);
+    }
+    if (end < out[cellId] || end > connectivitySize)
+    {
+      this->Fail("cell offsets out of order");
+      return nullptr;
+    }
+    out[cellId + 1] = static_cast<ValueType>(end);
+  }
+  if (out[numCells] != connectivitySize)
+  {
+    this->Fail("cell offsets do not cover the connectivity");
+    return nullptr;
+  }
+
+  vtkNew<ArrayT> connectivity;
+  this->Adopt<ValueType>(connectivity, connectivityData, connectivitySize);
+
+  // adopted ids reach every later stage unchecked: one min/max pass per chunk
+  const ValueType* ids = connectivity->GetPointer(0);
+  std::atomic<bool> outOfRange{ false };
+  MyParallelFor(true, connectivitySize, [&](vtkIdType begin, vtkIdType end) {
+    ValueType lo = ids[begin], hi = ids[begin];
+    for (vtkIdType i = begin + 1; i < end; ++i)
+    {
+      lo = std::min(lo, ids[i]);
+      hi = std::max(hi, ids[i]);
+    }
+    if (lo < 0 || hi >= this->NumberOfPoints) outOfRange.store(true, std::memory_order_relaxed);
+  });
+  if (outOfRange.load())
+  {
+    this->Fail("cell connectivity refers to points the file does not have");
+    return nullptr;
+  }
+
+  auto cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetData(offsets, connectivity);
+  return cells;
+}
+
+vtkSmartPointer<vtkCellArray> MappedXmlReader::MapCells(std::string_view section, vtkIdType numCells)
+{
+  const AppendedArray* connectivity = this->Find(section, "connectivity");
+  const AppendedArray* offsets = this->Find(section, "offsets");
+  if (!connectivity || !offsets)
+  {
+    this->Fail("cells without connectivity or offsets");
+    return nullptr;
+  }
+  if (offsets->TypeId != VTK_INT && offsets->TypeId != VTK_TYPE_INT64)
+  {
+    this->Unsupported = true;
+    return nullptr;
+  }
+
+  // connectivity is adopted as is, so the storage type follows the file
+  if (connectivity->TypeId == VTK_TYPE_INT64) return this->MapCells<vtkTypeInt64Array>(*offsets, *connectivity, numCells);
+  if (connectivity->TypeId == VTK_INT) return this->MapCells<vtkTypeInt32Array>(*offsets, *connectivity, numCells);
+  this->Unsupported = true;
+  return nullptr;
+}
+
+bool MappedXmlReader::AddArrays(std::string_view section, vtkFieldData* fieldData)
+{
+  auto* attributes = vtkDataSetAttributes::SafeDownCast(fieldData);
+  for (AppendedArray& info : this->Arrays)
+  {
+    if (info.Section != section) continue;
+    if (section == "PointData") info.NumberOfTuples = this->NumberOfPoints;
+    else if (section == "CellData")
+    {
+      info.NumberOfTuples = this->NumberOfVerts + this->NumberOfLines + this->NumberOfStrips + this->NumberOfPolys;
+    }
+
+    vtkSmartPointer<vtkDataArray> array = this->MapArray(info);
+    if (!array) return false;
+
+    if (!attributes || info.Attribute.empty()) fieldData->AddArray(array);
+    else if (info.Attribute == "Scalars") attributes->SetScalars(array);
+    else if (info.Attribute == "Vectors") attributes->SetVectors(array);
+    else if (info.Attribute == "Normals") attributes->SetNormals(array);
+    else if (info.Attribute == "Tensors") attributes->SetTensors(array);
+    else if (info.Attribute == "TCoords") attributes->SetTCoords(array);
+    else if (info.Attribute == "GlobalIds") attributes->SetGlobalIds(array);
+    else if (info.Attribute == "PedigreeIds") attributes->SetPedigreeIds(array);
+    else fieldData->AddArray(array);
+  }
+  return true;
+}
+
+vtkSmartPointer<vtkPolyData> MappedXmlReader::Read()
+{
+  if (!this->ReadHeader() || this->Unsupported) return nullptr;
+
+  auto poly = vtkSmartPointer<vtkPolyData>::New();
+
+  AppendedArray pointsInfo;
+  for (const AppendedArray& array : this->Arrays)
+  {
+    if (array.Section == "Points") pointsInfo = array;
+  }
+  if (pointsInfo.NumberOfComponents != 3)
+  {
+    this->Fail("no Points array with 3 components");
+    return nullptr;
+  }
+  pointsInfo.NumberOfTuples = this->NumberOfPoints;
+  vtkSmartPointer<vtkDataArray> pointsData = this->MapArray(pointsInfo);
+  if (!pointsData) return nullptr;
+  vtkNew<vtkPoints> points;
+  points->SetData(pointsData);
+  poly->SetPoints(points);
+
+  struct CellSection { std::string_view Name; vtkIdType Cells; void (vtkPolyData::*Set)(vtkCellArray*); };
+  const CellSection sections[] = {
+    { "Verts", this->NumberOfVerts, &vtkPolyData::SetVerts },
+    { "Lines", this->NumberOfLines, &vtkPolyData::SetLines },
+    { "Strips", this->NumberOfStrips, &vtkPolyData::SetStrips },
+    { "Polys", this->NumberOfPolys, &vtkPolyData::SetPolys },
+  };
+  for (const CellSection& section : sections)
+  {
+    if (section.Cells == 0) continue;
+    vtkSmartPointer<vtkCellArray> cells = this->MapCells(section.Name, section.Cells);
+    if (!cells) return nullptr;
+    (poly->*section.Set)(cells);
+  }
+
+  if (!this->AddArrays("PointData", poly->GetPointData()) || !this->AddArrays("CellData", poly->GetCellData()) ||
+      !this->AddArrays("FieldData", poly->GetFieldData()))
+  {
+    return nullptr;
+  }
+  return poly;
+}
+
+} // namespace
+
+vtkSmartPointer<vtkPolyData> MyReadMappedXmlPolyData(const char* fileName)
+{
+  // copy-on-write: pages stay shared with the page cache until a filter writes to them
+  auto file = std::make_shared<MyMappedFile>();
+  if (!file->Open(fileName, true))
+  {
+    std::cerr << "Error: Could not open VTK file: " << fileName << std::endl;
+    return nullptr;
+  }
+  if (file->GetSize() == 0) return nullptr;
+
+  MappedXmlReader reader(std::move(file));
+  return reader.Read();
+}
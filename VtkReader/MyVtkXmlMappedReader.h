@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+
+// Zero-copy reader for XML PolyData (.vtp) files whose arrays all live in an
+// uncompressed raw <AppendedData> block written in host byte order.
+// The file is mapped copy-on-write and every naturally aligned array adopts
+// its mapped bytes through SetArray; the mapping goes away with the last of
+// them. Cell offsets and misaligned arrays are copied.
+// Returns nullptr for files it does not handle (compressed, base64, inline
+// data, several pieces, other byte order) and for files it finds malformed,
+// cell offsets out of order or point ids past NumberOfPoints among them, so
+// callers can fall back to vtkXMLPolyDataReader.
+vtkSmartPointer<vtkPolyData> MyReadMappedXmlPolyData(const char* fileName);
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+#include <vtkType.h>
+
+#include "MyVtkTokenCursor.h"
+
+// XML VTK files: a minimal tag walker over the header part of the file.
+// Only what the probe and the mapped reader need, no entities or CDATA.
+struct MyXmlTag
+{
+  std::string_view Name;
+  std::string_view Attributes;
+  const char* End = nullptr; // just past '>'
+  bool Closing = false;
+  bool Empty = false;        // <tag ... />
+};
+
+inline bool MyNextXmlTag(const char* p, const char* end, MyXmlTag& tag)
+{
+  while (p < end)
+  {
+    p = static_cast<const char*>(std::memchr(p, '<', end - p));
+    if (!p || p + 1 >= end) return false;
+
+    if (p[1] == '?' || p[1] == '!')
+    {
+      // declarations and comments
+      std::string_view rest(p, static_cast<size_t>(end - p));
+      size_t close = rest.substr(0, 4) == "<!--" ? rest.find("-->") : rest.find('>');
+      if (close == std::string_view::npos) return false;
+      p += close + 1;
+      continue;
+    }
+
+    const char* gt = static_cast<const char*>(std::memchr(p, '>', end - p));
+    if (!gt) return false;
+    tag.Closing = p[1] == '/';
+    const char* nameBegin = p + 1 + tag.Closing;
+    const char* nameEnd = nameBegin;
+    while (nameEnd < gt && !MyVtkTokenCursor::IsSpace(*nameEnd) && *nameEnd != '/') ++nameEnd;
+    tag.Empty = gt[-1] == '/';
+    tag.Name = { nameBegin, static_cast<size_t>(nameEnd - nameBegin) };
+    tag.Attributes = { nameEnd, static_cast<size_t>(gt - nameEnd - tag.Empty) };
+    tag.End = gt + 1;
+    return true;
+  }
+  return false;
+}
+
+inline std::string_view MyXmlAttribute(std::string_view attributes, std::string_view name)
+{
+  size_t i = 0;
+  while (i < attributes.size())
+  {
+    while (i < attributes.size() && MyVtkTokenCursor::IsSpace(attributes[i])) ++i;
+    size_t keyBegin = i;
+    while (i < attributes.size() && attributes[i] != '=' && !MyVtkTokenCursor::IsSpace(attributes[i])) ++i;
+    std::string_view key = attributes.substr(keyBegin, i - keyBegin);
+
+    size_t quote = attributes.find_first_of("\"'", i);
+    if (quote == std::string_view::npos) return {};
+    size_t close = attributes.find(attributes[quote], quote + 1);
+    if (close == std::string_view::npos) return {};
+    if (key == name) return attributes.substr(quote + 1, close - quote - 1);
+    i = close + 1;
+  }
+  return {};
+}
+
+template <typename T>
+T MyXmlNumber(std::string_view attributes, std::string_view name, T fallback)
+{
+  std::string_view text = MyXmlAttribute(attributes, name);
+  T value = fallback;
+  if (!text.empty()) std::from_chars(text.data(), text.data() + text.size(), value);
+  return value;
+}
+
+// XML type names -> VTK_* type ids, 0 when unknown
+inline int MyXmlTypeId(std::string_view typeName)
+{
+  struct TypeName { std::string_view Name; int Id; };
+  static const TypeName types[] = {
+    { "Int8", VTK_SIGNED_CHAR },
+    { "UInt8", VTK_UNSIGNED_CHAR },
+    { "Int16", VTK_SHORT },
+    { "UInt16", VTK_UNSIGNED_SHORT },
+    { "Int32", VTK_INT },
+    { "UInt32", VTK_UNSIGNED_INT },
+    { "Int64", VTK_TYPE_INT64 },
+    { "UInt64", VTK_TYPE_UINT64 },
+    { "Float32", VTK_FLOAT },
+    { "Float64", VTK_DOUBLE },
+    { "String", VTK_STRING },
+    { "Bit", VTK_BIT },
+  };
+  for (const TypeName& type : types)
+  {
+    if (typeName == type.Name) return type.Id;
+  }
+  return 0;
+}
@@ -0,0 +1,381 @@
+#include "MyWeldPoints.h"
+
+#include <vtkDataArray.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+#include "MyParallelFor.h"
+
+namespace {
+
+constexpr vtkIdType Undecided = -1;
+
+struct Entry
+{
+  uint64_t Key;
+  vtkIdType Id;
+
+  bool operator<(const Entry& other) const
+  {
+    return this->Key != other.Key ? this->Key < other.Key : this->Id < other.Id;
+  }
+};
+
+// never 0, which marks an empty slot of the table
+uint64_t Mix(uint64_t a, uint64_t b, uint64_t c)
+{
+  uint64_t h = a * 0x9E3779B185EBCA87ULL;
+  h ^= (b * 0xC2B2AE3D27D4EB4FULL << 21) | (b * 0xC2B2AE3D27D4EB4FULL >> 43);
+  h ^= (c * 0x165667B19E3779F9ULL << 42) | (c * 0x165667B19E3779F9ULL >> 22);
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return h | 1;
+}
+
+bool IsFinite(const double* p)
+{
+  return std::isfinite(p[0]) && std::isfinite(p[1]) && std::isfinite(p[2]);
+}
+
+uint64_t Bits(double x)
+{
+  x += 0.0; // -0.0 and 0.0 are the same point
+  uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+// Uniform grid of cells twice the tolerance wide, so the box of radius
+// tolerance around a point touches at most two cells per axis. With a zero
+// tolerance a "cell" is one exact coordinate triple. Points with a NaN or
+// infinite coordinate are within tolerance of nothing; with a tolerance they
+// stay off the grid, all in one cell of their own that no search visits.
+class SpatialHash
+{
+public:
+  SpatialHash(const double* xyz, vtkIdType numberOfPoints, double tolerance, bool parallel)
+    : Xyz(xyz)
+    , Tolerance(tolerance)
+  {
+    if (tolerance > 0.0)
+    {
+      this->ComputeOrigin(numberOfPoints, parallel);
+    }
+
+    this->Entries.resize(numberOfPoints);
+    MyParallelFor(parallel, numberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i) this->Entries[i] = { this->KeyOf(xyz + 3 * i), i };
+    });
+    if (parallel)
+    {
+      vtkSMPTools::Sort(this->Entries.begin(), this->Entries.end());
+    }
+    else
+    {
+      std::sort(this->Entries.begin(), this->Entries.end());
+    }
+
+    // one slot per occupied cell, pointing at its run of entries
+    std::atomic<vtkIdType> numCells{ 0 };
+    MyParallelFor(parallel, numberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdType starts = 0;
+      for (vtkIdType e = begin; e < end; ++e) starts += this->IsRunStart(e);
+      numCells.fetch_add(starts, std::memory_order_relaxed);
+    });
+    size_t capacity = 16;
+    while (capacity < 2 * static_cast<size_t>(numCells.load())) capacity *= 2;
+    this->Mask = capacity - 1;
+    this->SlotKeys = std::vector<std::atomic<uint64_t>>(capacity);
+    this->SlotBegins.resize(capacity);
+    MyParallelFor(parallel, numberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType e = begin; e < end; ++e)
+      {
+        if (!this->IsRunStart(e)) continue;
+        const uint64_t key = this->Entries[e].Key;
+        for (size_t slot = key & this->Mask;; slot = (slot + 1) & this->Mask)
+        {
+          uint64_t empty = 0;
+          if (this->SlotKeys[slot].compare_exchange_strong(empty, key, std::memory_order_relaxed))
+          {
+            this->SlotBegins[slot] = e;
+            break;
+          }
+        }
+      }
+    });
+  }
+
+  // Calls visit(j) for every point j < i whose cell may hold a point within
+  // tolerance of point i; j ascends within a cell, not across cells.
+  template <typename F>
+  void ForEachEarlierCandidate(vtkIdType i, F&& visit) const
+  {
+    const double* p = this->Xyz + 3 * i;
+    if (this->Tolerance <= 0.0)
+    {
+      this->ForEachInCell(Mix(Bits(p[0]), Bits(p[1]), Bits(p[2])), i, visit);
+      return;
+    }
+    if (!IsFinite(p)) return;
+
+    int64_t lo[3], hi[3];
+    for (int a = 0; a < 3; ++a)
+    {
+      lo[a] = this->CellOf(p[a] - this->Tolerance, a);
+      hi[a] = this->CellOf(p[a] + this->Tolerance, a);
+    }
+    for (int64_t z = lo[2]; z <= hi[2]; ++z)
+      for (int64_t y = lo[1]; y <= hi[1]; ++y)
+        for (int64_t x = lo[0]; x <= hi[0]; ++x)
+          this->ForEachInCell(Mix(x, y, z), i, visit);
+  }
+
+private:
+  void ComputeOrigin(vtkIdType numberOfPoints, bool parallel)
+  {
+    const vtkIdType numBlocks = (numberOfPoints + MyParallelGrain - 1) / MyParallelGrain;
+    std::vector<double> blockMin(3 * numBlocks, std::numeric_limits<double>::max());
+    std::vector<double> blockMax(3 * numBlocks, std::numeric_limits<double>::lowest());
+    MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType b = begin; b < end; ++b)
+      {
+        for (vtkIdType i = b * MyParallelGrain, last = std::min(numberOfPoints, i + MyParallelGrain); i < last; ++i)
+        {
+          if (!IsFinite(this->Xyz + 3 * i)) continue;
+          for (int a = 0; a < 3; ++a)
+          {
+            blockMin[3 * b + a] = std::min(blockMin[3 * b + a], this->Xyz[3 * i + a]);
+            blockMax[3 * b + a] = std::max(blockMax[3 * b + a], this->Xyz[3 * i + a]);
+          }
+        }
+      }
+    }, 1);
+
+    double extent = 0.0;
+    for (int a = 0; a < 3; ++a)
+    {
+      double lo = std::numeric_limits<double>::max(), hi = std::numeric_limits<double>::lowest();
+      for (vtkIdType b = 0; b < numBlocks; ++b)
+      {
+        lo = std::min(lo, blockMin[3 * b + a]);
+        hi = std::max(hi, blockMax[3 * b + a]);
+      }
+      this->Origin[a] = lo;
+      extent = std::max(extent, hi - lo);
+    }
+    this->InverseCellSize = 1.0 / (2.0 * this->Tolerance);
+
+    // a tolerance below double precision of the extent merges equal points only
+    if (!(extent * this->InverseCellSize < 0x1p60)) this->Tolerance = 0.0;
+  }
+
+  int64_t CellOf(double x, int axis) const
+  {
+    return static_cast<int64_t>(std::floor((x - this->Origin[axis]) * this->InverseCellSize));
+  }
+
+  uint64_t KeyOf(const double* p) const
+  {
+    if (this->Tolerance <= 0.0) return Mix(Bits(p[0]), Bits(p[1]), Bits(p[2]));
+    if (!IsFinite(p)) return OffGridKey;
+    return Mix(this->CellOf(p[0], 0), this->CellOf(p[1], 1), this->CellOf(p[2], 2));
+  }
+
+  bool IsRunStart(vtkIdType e) const
+  {
+    return e == 0 || this->Entries[e - 1].Key != this->Entries[e].Key;
+  }
+
+  template <typename F>
+  void ForEachInCell(uint64_t key, vtkIdType i, F& visit) const
+  {
+    for (size_t slot = key & this->Mask;; slot = (slot + 1) & this->Mask)
+    {
+      const uint64_t slotKey = this->SlotKeys[slot].load(std::memory_order_relaxed);
+      if (slotKey == 0) return;
+      if (slotKey != key) continue;
+      for (size_t e = this->SlotBegins[slot]; e < this->Entries.size() && this->Entries[e].Key == key; ++e)
+      {
+        if (this->Entries[e].Id >= i) return;
+        visit(this->Entries[e].Id);
+      }
+      return;
+    }
+  }
+
+  // a finite point's cell can hash to it too; those cells then share a run
+  // with the non-finite points, which near() rejects
+  static constexpr uint64_t OffGridKey = 1;
+
+  const double* Xyz;
+  double Tolerance;
+  double Origin[3] = { 0.0, 0.0, 0.0 };
+  double InverseCellSize = 0.0;
+  std::vector<Entry> Entries; // sorted by cell, then id
+  std::vector<std::atomic<uint64_t>> SlotKeys;
+  std::vector<vtkIdType> SlotBegins;
+  size_t Mask = 0;
+};
+
+} // namespace
+
+vtkIdType MyComputeWeldMap(const double* xyz, vtkIdType numberOfPoints, const MyWeldPointsOptions& options,
+  std::vector<vtkIdType>& pointMap, std::vector<vtkIdType>* representatives)
+{
+  const bool parallel = options.Parallel;
+  const double tolerance = std::max(options.Tolerance, 0.0);
+  const double tolerance2 = tolerance * tolerance;
+  const SpatialHash hash(xyz, numberOfPoints, tolerance, parallel);
+
+  auto near = [&](vtkIdType i, vtkIdType j) {
+    const double* p = xyz + 3 * i;
+    const double* q = xyz + 3 * j;
+    if (tolerance <= 0.0) return p[0] == q[0] && p[1] == q[1] && p[2] == q[2];
+    const double dx = p[0] - q[0], dy = p[1] - q[1], dz = p[2] - q[2];
+    return dx * dx + dy * dy + dz * dz <= tolerance2;
+  };
+
+  // The sequential rule needs the fate of every earlier neighbour, so points
+  // are decided in rounds: a point waits while its lowest earlier undecided
+  // neighbour could still become a lower representative than the ones known.
+  // The lowest pending point always decides and on real meshes a few rounds
+  // settle nearly everything, but a chain of points spaced just under the
+  // tolerance settles one point per round. So the rounds stop after
+  // MaxParallelRounds and a serial sweep in id order, where every earlier
+  // neighbour is decided, finishes the rest. Decisions only read the previous
+  // round.
+  constexpr int MaxParallelRounds = 4;
+  std::vector<vtkIdType> representative(numberOfPoints, Undecided);
+  std::vector<vtkIdType> pending(numberOfPoints);
+  std::iota(pending.begin(), pending.end(), vtkIdType(0));
+  std::vector<vtkIdType> decision;
+  auto decide = [&](vtkIdType i) {
+    vtkIdType lowestRepresentative = i, lowestUndecided = i;
+    hash.ForEachEarlierCandidate(i, [&](vtkIdType j) {
+      if (!near(i, j)) return;
+      const vtkIdType r = representative[j];
+      if (r == Undecided)
+      {
+        lowestUndecided = std::min(lowestUndecided, j);
+      }
+      else if (r == j)
+      {
+        lowestRepresentative = std::min(lowestRepresentative, j);
+      }
+    });
+    return lowestUndecided < lowestRepresentative ? Undecided : lowestRepresentative;
+  };
+  for (int round = 0; round < MaxParallelRounds && !pending.empty(); ++round)
+  {
+    const vtkIdType numPending = static_cast<vtkIdType>(pending.size());
+    decision.resize(numPending);
+    MyParallelFor(parallel, numPending, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType k = begin; k < end; ++k) decision[k] = decide(pending[k]);
+    });
+    MyParallelFor(parallel, numPending, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType k = begin; k < end; ++k) representative[pending[k]] = decision[k];
+    });
+
+    vtkIdType kept = 0;
+    for (vtkIdType k = 0; k < numPending; ++k)
+    {
+      if (decision[k] == Undecided) pending[kept++] = pending[k];
+    }
+    pending.resize(kept);
+  }
+  // pending stays in id order, so every earlier neighbour is decided here
+  for (vtkIdType i : pending) representative[i] = decide(i);
+
+  // new ids in order of the representatives: count per block, scan, fill
+  const vtkIdType numBlocks = (numberOfPoints + MyParallelGrain - 1) / MyParallelGrain;
+  std::vector<vtkIdType> firstNewId(numBlocks + 1, 0);
+  MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      vtkIdType count = 0;
+      for (vtkIdType i = b * MyParallelGrain, last = std::min(numberOfPoints, i + MyParallelGrain); i < last; ++i)
+      {
+        count += representative[i] == i;
+      }
+      firstNewId[b + 1] = count;
+    }
+  }, 1);
+  std::partial_sum(firstNewId.begin(), firstNewId.end(), firstNewId.begin());
+  const vtkIdType numGroups = firstNewId[numBlocks];
+
+  pointMap.resize(numberOfPoints);
+  if (representatives) representatives->resize(numGroups);
+  MyParallelFor(parallel, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      vtkIdType newId = firstNewId[b];
+      for (vtkIdType i = b * MyParallelGrain, last = std::min(numberOfPoints, i + MyParallelGrain); i < last; ++i)
+      {
+        if (representative[i] != i) continue;
+        pointMap[i] = newId;
+        if (representatives) (*representatives)[newId] = i;
+        ++newId;
+      }
+    }
+  }, 1);
+  // representatives precede their members, so their new ids are all set
+  MyParallelFor(parallel, numberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (representative[i] != i) pointMap[i] = pointMap[representative[i]];
+    }
+  });
+  return numGroups;
+}
+
+MyWeldPointsResult MyWeldPoints(vtkPoints* points, vtkPointData* pointData, const MyWeldPointsOptions& options)
+{
+  MyWeldPointsResult result;
+  result.Points = vtkSmartPointer<vtkPoints>::New();
+  result.PointData = vtkSmartPointer<vtkPointData>::New();
+  if (!points) return result;
+
+  const vtkIdType numPoints = points->GetNumberOfPoints();
+  std::vector<double> xyz(3 * numPoints);
+  vtkDataArray* coords = points->GetData();
+  MyParallelFor(options.Parallel, numPoints, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) coords->GetTuple(i, xyz.data() + 3 * i);
+  });
+
+  std::vector<vtkIdType> representatives;
+  const vtkIdType numGroups = MyComputeWeldMap(xyz.data(), numPoints, options, result.PointMap, &representatives);
+
+  // coordinates and attributes of the representatives, in the input precision
+  result.Points->SetDataType(points->GetDataType());
+  result.Points->SetNumberOfPoints(numGroups);
+  vtkDataArray* outCoords = result.Points->GetData();
+  vtkNew<vtkIdList> fromIds, toIds;
+  fromIds->SetNumberOfIds(numGroups);
+  toIds->SetNumberOfIds(numGroups);
+  MyParallelFor(options.Parallel, numGroups, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType g = begin; g < end; ++g)
+    {
+      outCoords->SetTuple(g, xyz.data() + 3 * representatives[g]);
+      fromIds->SetId(g, representatives[g]);
+      toIds->SetId(g, g);
+    }
+  });
+
+  if (pointData)
+  {
+    result.PointData->CopyAllocate(pointData, numGroups);
+    result.PointData->CopyData(pointData, fromIds, toIds);
+  }
+  return result;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+
+#include <vector>
+
+struct MyWeldPointsOptions
+{
+  // absolute distance at or below which points merge; 0 merges equal coordinates only
+  double Tolerance = 0.0;
+
+  // hash, search and compact with vtkSMPTools
+  bool Parallel = true;
+};
+
+struct MyWeldPointsResult
+{
+  // old point id -> new point id
+  std::vector<vtkIdType> PointMap;
+
+  // one point per group, with the coordinates and attributes of its representative
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkPointData> PointData;
+};
+
+// Point merging on a spatial hash, the vtkCleanPolyData step without its
+// point locator. Points are visited in id order: a point within tolerance of
+// an earlier representative joins the lowest such representative, otherwise
+// it becomes one. New ids follow the order of the representatives. A point
+// with a NaN coordinate, or with an infinite one under a tolerance, merges
+// with nothing.
+//
+// xyz holds numberOfPoints packed triples. Fills pointMap and returns the
+// number of groups; representatives, if given, receives the old id of every group.
+vtkIdType MyComputeWeldMap(const double* xyz, vtkIdType numberOfPoints, const MyWeldPointsOptions& options,
+  std::vector<vtkIdType>& pointMap, std::vector<vtkIdType>* representatives = nullptr);
+
+// Welds points and compacts pointData (may be null) to the merged points
+MyWeldPointsResult MyWeldPoints(vtkPoints* points, vtkPointData* pointData, const MyWeldPointsOptions& options = {});
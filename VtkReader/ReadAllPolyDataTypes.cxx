@@ -22,6 +22,8 @@
 #include <random>
 #include <string>
 
+#include "MyVtkXmlMappedReader.h"
+
 namespace {
 vtkSmartPointer<vtkPolyData> ReadPolyData(const char* fileName);
 }
@@ -105,10 +107,15 @@ vtkSmartPointer<vtkPolyData> ReadPolyData(const char* fileName)
   }
   else if (extension == ".vtp")
   {
-    vtkNew<vtkXMLPolyDataReader> reader;
-    reader->SetFileName(fileName);
-    reader->Update();
-    polyData = reader->GetOutput();
+    // raw appended arrays are mapped in place, anything else goes to the XML reader
+    polyData = MyReadMappedXmlPolyData(fileName);
+    if (!polyData)
+    {
+      vtkNew<vtkXMLPolyDataReader> reader;
+      reader->SetFileName(fileName);
+      reader->Update();
+      polyData = reader->GetOutput();
+    }
   }
   else if (extension == ".obj")
   {
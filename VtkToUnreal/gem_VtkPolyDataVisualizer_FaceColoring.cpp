@@ -79,8 +79,11 @@ private:
         TArray<int32>& OutEdgeIndices // Stores pairs of indices for edges
     );
 
-    // Helper to parse the lookup table from the VTK file content string
-    TArray<FLinearColor> ParseLookupTable(const FString& VtkFileContent, const FString& TableName, int32 ExpectedEntries);
+    // Lookup tables read together with the polydata, keyed by table name
+    TMap<FString, TArray<FLinearColor>> LoadedLookupTables;
+
+    // Helper to convert a VTK lookup table into Unreal colors
+    static TArray<FLinearColor> ToLinearColors(vtkLookupTable* Lut);
 };
 
 ```cpp
@@ -92,6 +95,8 @@ private:
 
 // VTK Includes (ensure these are correctly linked in your Build.cs)
 #include "vtkPolyDataReader.h"
+#include "MyVtkLoader.h" // Single-pass load of polydata and its LOOKUP_TABLEs
+#include "MyEdgeOverlay.h" // Parallel unique edges and their ribbon quads
 #include "vtkTessellatorFilter.h"
 #include "vtkPolyData.h" // Now explicitly needed for SafeDownCast
 #include "vtkPoints.h"
@@ -162,15 +167,18 @@ void AVtkPolyDataVisualizer::LoadAndVisualizeVtkData()
 
     // --- VTK Pipeline Execution ---
 
-    // Create a VTK PolyData reader
-    vtkNew<vtkPolyDataReader> reader;
-    // Set the file name (VTK expects UTF8 encoding for file paths)
-    reader->SetFileName(TCHAR_TO_UTF8(*FullPath)); 
-    // Execute the reader to load the data
-    reader->Update();
+    // Read the file once: polydata and every embedded lookup table
+    // (VTK expects UTF8 encoding for file paths)
+    MyVtkLoadResult Loaded;
+    MyLoadPolyDataWithLookupTables(TCHAR_TO_UTF8(*FullPath), Loaded);
+
+    LoadedLookupTables.Empty();
+    for (const auto& [TableName, Lut] : Loaded.LookupTables)
+    {
+        LoadedLookupTables.Add(UTF8_TO_TCHAR(TableName.c_str()), ToLinearColors(Lut));
+    }
 
-    // Get the output polydata from the reader
-    vtkSmartPointer<vtkPolyData> polyData = reader->GetOutput();
+    vtkSmartPointer<vtkPolyData> polyData = Loaded.PolyData;
     if (!polyData || polyData->GetNumberOfPoints() == 0)
     {
         UE_LOG(LogTemp, Error, TEXT("Failed to read VTK PolyData or it's empty from file: %s"), *FullPath);
@@ -282,48 +290,15 @@ void AVtkPolyDataVisualizer::LoadAndVisualizeVtkData()
         float ActualEdgeThickness = LineWidth * 0.005f; 
         if (ActualEdgeThickness < KINDA_SMALL_NUMBER) ActualEdgeThickness = 0.01f; // Minimum thickness
 
-        for (int32 i = 0; i < EdgeIndices.Num(); i += 2)
-        {
-            FVector StartVert = Vertices[EdgeIndices[i]];
-            FVector EndVert = Vertices[EdgeIndices[i+1]];
-
-            FVector LineDir = (EndVert - StartVert).GetSafeNormal();
-            // Find a perpendicular vector for offsetting the line to create a quad
-            FVector Perpendicular = FVector::CrossProduct(LineDir, FVector::UpVector).GetSafeNormal();
-            if (Perpendicular.IsNearlyZero()) // If line is vertical, cross with RightVector
-            {
-                Perpendicular = FVector::CrossProduct(LineDir, FVector::RightVector).GetSafeNormal();
-            }
-
-            FVector Offset = Perpendicular * ActualEdgeThickness * 0.5f;
-
-            // Add 4 vertices for the quad representing the line segment
-            int32 BaseIndex = EdgeLineVertices.Num();
-            EdgeLineVertices.Add(StartVert - Offset); // Bottom-left
-            EdgeLineVertices.Add(StartVert + Offset); // Top-left
-            EdgeLineVertices.Add(EndVert + Offset);   // Top-right
-            EdgeLineVertices.Add(EndVert - Offset);   // Bottom-right
-
-            // Add 2 triangles to form the quad
-            EdgeLineIndices.Add(BaseIndex + 0); EdgeLineIndices.Add(BaseIndex + 1); EdgeLineIndices.Add(BaseIndex + 2);
-            EdgeLineIndices.Add(BaseIndex + 0); EdgeLineIndices.Add(BaseIndex + 2); EdgeLineIndices.Add(BaseIndex + 3);
-
-            // Add normals (flat for the quad) and colors
-            FVector QuadNormal = FVector::CrossProduct(
-                EdgeLineVertices[BaseIndex+1] - EdgeLineVertices[BaseIndex], 
-                EdgeLineVertices[BaseIndex+3] - EdgeLineVertices[BaseIndex]
-            ).GetSafeNormal();
-
-            EdgeLineNormals.Add(QuadNormal);
-            EdgeLineNormals.Add(QuadNormal);
-            EdgeLineNormals.Add(QuadNormal);
-            EdgeLineNormals.Add(QuadNormal);
-
-            EdgeLineColors.Add(EdgeColor);
-            EdgeLineColors.Add(EdgeColor);
-            EdgeLineColors.Add(EdgeColor);
-            EdgeLineColors.Add(EdgeColor);
-        }
+        // 4 vertices and 2 triangles per edge, a quad across the edge and +Z
+        // (+Y for vertical edges), written on all threads
+        const int32 NumEdges = EdgeIndices.Num() / 2;
+        EdgeLineVertices.SetNumUninitialized(4 * NumEdges);
+        EdgeLineNormals.SetNumUninitialized(4 * NumEdges);
+        EdgeLineIndices.SetNumUninitialized(6 * NumEdges);
+        MyBuildEdgeRibbons(&Vertices.GetData()->X, EdgeIndices.GetData(), NumEdges, ActualEdgeThickness,
+            &EdgeLineVertices.GetData()->X, &EdgeLineNormals.GetData()->X, EdgeLineIndices.GetData());
+        EdgeLineColors.Init(EdgeColor, EdgeLineVertices.Num());
 
         if (EdgeLineVertices.Num() > 0)
         {
@@ -377,9 +352,9 @@ void AVtkPolyDataVisualizer::ConvertVtkPolyDataToUnrealMesh(
     }
 
     // --- Normals and Scalars (for per-face coloring) ---
-    FString VtkFileContent;
-    FFileHelper::LoadFileToString(VtkFileContent, *(FPaths::ProjectContentDir() / VtkFilePath.FilePath));
-    TArray<FLinearColor> ParsedLookupTable = ParseLookupTable(VtkFileContent, TEXT("my_table"), 8);
+    // The lookup table was parsed in the same read as the polydata
+    const TArray<FLinearColor>* FoundLookupTable = LoadedLookupTables.Find(TEXT("my_table"));
+    const TArray<FLinearColor> ParsedLookupTable = FoundLookupTable ? *FoundLookupTable : TArray<FLinearColor>();
     double ScalarRange[2] = { 0.0, 1.0 }; // Assumed scalar range from your VTK file
 
     // Get the scalar array by name from POINT_DATA
@@ -398,8 +373,6 @@ void AVtkPolyDataVisualizer::ConvertVtkPolyDataToUnrealMesh(
     vtkIdType NumCells = vtkPolygons->GetNumberOfCells();
     vtkIdList* CellPoints = vtkIdList::New();
 
-    TSet<FIntPoint> UniqueEdges; // For edge rendering
-
     // Iterate through each cell (polygon) to create triangles for Unreal
     for (vtkIdType CellIdx = 0; CellIdx < NumCells; ++CellIdx)
     {
@@ -482,80 +455,36 @@ void AVtkPolyDataVisualizer::ConvertVtkPolyDataToUnrealMesh(
 
                 CurrentVertexCount += 3;
             }
-
-            // Collect edges from the original polygon for the edge mesh component
-            for (vtkIdType j = 0; j < NumCellPoints; ++j)
-            {
-                vtkIdType VtxA = CellPoints->GetId(j);
-                vtkIdType VtxB = CellPoints->GetId((j + 1) % NumCellPoints);
-                
-                // Ensure consistent order (min, max) for unique edge detection in the set
-                if (VtxA > VtxB) Swap(VtxA, VtxB);
-                UniqueEdges.Add(FIntPoint(VtxA, VtxB));
-            }
         }
     }
     // Clean up VTK IdList
     CellPoints->Delete();
 
-    // Convert the set of unique edges into a linear array of indices for the edge mesh
-    for (const FIntPoint& Edge : UniqueEdges)
-    {
-        OutEdgeIndices.Add(Edge.X);
-        OutEdgeIndices.Add(Edge.Y);
-    }
+    // Unique edges of the original polygons for the edge mesh component,
+    // keyed, radix sorted and deduplicated on all threads
+    MyEdgeExtractor Edges;
+    Edges.AddPolygons(vtkPolygons, vtkPoints);
+    Edges.Extract();
+    OutEdgeIndices.SetNumUninitialized(static_cast<int32>(2 * Edges.GetNumberOfEdges()));
+    Edges.Fill(OutEdgeIndices.GetData());
 }
 
-// Helper function to parse a lookup table from the VTK file content string
-TArray<FLinearColor> AVtkPolyDataVisualizer::ParseLookupTable(const FString& VtkFileContent, const FString& TableName, int32 ExpectedEntries)
+// Helper function to convert a lookup table read by MyLoadPolyDataWithLookupTables
+TArray<FLinearColor> AVtkPolyDataVisualizer::ToLinearColors(vtkLookupTable* Lut)
 {
     TArray<FLinearColor> LutColors;
-    FString SearchString = FString::Printf(TEXT("LOOKUP_TABLE %s %d"), *TableName, ExpectedEntries);
-    int32 StartIndex = VtkFileContent.Find(SearchString, ESearchCase::CaseSensitive);
-
-    if (StartIndex == INDEX_NONE)
+    if (!Lut)
     {
-        UE_LOG(LogTemp, Error, TEXT("Lookup table '%s' definition not found in VTK file content."), *TableName);
         return LutColors;
     }
 
-    // Find the end of the line where the lookup table definition is (to start parsing colors from next line)
-    int32 EndOfDefLine = VtkFileContent.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, StartIndex);
-    if (EndOfDefLine == INDEX_NONE) EndOfDefLine = VtkFileContent.Len(); // Handle case where it's the last line
-
-    // Start parsing from the character after the definition line
-    int32 CurrentPos = EndOfDefLine + 1;
-
-    for (int32 i = 0; i < ExpectedEntries; ++i)
+    const vtkIdType NumEntries = Lut->GetNumberOfTableValues();
+    LutColors.Reserve(NumEntries);
+    for (vtkIdType i = 0; i < NumEntries; ++i)
     {
-        // Find the end of the current color entry line
-        int32 LineEnd = VtkFileContent.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, CurrentPos);
-        if (LineEnd == INDEX_NONE) LineEnd = VtkFileContent.Len(); // Handle last line
-
-        // Extract the line, trim whitespace
-        FString Line = VtkFileContent.Mid(CurrentPos, LineEnd - CurrentPos).TrimStartAndEnd();
-        CurrentPos = LineEnd + 1; // Move to the start of the next line
-
-        // Parse color components (R G B A) separated by spaces
-        TArray<FString> ColorComponents;
-        Line.ParseIntoArray(ColorComponents, TEXT(" "), true);
-
-        if (ColorComponents.Num() >= 4)
-        {
-            // Convert string components to float and add to LUT
-            float R = FCString::Atof(*ColorComponents[0]);
-            float G = FCString::Atof(*ColorComponents[1]);
-            float B = FCString::Atof(*ColorComponents[2]);
-            float A = FCString::Atof(*ColorComponents[3]);
-            LutColors.Add(FLinearColor(R, G, B, A));
-        }
-        else
-        {
-            UE_LOG(LogTemp, Error, TEXT("Failed to parse color entry %d for lookup table '%s': '%s'. Expected 4 components."), i, *TableName, *Line);
-            LutColors.Empty(); // Invalidate LUT if parsing fails
-            break;
-        }
+        double Rgba[4];
+        Lut->GetTableValue(i, Rgba);
+        LutColors.Add(FLinearColor(Rgba[0], Rgba[1], Rgba[2], Rgba[3]));
     }
-
     return LutColors;
 }
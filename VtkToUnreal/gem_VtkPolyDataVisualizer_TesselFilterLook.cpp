@@ -16,6 +16,13 @@ class vtkDataArray;
 class vtkIdList;
 class vtkDataSetSurfaceFilter; // Added for the new filter
 class vtkDataSet; // Added for generic dataset type
+class MyVtkCellStream;
+class MyMeshCache;
+class MyVertexColorizer;
+class MyColorMap;
+struct MyMeshCacheKey;
+struct MyMeshCacheView;
+struct MyEdgeExtractOptions;
 
 UCLASS()
 class MYUNREALPROJECT_API AVtkPolyDataVisualizer : public AActor
@@ -55,6 +62,14 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VTK Mesh")
     float LineWidth = 2.0f; 
 
+    // Draw only boundary, non-manifold and feature edges instead of every polygon edge
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VTK Mesh")
+    bool bFeatureEdgesOnly = false;
+
+    // Dihedral angle in degrees above which an edge between two polygons is a feature edge
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VTK Mesh", meta = (EditCondition = "bFeatureEdgesOnly", ClampMin = "0", ClampMax = "180"))
+    float EdgeFeatureAngle = 30.0f;
+
     // Path to the VTK file, relative to the project's Content directory
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VTK Mesh")
     FFilePath VtkFilePath;
@@ -63,10 +78,31 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VTK Mesh")
     int32 MaxSubdivisions = 3;
 
+    // Read POLYGONS a chunk at a time instead of loading the whole polydata.
+    // Skips the tessellator; meant for large legacy ASCII files.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VTK Mesh")
+    bool bStreamCells = false;
+
+    // Cells parsed per chunk when bStreamCells is set
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VTK Mesh", meta = (EditCondition = "bStreamCells", ClampMin = "1"))
+    int32 StreamChunkCells = 1000000;
+
+    // Keep converted meshes under Saved/VtkMeshCache and reuse them while the
+    // file content and the conversion settings stay the same
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VTK Mesh")
+    bool bUseMeshCache = true;
+
     // Function to load and visualize VTK data, callable from Blueprints
     UFUNCTION(BlueprintCallable, Category = "VTK Mesh")
     void LoadAndVisualizeVtkData();
 
+    // Recolors the loaded surface by another point or cell array and lookup
+    // table, keeping its geometry: only the vertex colors are computed and
+    // pushed with UpdateMeshSection. Needs the polydata of a full VTK load,
+    // so it returns false after a mesh cache hit or a streamed load.
+    UFUNCTION(BlueprintCallable, Category = "VTK Mesh")
+    bool RecolorVtkData(const FString& ArrayName, const FString& LookupTableName = TEXT("my_table"));
+
 private:
     // Helper function to convert VTK polydata to Unreal mesh data structures
     void ConvertVtkPolyDataToUnrealMesh(
@@ -79,8 +115,69 @@ private:
         TArray<int32>& OutEdgeIndices // Stores pairs of indices for edges
     );
 
-    // Helper to parse the lookup table from the VTK file content string
-    TArray<FLinearColor> ParseLookupTable(const FString& VtkFileContent, const FString& TableName, int32 ExpectedEntries);
+    // Same output as ConvertVtkPolyDataToUnrealMesh, consuming the stream chunk by chunk
+    void ConvertVtkCellStreamToUnrealMesh(
+        MyVtkCellStream& Stream,
+        TArray<FVector>& OutVertices,
+        TArray<int32>& OutTriangles,
+        TArray<FVector>& OutNormals,
+        TArray<FLinearColor>& OutColors,
+        TArray<FVector2D>& OutUVs,
+        TArray<int32>& OutEdgeIndices
+    );
+
+    // Fills the surface and edge mesh components from converted mesh data
+    void CreateMeshSections(
+        const TArray<FVector>& Vertices,
+        const TArray<int32>& Triangles,
+        const TArray<FVector>& Normals,
+        const TArray<FLinearColor>& Colors,
+        const TArray<FVector2D>& UVs,
+        const TArray<int32>& EdgeIndices
+    );
+
+    // Everything the converted mesh depends on besides the file content
+    FString GetMeshCacheParams() const;
+
+    // Which polygon edges the edge mesh draws, from bFeatureEdgesOnly and EdgeFeatureAngle
+    MyEdgeExtractOptions GetEdgeExtractOptions() const;
+
+    // Converted mesh buffers to and from a mesh cache entry
+    static void StoreConvertedMesh(
+        const MyMeshCache& Cache,
+        const MyMeshCacheKey& Key,
+        const TArray<FVector>& Vertices,
+        const TArray<int32>& Triangles,
+        const TArray<FVector>& Normals,
+        const TArray<FLinearColor>& Colors,
+        const TArray<FVector2D>& UVs,
+        const TArray<int32>& EdgeIndices
+    );
+    static void ReadConvertedMesh(
+        const MyMeshCacheView& Cached,
+        TArray<FVector>& OutVertices,
+        TArray<int32>& OutTriangles,
+        TArray<FVector>& OutNormals,
+        TArray<FLinearColor>& OutColors,
+        TArray<FVector2D>& OutUVs,
+        TArray<int32>& OutEdgeIndices
+    );
+
+    // Lookup tables read together with the polydata, keyed by table name
+    TMap<FString, TArray<FLinearColor>> LoadedLookupTables;
+
+    // What RecolorVtkData needs of the last full VTK load: the converted
+    // polydata and the surface vertices UpdateMeshSection takes back
+    TSharedPtr<MyVertexColorizer> SurfaceColorizer;
+    TArray<FVector> SurfaceVertices;
+
+    // Helper to convert a VTK lookup table into Unreal colors
+    static TArray<FLinearColor> ToLinearColors(vtkLookupTable* Lut);
+
+    // The one scalar to color mapping of the conversions and RecolorVtkData:
+    // the table's colors spread over the range of the scalars' first
+    // component, binned the way vtkLookupTable bins them
+    static MyColorMap MakeColorMap(const TArray<FLinearColor>& LutColors, vtkDataArray* Scalars);
 };
 
 ```cpp
@@ -92,6 +189,16 @@ private:
 
 // VTK Includes (ensure these are correctly linked in your Build.cs)
 #include "vtkPolyDataReader.h"
+#include "MyVtkLoader.h" // Single-pass load of polydata and its LOOKUP_TABLEs
+#include "MyVtkCellStream.h" // Chunked POLYGONS reader for large files
+#include "MyMeshCache.h" // Converted meshes kept on disk between runs
+#include "MyTriangleIndexBuilder.h" // Parallel index buffer straight from the cell arrays
+#include "MyAttributeExtract.h" // Typed attribute copies into Unreal vectors
+#include "MyColorMap.h" // Baked lookup table mapping for recoloring
+#include "MyScalarRange.h" // Cached scalar ranges
+#include "MyVertexColorizer.h" // Vertex colors of an already converted mesh
+#include "MyEdgeOverlay.h" // Parallel unique edges and their ribbon quads
+#include "MyStageProfile.h" // Per stage wall, CPU and memory with MY_PROFILE / MY_PROFILE_TRACE
 #include "vtkTessellatorFilter.h"
 #include "vtkPolyData.h" // Now explicitly needed for SafeDownCast
 #include "vtkPoints.h"
@@ -104,6 +211,7 @@ private:
 #include "vtkDataSetSurfaceFilter.h" // NEW: Required to convert UnstructuredGrid to PolyData
 #include "vtkUnstructuredGrid.h" // NEW: To check if the output is an UnstructuredGrid
 #include "vtkCellData.h" // NEW: For cell scalars if needed
+#include "vtkMath.h" // NaN for points no chunk colors
 
 // For custom memory allocator (from previous discussion)
 #include "HAL/MemoryBase.h"
@@ -145,6 +253,8 @@ void AVtkPolyDataVisualizer::BeginPlay()
 
 void AVtkPolyDataVisualizer::LoadAndVisualizeVtkData()
 {
+    MY_STAGE("load and visualize");
+
     // Check if a VTK file path is provided
     if (VtkFilePath.FilePath.IsEmpty())
     {
@@ -160,17 +270,94 @@ void AVtkPolyDataVisualizer::LoadAndVisualizeVtkData()
         return;
     }
 
+    // Only a full VTK load below can be recolored again
+    SurfaceColorizer.Reset();
+    SurfaceVertices.Empty();
+
+    // --- Converted mesh cache: a hit skips VTK entirely ---
+    const MyMeshCache MeshCache(TCHAR_TO_UTF8(*(FPaths::ProjectSavedDir() / TEXT("VtkMeshCache"))));
+    MyMeshCacheKey CacheKey;
+    const bool bCacheable = bUseMeshCache &&
+        MyMakeMeshCacheKey(TCHAR_TO_UTF8(*FullPath), TCHAR_TO_UTF8(*GetMeshCacheParams()), CacheKey);
+    MyMeshCacheView Cached;
+    MyStage CacheLoadStage("cache load");
+    if (bCacheable && MeshCache.Load(CacheKey, Cached))
+    {
+        TArray<FVector> Vertices;
+        TArray<int32> Triangles;
+        TArray<FVector> Normals;
+        TArray<FLinearColor> Colors;
+        TArray<FVector2D> UVs;
+        TArray<int32> EdgeIndices;
+        ReadConvertedMesh(Cached, Vertices, Triangles, Normals, Colors, UVs, EdgeIndices);
+        CacheLoadStage.Stop();
+        if (Vertices.Num() > 0 && Triangles.Num() > 0)
+        {
+            CreateMeshSections(Vertices, Triangles, Normals, Colors, UVs, EdgeIndices);
+            return;
+        }
+    }
+
+    CacheLoadStage.Stop();
+
+    // --- Streamed conversion: one chunk of cells in memory at a time ---
+    if (bStreamCells)
+    {
+        MyVtkCellStream Stream;
+        if (!Stream.Open(TCHAR_TO_UTF8(*FullPath), StreamChunkCells, { "custom_table_scalars" }))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to open VTK file for streaming: %s"), *FullPath);
+            return;
+        }
+
+        LoadedLookupTables.Empty();
+        for (const auto& [TableName, Lut] : Stream.GetLookupTables())
+        {
+            LoadedLookupTables.Add(UTF8_TO_TCHAR(TableName.c_str()), ToLinearColors(Lut));
+        }
+
+        TArray<FVector> Vertices;
+        TArray<int32> Triangles;
+        TArray<FVector> Normals;
+        TArray<FLinearColor> Colors;
+        TArray<FVector2D> UVs;
+        TArray<int32> EdgeIndices;
+        {
+            MY_STAGE("stream convert");
+            ConvertVtkCellStreamToUnrealMesh(Stream, Vertices, Triangles, Normals, Colors, UVs, EdgeIndices);
+        }
+
+        if (Stream.Failed() || Vertices.Num() == 0 || Triangles.Num() == 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("No valid mesh data streamed from: %s"), *FullPath);
+            return;
+        }
+
+        if (bCacheable)
+        {
+            MY_STAGE("cache store");
+            StoreConvertedMesh(MeshCache, CacheKey, Vertices, Triangles, Normals, Colors, UVs, EdgeIndices);
+        }
+        CreateMeshSections(Vertices, Triangles, Normals, Colors, UVs, EdgeIndices);
+        return;
+    }
+
     // --- VTK Pipeline Execution ---
 
-    // Create a VTK PolyData reader
-    vtkNew<vtkPolyDataReader> reader;
-    // Set the file name (VTK expects UTF8 encoding for file paths)
-    reader->SetFileName(TCHAR_TO_UTF8(*FullPath)); 
-    // Execute the reader to load the data
-    reader->Update();
+    // Read the file once: polydata and every embedded lookup table
+    // (VTK expects UTF8 encoding for file paths)
+    MyVtkLoadResult Loaded;
+    MyStage ReadStage("read");
+    MyLoadPolyDataWithLookupTables(TCHAR_TO_UTF8(*FullPath), Loaded);
+    ReadStage.Stop();
+
+    LoadedLookupTables.Empty();
+    for (const auto& [TableName, Lut] : Loaded.LookupTables)
+    {
+        LoadedLookupTables.Add(UTF8_TO_TCHAR(TableName.c_str()), ToLinearColors(Lut));
+    }
 
-    // Get the output polydata from the reader
-    vtkSmartPointer<vtkPolyData> polyData = reader->GetOutput();
+    vtkSmartPointer<vtkPolyData> polyData = Loaded.PolyData;
     if (!polyData || polyData->GetNumberOfPoints() == 0)
     {
         UE_LOG(LogTemp, Error, TEXT("Failed to read VTK PolyData or it's empty from file: %s"), *FullPath);
@@ -178,6 +365,7 @@ void AVtkPolyDataVisualizer::LoadAndVisualizeVtkData()
     }
 
     // Create a VTK Tessellator Filter
+    MyStage TessellateStage("tessellate");
     vtkNew<vtkTessellatorFilter> tessel;
     // Set the input data for tessellation
     tessel->SetInputData(polyData);
@@ -217,6 +405,8 @@ void AVtkPolyDataVisualizer::LoadAndVisualizeVtkData()
         }
     }
 
+    TessellateStage.Stop();
+
     if (!processedData || processedData->GetNumberOfPoints() == 0)
     {
         UE_LOG(LogTemp, Error, TEXT("Final processed data is empty or not vtkPolyData after tessellation and surface extraction."));
@@ -239,8 +429,151 @@ void AVtkPolyDataVisualizer::LoadAndVisualizeVtkData()
         return;
     }
 
+    if (bCacheable)
+    {
+        MY_STAGE("cache store");
+        StoreConvertedMesh(MeshCache, CacheKey, Vertices, Triangles, Normals, Colors, UVs, EdgeIndices);
+    }
+    CreateMeshSections(Vertices, Triangles, Normals, Colors, UVs, EdgeIndices);
+
+    // keep the geometry for RecolorVtkData
+    SurfaceColorizer = MakeShared<MyVertexColorizer>(processedData);
+    SurfaceVertices = MoveTemp(Vertices);
+}
+
+bool AVtkPolyDataVisualizer::RecolorVtkData(const FString& ArrayName, const FString& LookupTableName)
+{
+    if (!SurfaceColorizer || SurfaceMeshComponent->GetNumSections() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Nothing to recolor: the surface did not come from a full VTK load. Turn off bUseMeshCache and bStreamCells to recolor."));
+        return false;
+    }
+
+    const FTCHARToUTF8 Name(*ArrayName);
+    vtkDataArray* Scalars = SurfaceColorizer->FindArray(Name.Get());
+    const TArray<FLinearColor>* LutColors = LoadedLookupTables.Find(LookupTableName);
+    if (!Scalars || !LutColors || LutColors->Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Cannot recolor by array '%s' with lookup table '%s': not found."), *ArrayName, *LookupTableName);
+        return false;
+    }
+
+    TArray<FColor> Colors;
+    Colors.SetNumUninitialized(SurfaceVertices.Num());
+    SurfaceColorizer->Colorize(Name.Get(), MakeColorMap(*LutColors, Scalars), Colors.GetData(), MyColorFormat::BGRA8);
+
+    // empty normals, UVs and tangents keep the section's own
+    SurfaceMeshComponent->UpdateMeshSection(0, SurfaceVertices, TArray<FVector>(), TArray<FVector2D>(), Colors, TArray<FProcMeshTangent>());
+    return true;
+}
+
+FString AVtkPolyDataVisualizer::GetMeshCacheParams() const
+{
+    // Bump "converter" whenever ConvertVtkPolyDataToUnrealMesh or
+    // ConvertVtkCellStreamToUnrealMesh change their output
+    return FString::Printf(
+        TEXT("converter=3;stream=%d;MaxSubdivisions=%d;scalars=custom_table_scalars;lut=my_table;edges=%s"),
+        bStreamCells ? 1 : 0,
+        bStreamCells ? 0 : MaxSubdivisions,
+        bFeatureEdgesOnly ? *FString::Printf(TEXT("feature%g"), EdgeFeatureAngle) : TEXT("all"));
+}
+
+MyEdgeExtractOptions AVtkPolyDataVisualizer::GetEdgeExtractOptions() const
+{
+    MyEdgeExtractOptions Options;
+    Options.AllEdges = !bFeatureEdgesOnly;
+    Options.FeatureAngle = EdgeFeatureAngle;
+    return Options;
+}
+
+void AVtkPolyDataVisualizer::StoreConvertedMesh(
+    const MyMeshCache& Cache,
+    const MyMeshCacheKey& Key,
+    const TArray<FVector>& Vertices,
+    const TArray<int32>& Triangles,
+    const TArray<FVector>& Normals,
+    const TArray<FLinearColor>& Colors,
+    const TArray<FVector2D>& UVs,
+    const TArray<int32>& EdgeIndices)
+{
+    MyMeshBuffers Buffers;
+    Buffers.Positions.reserve(Vertices.Num() * 3);
+    for (const FVector& V : Vertices)
+    {
+        Buffers.Positions.insert(Buffers.Positions.end(), { float(V.X), float(V.Y), float(V.Z) });
+    }
+    Buffers.Normals.reserve(Normals.Num() * 3);
+    for (const FVector& N : Normals)
+    {
+        Buffers.Normals.insert(Buffers.Normals.end(), { float(N.X), float(N.Y), float(N.Z) });
+    }
+    Buffers.UVs.reserve(UVs.Num() * 2);
+    for (const FVector2D& UV : UVs)
+    {
+        Buffers.UVs.insert(Buffers.UVs.end(), { float(UV.X), float(UV.Y) });
+    }
+    Buffers.Colors.reserve(Colors.Num() * 4);
+    for (const FLinearColor& C : Colors)
+    {
+        Buffers.Colors.insert(Buffers.Colors.end(), { C.R, C.G, C.B, C.A });
+    }
+    Buffers.Triangles.assign(Triangles.GetData(), Triangles.GetData() + Triangles.Num());
+    Buffers.Edges.assign(EdgeIndices.GetData(), EdgeIndices.GetData() + EdgeIndices.Num());
+
+    if (!Cache.Store(Key, Buffers))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Could not write mesh cache entry: %s"), UTF8_TO_TCHAR(Cache.GetEntryPath(Key).c_str()));
+    }
+}
+
+void AVtkPolyDataVisualizer::ReadConvertedMesh(
+    const MyMeshCacheView& Cached,
+    TArray<FVector>& OutVertices,
+    TArray<int32>& OutTriangles,
+    TArray<FVector>& OutNormals,
+    TArray<FLinearColor>& OutColors,
+    TArray<FVector2D>& OutUVs,
+    TArray<int32>& OutEdgeIndices)
+{
+    const float* P = Cached.Positions.data();
+    OutVertices.SetNumUninitialized(Cached.Positions.size() / 3);
+    for (int32 i = 0; i < OutVertices.Num(); ++i, P += 3)
+    {
+        OutVertices[i] = FVector(P[0], P[1], P[2]);
+    }
+    const float* N = Cached.Normals.data();
+    OutNormals.SetNumUninitialized(Cached.Normals.size() / 3);
+    for (int32 i = 0; i < OutNormals.Num(); ++i, N += 3)
+    {
+        OutNormals[i] = FVector(N[0], N[1], N[2]);
+    }
+    const float* UV = Cached.UVs.data();
+    OutUVs.SetNumUninitialized(Cached.UVs.size() / 2);
+    for (int32 i = 0; i < OutUVs.Num(); ++i, UV += 2)
+    {
+        OutUVs[i] = FVector2D(UV[0], UV[1]);
+    }
+    const float* C = Cached.Colors.data();
+    OutColors.SetNumUninitialized(Cached.Colors.size() / 4);
+    for (int32 i = 0; i < OutColors.Num(); ++i, C += 4)
+    {
+        OutColors[i] = FLinearColor(C[0], C[1], C[2], C[3]);
+    }
+    OutTriangles = TArray<int32>(Cached.Triangles.data(), Cached.Triangles.size());
+    OutEdgeIndices = TArray<int32>(Cached.Edges.data(), Cached.Edges.size());
+}
+
+void AVtkPolyDataVisualizer::CreateMeshSections(
+    const TArray<FVector>& Vertices,
+    const TArray<int32>& Triangles,
+    const TArray<FVector>& Normals,
+    const TArray<FLinearColor>& Colors,
+    const TArray<FVector2D>& UVs,
+    const TArray<int32>& EdgeIndices)
+{
     // --- Create Surface Mesh Component ---
     // Clear any existing mesh sections
+    MyStage UploadStage("section upload");
     SurfaceMeshComponent->ClearAllMeshSections();
     // Create a new mesh section with the extracted data
     SurfaceMeshComponent->CreateMeshSection(
@@ -253,6 +586,7 @@ void AVtkPolyDataVisualizer::LoadAndVisualizeVtkData()
         TArray<FProcMeshTangent>(), // Tangents (optional, empty here)
         false           // Do not create collision for this visual mesh
     );
+    UploadStage.Stop();
 
     // Apply the surface material if set
     if (SurfaceMaterial)
@@ -282,51 +616,21 @@ void AVtkPolyDataVisualizer::LoadAndVisualizeVtkData()
         float ActualEdgeThickness = LineWidth * 0.005f; 
         if (ActualEdgeThickness < KINDA_SMALL_NUMBER) ActualEdgeThickness = 0.01f; // Minimum thickness
 
-        for (int32 i = 0; i < EdgeIndices.Num(); i += 2)
-        {
-            FVector StartVert = Vertices[EdgeIndices[i]];
-            FVector EndVert = Vertices[EdgeIndices[i+1]];
-
-            FVector LineDir = (EndVert - StartVert).GetSafeNormal();
-            // Find a perpendicular vector for offsetting the line to create a quad
-            FVector Perpendicular = FVector::CrossProduct(LineDir, FVector::UpVector).GetSafeNormal();
-            if (Perpendicular.IsNearlyZero()) // If line is vertical, cross with RightVector
-            {
-                Perpendicular = FVector::CrossProduct(LineDir, FVector::RightVector).GetSafeNormal();
-            }
-
-            FVector Offset = Perpendicular * ActualEdgeThickness * 0.5f;
-
-            // Add 4 vertices for the quad representing the line segment
-            int32 BaseIndex = EdgeLineVertices.Num();
-            EdgeLineVertices.Add(StartVert - Offset); // Bottom-left
-            EdgeLineVertices.Add(StartVert + Offset); // Top-left
-            EdgeLineVertices.Add(EndVert + Offset);   // Top-right
-            EdgeLineVertices.Add(EndVert - Offset);   // Bottom-right
-
-            // Add 2 triangles to form the quad
-            EdgeLineIndices.Add(BaseIndex + 0); EdgeLineIndices.Add(BaseIndex + 1); EdgeLineIndices.Add(BaseIndex + 2);
-            EdgeLineIndices.Add(BaseIndex + 0); EdgeLineIndices.Add(BaseIndex + 2); EdgeLineIndices.Add(BaseIndex + 3);
-
-            // Add normals (flat for the quad) and colors
-            FVector QuadNormal = FVector::CrossProduct(
-                EdgeLineVertices[BaseIndex+1] - EdgeLineVertices[BaseIndex], 
-                EdgeLineVertices[BaseIndex+3] - EdgeLineVertices[BaseIndex]
-            ).GetSafeNormal();
-
-            EdgeLineNormals.Add(QuadNormal);
-            EdgeLineNormals.Add(QuadNormal);
-            EdgeLineNormals.Add(QuadNormal);
-            EdgeLineNormals.Add(QuadNormal);
-
-            EdgeLineColors.Add(EdgeColor);
-            EdgeLineColors.Add(EdgeColor);
-            EdgeLineColors.Add(EdgeColor);
-            EdgeLineColors.Add(EdgeColor);
-        }
+        // 4 vertices and 2 triangles per edge, a quad across the edge and +Z
+        // (+Y for vertical edges), written on all threads
+        const int32 NumEdges = EdgeIndices.Num() / 2;
+        MyStage RibbonStage("edge ribbons");
+        EdgeLineVertices.SetNumUninitialized(4 * NumEdges);
+        EdgeLineNormals.SetNumUninitialized(4 * NumEdges);
+        EdgeLineIndices.SetNumUninitialized(6 * NumEdges);
+        MyBuildEdgeRibbons(&Vertices.GetData()->X, EdgeIndices.GetData(), NumEdges, ActualEdgeThickness,
+            &EdgeLineVertices.GetData()->X, &EdgeLineNormals.GetData()->X, EdgeLineIndices.GetData());
+        EdgeLineColors.Init(EdgeColor, EdgeLineVertices.Num());
+        RibbonStage.Stop();
 
         if (EdgeLineVertices.Num() > 0)
         {
+            MY_STAGE("edge section upload");
             EdgeMeshComponent->CreateMeshSection(
                 0,
                 EdgeLineVertices,
@@ -369,19 +673,15 @@ void AVtkPolyDataVisualizer::ConvertVtkPolyDataToUnrealMesh(
     OutEdgeIndices.Empty();
 
     // --- Points (Vertices) ---
+    MyStage ExtractStage("extract");
     vtkPoints* vtkPoints = InPolyData->GetPoints();
     if (vtkPoints)
     {
-        OutVertices.Reserve(vtkPoints->GetNumberOfPoints());
-        // Iterate through VTK points and convert to Unreal FVector
-        for (vtkIdType i = 0; i < vtkPoints->GetNumberOfPoints(); ++i)
-        {
-            double p[3];
-            vtkPoints->GetPoint(i, p);
-            // Assuming VTK's Z-up matches Unreal's Z-up.
-            // If coordinate system differences occur, adjust here (e.g., FVector(p[0], p[2], p[1]))
-            OutVertices.Add(FVector(p[0], p[1], p[2]));
-        }
+        // Copy VTK points into Unreal FVectors in one typed pass.
+        // Assuming VTK's Z-up matches Unreal's Z-up.
+        // If coordinate system differences occur, swap the components afterwards (e.g., FVector(p[0], p[2], p[1]))
+        OutVertices.SetNumUninitialized(vtkPoints->GetNumberOfPoints());
+        MyExtractComponents(vtkPoints->GetData(), &OutVertices.GetData()->X);
     }
 
     // --- Normals ---
@@ -389,13 +689,8 @@ void AVtkPolyDataVisualizer::ConvertVtkPolyDataToUnrealMesh(
     vtkDataArray* vtkNormals = InPolyData->GetPointData()->GetNormals();
     if (vtkNormals)
     {
-        OutNormals.Reserve(vtkNormals->GetNumberOfTuples());
-        for (vtkIdType i = 0; i < vtkNormals->GetNumberOfTuples(); ++i)
-        {
-            double n[3];
-            vtkNormals->GetTuple(i, n);
-            OutNormals.Add(FVector(n[0], n[1], n[2]));
-        }
+        OutNormals.SetNumUninitialized(vtkNormals->GetNumberOfTuples());
+        MyExtractComponents(vtkNormals, &OutNormals.GetData()->X);
     }
     else
     {
@@ -403,38 +698,19 @@ void AVtkPolyDataVisualizer::ConvertVtkPolyDataToUnrealMesh(
         UE_LOG(LogTemp, Warning, TEXT("No normals found in VTK PolyData. ProceduralMeshComponent will generate them if needed."));
     }
 
+    ExtractStage.Stop();
+
     // --- Scalars and Colors (using the 'custom_table_scalars' and 'my_table' lookup table) ---
-    FString VtkFileContent;
-    // Load the VTK file content as a string to parse the embedded lookup table
-    FFileHelper::LoadFileToString(VtkFileContent, *(FPaths::ProjectContentDir() / VtkFilePath.FilePath));
-    TArray<FLinearColor> ParsedLookupTable = ParseLookupTable(VtkFileContent, TEXT("my_table"), 8);
+    // The lookup table was parsed in the same read as the polydata
+    MyStage ColorMapStage("color map");
+    const TArray<FLinearColor>* FoundLookupTable = LoadedLookupTables.Find(TEXT("my_table"));
 
-    // Get the scalar array by name
+    // Get the scalar array by name, mapped the same way RecolorVtkData maps
     vtkDataArray* vtkScalars = InPolyData->GetPointData()->GetScalars("custom_table_scalars");
-    if (vtkScalars && ParsedLookupTable.Num() > 0)
+    if (vtkScalars && FoundLookupTable && FoundLookupTable->Num() > 0)
     {
-        OutColors.Reserve(vtkScalars->GetNumberOfTuples());
-        // Define the scalar range for mapping to the lookup table.
-        // This is assumed from the provided VTK file's LUT definition (0.0 to 1.0).
-        double ScalarRange[2] = { 0.0, 1.0 }; 
-
-        for (vtkIdType i = 0; i < vtkScalars->GetNumberOfTuples(); ++i)
-        {
-            double scalarValue = vtkScalars->GetTuple1(i); // Get single scalar value
-
-            // Normalize scalar value to the [0, 1] range based on the defined ScalarRange
-            double normalizedScalar = FMath::GetMappedRangeValueClamped(
-                FVector2D(ScalarRange[0], ScalarRange[1]),
-                FVector2D(0.0, 1.0),
-                scalarValue
-            );
-
-            // Map the normalized scalar to an index in the parsed lookup table
-            int32 LutIndex = FMath::RoundToInt(normalizedScalar * (ParsedLookupTable.Num() - 1));
-            LutIndex = FMath::Clamp(LutIndex, 0, ParsedLookupTable.Num() - 1);
-
-            OutColors.Add(ParsedLookupTable[LutIndex]);
-        }
+        OutColors.SetNumUninitialized(vtkScalars->GetNumberOfTuples());
+        MakeColorMap(*FoundLookupTable, vtkScalars).Map(vtkScalars, OutColors.GetData(), MyColorFormat::Float4);
     }
     else
     {
@@ -443,117 +719,166 @@ void AVtkPolyDataVisualizer::ConvertVtkPolyDataToUnrealMesh(
         OutColors.Init(FLinearColor::White, OutVertices.Num());
     }
 
+    ColorMapStage.Stop();
+
     // --- Cells (Triangles) and Edges ---
     vtkCellArray* vtkPolygons = InPolyData->GetPolys();
     if (vtkPolygons)
     {
-        vtkIdType NumCells = vtkPolygons->GetNumberOfCells();
-        vtkIdList* CellPoints = vtkIdList::New();
+        // Fan triangulation (V0, V1, V2), (V0, V2, V3), ... of every polygon,
+        // written straight from the offsets and connectivity on all threads
+        MyStage IndexStage("index build");
+        MyTriangleIndexBuilder TriangleIndices(vtkPolygons);
+        OutTriangles.SetNumUninitialized(static_cast<int32>(3 * TriangleIndices.GetNumberOfTriangles()));
+        TriangleIndices.Fill(OutTriangles.GetData());
+        IndexStage.Stop();
+
+        // Unique edges of the original polygons for the edge mesh component,
+        // keyed, radix sorted and deduplicated on all threads
+        MY_STAGE("edges");
+        MyEdgeExtractor Edges(GetEdgeExtractOptions());
+        Edges.AddPolygons(vtkPolygons, InPolyData->GetPoints());
+        Edges.Extract();
+        OutEdgeIndices.SetNumUninitialized(static_cast<int32>(2 * Edges.GetNumberOfEdges()));
+        Edges.Fill(OutEdgeIndices.GetData());
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No polygons found in VTK PolyData."));
+    }
+}
+
+void AVtkPolyDataVisualizer::ConvertVtkCellStreamToUnrealMesh(
+    MyVtkCellStream& Stream,
+    TArray<FVector>& OutVertices,
+    TArray<int32>& OutTriangles,
+    TArray<FVector>& OutNormals,
+    TArray<FLinearColor>& OutColors,
+    TArray<FVector2D>& OutUVs,
+    TArray<int32>& OutEdgeIndices)
+{
+    OutVertices.Empty();
+    OutTriangles.Empty();
+    OutNormals.Empty(); // ProceduralMeshComponent generates them, no tessellator ran
+    OutColors.Empty();
+    OutUVs.Empty();
+    OutEdgeIndices.Empty();
+
+    // Vertices keep their file point ids so triangles can be emitted per chunk
+    // without a global remap; every chunk writes the points it uses.
+    const int32 NumPoints = static_cast<int32>(Stream.GetNumberOfPoints());
+    OutVertices.SetNumZeroed(NumPoints);
+    OutColors.Init(FLinearColor::White, NumPoints);
+    OutTriangles.Reserve(static_cast<int32>(Stream.GetNumberOfTriangles() * 3));
+
+    const TArray<FLinearColor>* FoundLookupTable = LoadedLookupTables.Find(TEXT("my_table"));
+    if (!FoundLookupTable || FoundLookupTable->Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("'my_table' lookup table not found. Defaulting to white vertex colors."));
+        FoundLookupTable = nullptr;
+    }
 
-        // Use a set to store unique edges to avoid duplicates when generating line geometry
-        TSet<FIntPoint> UniqueEdges;
+    // The range of the scalars is known only once every chunk is in, so
+    // their first component is gathered by point id and mapped at the end
+    vtkNew<vtkFloatArray> StreamScalars;
+    bool bHasScalars = false;
+    if (FoundLookupTable)
+    {
+        StreamScalars->SetNumberOfValues(NumPoints);
+        StreamScalars->FillValue(static_cast<float>(vtkMath::Nan()));
+    }
 
-        for (vtkIdType i = 0; i < NumCells; ++i)
+    MyEdgeExtractor Edges(GetEdgeExtractOptions());
+    MyMeshChunk Chunk;
+    while (Stream.Next(Chunk))
+    {
+        const int32 NumLocalPoints = Chunk.PointIds.size();
+        for (int32 Local = 0; Local < NumLocalPoints; ++Local)
         {
-            // Get the point IDs for the current cell
-            vtkPolygons->GetCell(i, CellPoints);
-            vtkIdType NumCellPoints = CellPoints->GetNumberOfIds();
-
-            // Triangulate polygons for Unreal's ProceduralMeshComponent
-            // The input VTK file uses 4-vertex polygons (quads).
-            // For a quad (V0, V1, V2, V3), we create two triangles (V0,V1,V2) and (V0,V2,V3).
-            // For general N-gons, a fan triangulation from the first vertex is used (V0, V1, V2), (V0, V2, V3), ...
-            if (NumCellPoints >= 3)
+            const float* P = &Chunk.Points[3 * Local];
+            OutVertices[Chunk.PointIds[Local]] = FVector(P[0], P[1], P[2]);
+        }
+
+        const MyMeshChunkArray* Scalars = Chunk.FindPointArray("custom_table_scalars");
+        if (Scalars && FoundLookupTable)
+        {
+            bHasScalars = true;
+            for (int32 Local = 0; Local < NumLocalPoints; ++Local)
             {
-                vtkIdType V0 = CellPoints->GetId(0);
-                for (vtkIdType j = 1; j < NumCellPoints - 1; ++j)
-                {
-                    vtkIdType V1 = CellPoints->GetId(j);
-                    vtkIdType V2 = CellPoints->GetId(j + 1);
-
-                    OutTriangles.Add(V0);
-                    OutTriangles.Add(V1);
-                    OutTriangles.Add(V2);
-                }
-
-                // Collect edges from the original polygon for the edge mesh component
-                for (vtkIdType j = 0; j < NumCellPoints; ++j)
-                {
-                    vtkIdType VtxA = CellPoints->GetId(j);
-                    vtkIdType VtxB = CellPoints->GetId((j + 1) % NumCellPoints);
-                    
-                    // Ensure consistent order (min, max) for unique edge detection in the set
-                    if (VtxA > VtxB) Swap(VtxA, VtxB);
-                    UniqueEdges.Add(FIntPoint(VtxA, VtxB));
-                }
+                StreamScalars->SetValue(Chunk.PointIds[Local], Scalars->Values[Local * Scalars->NumberOfComponents]);
             }
         }
-        // Clean up VTK IdList
-        CellPoints->Delete();
 
-        // Convert the set of unique edges into a linear array of indices for the edge mesh
-        for (const FIntPoint& Edge : UniqueEdges)
+        // Fan triangulation, in file point ids
+        for (vtkIdType Cell = 0; Cell < Chunk.GetNumberOfCells(); ++Cell)
         {
-            OutEdgeIndices.Add(Edge.X);
-            OutEdgeIndices.Add(Edge.Y);
+            const vtkIdType* CellPoints = Chunk.Connectivity.data() + Chunk.Offsets[Cell];
+            const vtkIdType NumCellPoints = Chunk.Offsets[Cell + 1] - Chunk.Offsets[Cell];
+            if (NumCellPoints < 3)
+            {
+                continue;
+            }
+
+            const int32 V0 = Chunk.PointIds[CellPoints[0]];
+            for (vtkIdType j = 1; j < NumCellPoints - 1; ++j)
+            {
+                OutTriangles.Add(V0);
+                OutTriangles.Add(Chunk.PointIds[CellPoints[j]]);
+                OutTriangles.Add(Chunk.PointIds[CellPoints[j + 1]]);
+            }
         }
+
+        // polygon edges in file point ids, deduplicated once all chunks are in
+        Edges.AddPolygons(Chunk.Offsets.data(), Chunk.Connectivity.data(), Chunk.GetNumberOfCells(),
+            Chunk.PointIds.data(), Chunk.Points.data());
     }
-    else
+
+    // Same mapping as ConvertVtkPolyDataToUnrealMesh
+    if (bHasScalars)
     {
-        UE_LOG(LogTemp, Warning, TEXT("No polygons found in VTK PolyData."));
+        MakeColorMap(*FoundLookupTable, StreamScalars).Map(StreamScalars, OutColors.GetData(), MyColorFormat::Float4);
     }
+
+    Edges.Extract();
+    OutEdgeIndices.SetNumUninitialized(static_cast<int32>(2 * Edges.GetNumberOfEdges()));
+    Edges.Fill(OutEdgeIndices.GetData());
 }
 
-// Helper function to parse a lookup table from the VTK file content string
-TArray<FLinearColor> AVtkPolyDataVisualizer::ParseLookupTable(const FString& VtkFileContent, const FString& TableName, int32 ExpectedEntries)
+// Helper function to convert a lookup table read by MyLoadPolyDataWithLookupTables
+TArray<FLinearColor> AVtkPolyDataVisualizer::ToLinearColors(vtkLookupTable* Lut)
 {
     TArray<FLinearColor> LutColors;
-    FString SearchString = FString::Printf(TEXT("LOOKUP_TABLE %s %d"), *TableName, ExpectedEntries);
-    int32 StartIndex = VtkFileContent.Find(SearchString, ESearchCase::CaseSensitive);
-
-    if (StartIndex == INDEX_NONE)
+    if (!Lut)
     {
-        UE_LOG(LogTemp, Error, TEXT("Lookup table '%s' definition not found in VTK file content."), *TableName);
         return LutColors;
     }
 
-    // Find the end of the line where the lookup table definition is (to start parsing colors from next line)
-    int32 EndOfDefLine = VtkFileContent.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, StartIndex);
-    if (EndOfDefLine == INDEX_NONE) EndOfDefLine = VtkFileContent.Len(); // Handle case where it's the last line
-
-    // Start parsing from the character after the definition line
-    int32 CurrentPos = EndOfDefLine + 1;
-
-    for (int32 i = 0; i < ExpectedEntries; ++i)
+    const vtkIdType NumEntries = Lut->GetNumberOfTableValues();
+    LutColors.Reserve(NumEntries);
+    for (vtkIdType i = 0; i < NumEntries; ++i)
     {
-        // Find the end of the current color entry line
-        int32 LineEnd = VtkFileContent.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, CurrentPos);
-        if (LineEnd == INDEX_NONE) LineEnd = VtkFileContent.Len(); // Handle last line
-
-        // Extract the line, trim whitespace
-        FString Line = VtkFileContent.Mid(CurrentPos, LineEnd - CurrentPos).TrimStartAndEnd();
-        CurrentPos = LineEnd + 1; // Move to the start of the next line
-
-        // Parse color components (R G B A) separated by spaces
-        TArray<FString> ColorComponents;
-        Line.ParseIntoArray(ColorComponents, TEXT(" "), true);
+        double Rgba[4];
+        Lut->GetTableValue(i, Rgba);
+        LutColors.Add(FLinearColor(Rgba[0], Rgba[1], Rgba[2], Rgba[3]));
+    }
+    return LutColors;
+}
 
-        if (ColorComponents.Num() >= 4)
-        {
-            // Convert string components to float and add to LUT
-            float R = FCString::Atof(*ColorComponents[0]);
-            float G = FCString::Atof(*ColorComponents[1]);
-            float B = FCString::Atof(*ColorComponents[2]);
-            float A = FCString::Atof(*ColorComponents[3]);
-            LutColors.Add(FLinearColor(R, G, B, A));
-        }
-        else
-        {
-            UE_LOG(LogTemp, Error, TEXT("Failed to parse color entry %d for lookup table '%s': '%s'. Expected 4 components."), i, *TableName, *Line);
-            LutColors.Empty(); // Invalidate LUT if parsing fails
-            break;
-        }
+MyColorMap AVtkPolyDataVisualizer::MakeColorMap(const TArray<FLinearColor>& LutColors, vtkDataArray* Scalars)
+{
+    vtkNew<vtkLookupTable> Lut;
+    Lut->SetNumberOfTableValues(LutColors.Num());
+    for (int32 i = 0; i < LutColors.Num(); ++i)
+    {
+        const FLinearColor& C = LutColors[i];
+        Lut->SetTableValue(i, C.R, C.G, C.B, C.A);
     }
 
-    return LutColors;
+    // ranges are cached, so flipping between arrays scans each of them once
+    double Range[2];
+    if (MyGetScalarRange(Scalars, Range))
+    {
+        Lut->SetTableRange(Range);
+    }
+    return MyColorMap(Lut);
 }
@@ -79,8 +79,11 @@ private:
         TArray<int32>& OutEdgeIndices // Stores pairs of indices for edges
     );
 
-    // Helper to parse the lookup table from the VTK file content string
-    TArray<FLinearColor> ParseLookupTable(const FString& VtkFileContent, const FString& TableName, int32 ExpectedEntries);
+    // Lookup tables read together with the polydata, keyed by table name
+    TMap<FString, TArray<FLinearColor>> LoadedLookupTables;
+
+    // Helper to convert a VTK lookup table into Unreal colors
+    static TArray<FLinearColor> ToLinearColors(vtkLookupTable* Lut);
 };
 
 ```cpp
@@ -92,6 +95,7 @@ private:
 
 // VTK Includes (ensure these are correctly linked in your Build.cs)
 #include "vtkPolyDataReader.h"
+#include "MyVtkLoader.h" // Single-pass load of polydata and its LOOKUP_TABLEs
 #include "vtkTessellatorFilter.h"
 #include "vtkPolyData.h" // Now explicitly needed for SafeDownCast
 #include "vtkPoints.h"
@@ -161,15 +165,18 @@ void AVtkPolyDataVisualizer::LoadAndVisualizeVtkData()
     }
 
     // --- VTK Pipeline Execution ---
-    // Create a VTK PolyData reader
-    vtkNew<vtkPolyDataReader> reader;
-    // Set the file name (VTK expects UTF8 encoding for file paths)
-    reader->SetFileName(TCHAR_TO_UTF8(*FullPath)); 
-    // Execute the reader to load the data
-    reader->Update();
-
-    // Get the output polydata from the reader
-    vtkSmartPointer<vtkPolyData> polyData = reader->GetOutput();
+    // Read the file once: polydata and every embedded lookup table
+    // (VTK expects UTF8 encoding for file paths)
+    MyVtkLoadResult Loaded;
+    MyLoadPolyDataWithLookupTables(TCHAR_TO_UTF8(*FullPath), Loaded);
+
+    LoadedLookupTables.Empty();
+    for (const auto& [TableName, Lut] : Loaded.LookupTables)
+    {
+        LoadedLookupTables.Add(UTF8_TO_TCHAR(TableName.c_str()), ToLinearColors(Lut));
+    }
+
+    vtkSmartPointer<vtkPolyData> polyData = Loaded.PolyData;
     if (!polyData || polyData->GetNumberOfPoints() == 0)
     {
         UE_LOG(LogTemp, Error, TEXT("Failed to read VTK PolyData or it's empty from file: %s"), *FullPath);
@@ -406,10 +413,9 @@ void AVtkPolyDataVisualizer::ConvertVtkPolyDataToUnrealMesh(
     }
 
     // --- Scalars and Colors (using the 'custom_table_scalars' and 'my_table' lookup table) ---
-    FString VtkFileContent;
-    // Load the VTK file content as a string to parse the embedded lookup table
-    FFileHelper::LoadFileToString(VtkFileContent, *(FPaths::ProjectContentDir() / VtkFilePath.FilePath));
-    TArray<FLinearColor> ParsedLookupTable = ParseLookupTable(VtkFileContent, TEXT("my_table"), 8);
+    // The lookup table was parsed in the same read as the polydata
+    const TArray<FLinearColor>* FoundLookupTable = LoadedLookupTables.Find(TEXT("my_table"));
+    const TArray<FLinearColor> ParsedLookupTable = FoundLookupTable ? *FoundLookupTable : TArray<FLinearColor>();
 
     // Get the scalar array by name
     vtkDataArray* vtkScalars = InPolyData->GetPointData()->GetScalars("custom_table_scalars");
@@ -507,56 +513,22 @@ void AVtkPolyDataVisualizer::ConvertVtkPolyDataToUnrealMesh(
     }
 }
 
-// Helper function to parse a lookup table from the VTK file content string
-TArray<FLinearColor> AVtkPolyDataVisualizer::ParseLookupTable(const FString& VtkFileContent, const FString& TableName, int32 ExpectedEntries)
+// Helper function to convert a lookup table read by MyLoadPolyDataWithLookupTables
+TArray<FLinearColor> AVtkPolyDataVisualizer::ToLinearColors(vtkLookupTable* Lut)
 {
     TArray<FLinearColor> LutColors;
-    FString SearchString = FString::Printf(TEXT("LOOKUP_TABLE %s %d"), *TableName, ExpectedEntries);
-    int32 StartIndex = VtkFileContent.Find(SearchString, ESearchCase::CaseSensitive);
-
-    if (StartIndex == INDEX_NONE)
+    if (!Lut)
     {
-        UE_LOG(LogTemp, Error, TEXT("Lookup table '%s' definition not found in VTK file content."), *TableName);
         return LutColors;
     }
 
-    // Find the end of the line where the lookup table definition is (to start parsing colors from next line)
-    int32 EndOfDefLine = VtkFileContent.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, StartIndex);
-    if (EndOfDefLine == INDEX_NONE) EndOfDefLine = VtkFileContent.Len(); // Handle case where it's the last line
-
-    // Start parsing from the character after the definition line
-    int32 CurrentPos = EndOfDefLine + 1;
-
-    for (int32 i = 0; i < ExpectedEntries; ++i)
+    const vtkIdType NumEntries = Lut->GetNumberOfTableValues();
+    LutColors.Reserve(NumEntries);
+    for (vtkIdType i = 0; i < NumEntries; ++i)
     {
-        // Find the end of the current color entry line
-        int32 LineEnd = VtkFileContent.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, CurrentPos);
-        if (LineEnd == INDEX_NONE) LineEnd = VtkFileContent.Len(); // Handle last line
-
-        // Extract the line, trim whitespace
-        FString Line = VtkFileContent.Mid(CurrentPos, LineEnd - CurrentPos).TrimStartAndEnd();
-        CurrentPos = LineEnd + 1; // Move to the start of the next line
-
-        // Parse color components (R G B A) separated by spaces
-        TArray<FString> ColorComponents;
-        Line.ParseIntoArray(ColorComponents, TEXT(" "), true);
-
-        if (ColorComponents.Num() >= 4)
-        {
-            // Convert string components to float and add to LUT
-            float R = FCString::Atof(*ColorComponents[0]);
-            float G = FCString::Atof(*ColorComponents[1]);
-            float B = FCString::Atof(*ColorComponents[2]);
-            float A = FCString::Atof(*ColorComponents[3]);
-            LutColors.Add(FLinearColor(R, G, B, A));
-        }
-        else
-        {
-            UE_LOG(LogTemp, Error, TEXT("Failed to parse color entry %d for lookup table '%s': '%s'. Expected 4 components."), i, *TableName, *Line);
-            LutColors.Empty(); // Invalidate LUT if parsing fails
-            break;
-        }
+        double Rgba[4];
+        Lut->GetTableValue(i, Rgba);
+        LutColors.Add(FLinearColor(Rgba[0], Rgba[1], Rgba[2], Rgba[3]));
     }
-
     return LutColors;
 }
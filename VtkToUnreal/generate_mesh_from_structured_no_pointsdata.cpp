@@ -5,9 +5,6 @@
 #include <vtkStructuredPointsReader.h>
 #include <vtkImageData.h>
 #include <vtkMarchingCubes.h>
-#include <vtkTriangleFilter.h>
-#include <vtkPolyDataNormals.h>
-#include <vtkCleanPolyData.h>
 #include <vtkPolyData.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
@@ -17,12 +14,16 @@
 
 // Unreal includes
 #include "ProceduralMeshComponent.h"
+#include "MyStageProfile.h"
+#include "MyTriangulateCleanNormals.h"
 
 void GenerateMeshFromVolume(const std::string& filePath, UProceduralMeshComponent* MeshComponent, double isoValue)
 {
+    MyStage readStage("read");
     vtkNew<vtkStructuredPointsReader> reader;
     reader->SetFileName(filePath.c_str());
     reader->Update();
+    readStage.Stop();
 
     vtkImageData* imageData = reader->GetOutput();
     if (!imageData || !imageData->GetPointData()->GetScalars()) {
@@ -31,25 +32,17 @@ void GenerateMeshFromVolume(const std::string& filePath, UProceduralMeshComponen
     }
 
     // Extract isosurface using Marching Cubes
+    MyStage contourStage("marching cubes");
     vtkNew<vtkMarchingCubes> mc;
     mc->SetInputData(imageData);
     mc->SetValue(0, isoValue);
     mc->Update();
+    contourStage.Stop();
 
-    vtkNew<vtkTriangleFilter> triangleFilter;
-    triangleFilter->SetInputConnection(mc->GetOutputPort());
-    triangleFilter->Update();
-
-    vtkNew<vtkCleanPolyData> clean;
-    clean->SetInputConnection(triangleFilter->GetOutputPort());
-    clean->Update();
-
-    vtkNew<vtkPolyDataNormals> normalsFilter;
-    normalsFilter->SetInputConnection(clean->GetOutputPort());
-    normalsFilter->ComputePointNormalsOn();
-    normalsFilter->Update();
-
-    vtkPolyData* poly = normalsFilter->GetOutput();
+    // triangulate, weld duplicate points and compute point normals in one pass
+    MyStage cleanStage("triangulate+clean");
+    vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(mc->GetOutput());
+    cleanStage.Stop();
     vtkPoints* points = poly->GetPoints();
     vtkDataArray* normals = poly->GetPointData()->GetNormals();
 
@@ -65,6 +58,7 @@ void GenerateMeshFromVolume(const std::string& filePath, UProceduralMeshComponen
     TArray<FLinearColor> Colors;
     TArray<FProcMeshTangent> Tangents;
 
+    MyStage convertStage("convert");
     for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i) {
         double p[3];
         points->GetPoint(i, p);
@@ -94,7 +88,9 @@ void GenerateMeshFromVolume(const std::string& filePath, UProceduralMeshComponen
             Triangles.Add(ptIds[2]);
         }
     }
+    convertStage.Stop();
 
+    MY_STAGE("section upload");
     MeshComponent->CreateMeshSection_LinearColor(
         0,
         Vertices,
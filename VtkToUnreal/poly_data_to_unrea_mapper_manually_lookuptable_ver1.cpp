@@ -1,9 +1,6 @@
 // Converts 3D vtkPolyData (.vtk) directly into an Unreal Engine mesh, supporting cell- and point-based scalar color lookup tables
 #include <vtkSmartPointer.h>
 #include <vtkPolyDataReader.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkPolyData.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
@@ -18,12 +15,12 @@
 #include <vtkGenericDataObjectReader.h>
 #include <vtkFloatArray.h>
 #include <vtkXMLPolyDataReader.h>
-#include <vtkPolyDataMapper.h>
 #include <vtkStringArray.h>
 #include <vtkAbstractArray.h>
 #include <iostream>
 
 #include "ProceduralMeshComponent.h"
+#include "MyColorMap.h"
 
 vtkSmartPointer<vtkLookupTable> ExtractLookupTableFromPolyData(vtkPolyData* poly, const std::string& lutName)
 {
@@ -70,7 +67,7 @@ vtkSmartPointer<vtkLookupTable> ExtractLookupTableFromPolyData(vtkPolyData* poly
     return nullptr;
 }
 
-vtkUnsignedCharArray* MapScalarsWithCustomLUT(vtkPolyData* poly, const std::string& scalarName, const std::string& lookupTableName, bool useCellData)
+vtkSmartPointer<vtkUnsignedCharArray> MapScalarsWithCustomLUT(vtkPolyData* poly, const std::string& scalarName, const std::string& lookupTableName, bool useCellData)
 {
     vtkSmartPointer<vtkDataArray> scalars = useCellData
         ? poly->GetCellData()->GetArray(scalarName.c_str())
@@ -98,17 +95,12 @@ vtkUnsignedCharArray* MapScalarsWithCustomLUT(vtkPolyData* poly, const std::stri
         lut->SetTableValue(7, 1.0, 1.0, 1.0, 1.0);
     }
 
-    vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapper->SetInputData(poly);
-    mapper->SetScalarVisibility(true);
-    mapper->SetLookupTable(lut);
-    mapper->SetColorModeToMapScalars();
-    mapper->SetScalarMode(useCellData ? VTK_SCALAR_MODE_USE_CELL_DATA : VTK_SCALAR_MODE_USE_POINT_DATA);
-    mapper->SelectColorArray(scalarName.c_str());
-    mapper->Update();
-
-    return mapper->MapScalars(1.0);
+    vtkSmartPointer<vtkUnsignedCharArray> colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    colors->SetNumberOfComponents(4);
+    colors->SetNumberOfTuples(scalars->GetNumberOfTuples());
+    MyColorMap(lut).Map(scalars, colors->GetPointer(0), MyColorFormat::RGBA8);
+    return colors;
 }
 
 // Example usage:
-// vtkUnsignedCharArray* mappedColors = MapScalarsWithCustomLUT(poly, "custom_table_scalars", "my_table", false);
+// vtkSmartPointer<vtkUnsignedCharArray> mappedColors = MapScalarsWithCustomLUT(poly, "custom_table_scalars", "my_table", false);
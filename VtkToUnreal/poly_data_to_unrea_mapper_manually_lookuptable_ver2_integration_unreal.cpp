@@ -1,9 +1,6 @@
 // Converts 3D vtkPolyData (.vtk) directly into an Unreal Engine mesh, supporting cell- and point-based scalar color lookup tables
 #include <vtkSmartPointer.h>
 #include <vtkPolyDataReader.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkPolyData.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
@@ -18,7 +15,6 @@
 #include <vtkGenericDataObjectReader.h>
 #include <vtkFloatArray.h>
 #include <vtkXMLPolyDataReader.h>
-#include <vtkPolyDataMapper.h>
 #include <vtkStringArray.h>
 #include <vtkAbstractArray.h>
 #include <iostream>
@@ -26,29 +22,11 @@
 #include "ProceduralMeshComponent.h"
 #include "Engine/World.h"
 #include "KismetProceduralMeshLibrary.h"
+#include "MyColorMap.h"
 
-vtkSmartPointer<vtkLookupTable> ExtractLookupTableFromMapper(vtkPolyDataMapper* mapper)
-{
-    vtkScalarsToColors* scalarsToColors = mapper->GetLookupTable();
-    if (!scalarsToColors)
-    {
-        std::cerr << "Mapper has no lookup table." << std::endl;
-        return nullptr;
-    }
-
-    vtkLookupTable* lut = vtkLookupTable::SafeDownCast(scalarsToColors);
-    if (!lut)
-    {
-        std::cerr << "Lookup table is not of type vtkLookupTable." << std::endl;
-        return nullptr;
-    }
-
-    vtkSmartPointer<vtkLookupTable> copiedLUT = vtkSmartPointer<vtkLookupTable>::New();
-    copiedLUT->DeepCopy(lut);
-    return copiedLUT;
-}
-
-vtkUnsignedCharArray* MapScalarsWithCustomLUT(vtkPolyData* poly, const std::string& scalarName, const std::string& lookupTableName, bool useCellData)
+// Colors through the array's lookup table, or the hardcoded one below, baked by
+// MyColorMap instead of a vtkPolyDataMapper::MapScalars call
+vtkSmartPointer<vtkUnsignedCharArray> MapScalarsWithCustomLUT(vtkPolyData* poly, const std::string& scalarName, const std::string& lookupTableName, bool useCellData)
 {
     vtkSmartPointer<vtkDataArray> scalars = useCellData
         ? poly->GetCellData()->GetArray(scalarName.c_str())
@@ -59,34 +37,29 @@ vtkUnsignedCharArray* MapScalarsWithCustomLUT(vtkPolyData* poly, const std::stri
         return nullptr;
     }
 
-    vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapper->SetInputData(poly);
-    mapper->SetScalarVisibility(true);
-    mapper->SetColorModeToMapScalars();
-    mapper->SetScalarMode(useCellData ? VTK_SCALAR_MODE_USE_CELL_DATA : VTK_SCALAR_MODE_USE_POINT_DATA);
-    mapper->SelectColorArray(scalarName.c_str());
-
-    vtkSmartPointer<vtkLookupTable> lut = ExtractLookupTableFromMapper(mapper);
+    vtkSmartPointer<vtkScalarsToColors> lut = scalars->GetLookupTable();
     if (!lut)
     {
         std::cerr << "Falling back to default hardcoded LUT." << std::endl;
-        lut = vtkSmartPointer<vtkLookupTable>::New();
-        lut->SetNumberOfTableValues(8);
-        lut->Build();
-        lut->SetTableValue(0, 0.0, 0.0, 0.0, 1.0);
-        lut->SetTableValue(1, 0.3, 0.0, 0.0, 1.0);
-        lut->SetTableValue(2, 0.6, 0.0, 0.0, 1.0);
-        lut->SetTableValue(3, 0.9, 0.0, 0.0, 1.0);
-        lut->SetTableValue(4, 0.9, 0.3, 0.3, 1.0);
-        lut->SetTableValue(5, 0.9, 0.6, 0.6, 1.0);
-        lut->SetTableValue(6, 0.9, 0.9, 0.9, 1.0);
-        lut->SetTableValue(7, 1.0, 1.0, 1.0, 1.0);
+        vtkSmartPointer<vtkLookupTable> fallbackLut = vtkSmartPointer<vtkLookupTable>::New();
+        fallbackLut->SetNumberOfTableValues(8);
+        fallbackLut->Build();
+        fallbackLut->SetTableValue(0, 0.0, 0.0, 0.0, 1.0);
+        fallbackLut->SetTableValue(1, 0.3, 0.0, 0.0, 1.0);
+        fallbackLut->SetTableValue(2, 0.6, 0.0, 0.0, 1.0);
+        fallbackLut->SetTableValue(3, 0.9, 0.0, 0.0, 1.0);
+        fallbackLut->SetTableValue(4, 0.9, 0.3, 0.3, 1.0);
+        fallbackLut->SetTableValue(5, 0.9, 0.6, 0.6, 1.0);
+        fallbackLut->SetTableValue(6, 0.9, 0.9, 0.9, 1.0);
+        fallbackLut->SetTableValue(7, 1.0, 1.0, 1.0, 1.0);
+        lut = fallbackLut;
     }
 
-    mapper->SetLookupTable(lut);
-    mapper->Update();
-
-    return mapper->MapScalars(1.0);
+    vtkSmartPointer<vtkUnsignedCharArray> colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    colors->SetNumberOfComponents(4);
+    colors->SetNumberOfTuples(scalars->GetNumberOfTuples());
+    MyColorMap(lut).Map(scalars, colors->GetPointer(0), MyColorFormat::RGBA8);
+    return colors;
 }
 
 void CreateUnrealMeshFromVTK(UWorld* World, vtkPolyData* PolyData, const std::string& ScalarName, bool bUseCellData)
@@ -96,7 +69,7 @@ void CreateUnrealMeshFromVTK(UWorld* World, vtkPolyData* PolyData, const std::st
     vtkPoints* Points = PolyData->GetPoints();
     if (!Points) return;
 
-    vtkUnsignedCharArray* Colors = MapScalarsWithCustomLUT(PolyData, ScalarName, "", bUseCellData);
+    vtkSmartPointer<vtkUnsignedCharArray> Colors = MapScalarsWithCustomLUT(PolyData, ScalarName, "", bUseCellData);
 
     TArray<FVector> Vertices;
     TArray<int32> Triangles;
@@ -108,6 +81,20 @@ void CreateUnrealMeshFromVTK(UWorld* World, vtkPolyData* PolyData, const std::st
     vtkCellArray* Polys = PolyData->GetPolys();
     vtkIdType npts, *pts;
 
+    // Every fanned triangle gets its own three vertices: size all buffers once
+    // from the cell array, npts - 2 triangles per polygon
+    const int32 NumTriangleVertices = static_cast<int32>(
+        3 * (Polys->GetNumberOfConnectivityIds() - 2 * Polys->GetNumberOfCells()));
+    if (NumTriangleVertices > 0)
+    {
+        Vertices.Reserve(NumTriangleVertices);
+        Triangles.Reserve(NumTriangleVertices);
+        Normals.Reserve(NumTriangleVertices);
+        UVs.Reserve(NumTriangleVertices);
+        VertexColors.Reserve(NumTriangleVertices);
+        Tangents.Reserve(NumTriangleVertices);
+    }
+
     for (Polys->InitTraversal(); Polys->GetNextCell(npts, pts);)
     {
         if (npts < 3) continue;
@@ -141,7 +128,7 @@ void CreateUnrealMeshFromVTK(UWorld* World, vtkPolyData* PolyData, const std::st
     UProceduralMeshComponent* ProcMesh = NewObject<UProceduralMeshComponent>(MeshActor);
     ProcMesh->RegisterComponent();
     ProcMesh->AttachToComponent(MeshActor->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
-    ProcMesh->CreateMeshSection_LinearColor(0, Vertices, Triangles, Normals, UVs, VertexColors, Tangents, true);
+    ProcMesh->CreateMeshSection(0, Vertices, Triangles, Normals, UVs, VertexColors, Tangents, true);
     MeshActor->SetRootComponent(ProcMesh);
 }
 
@@ -1,9 +1,5 @@
 // Converts 3D vtkPolyData (.vtk) directly into an Unreal Engine mesh
 #include <vtkSmartPointer.h>
-#include <vtkPolyDataReader.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkPolyData.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
@@ -12,34 +8,91 @@
 #include <iostream>
 
 #include "ProceduralMeshComponent.h"
+#include "MyAttributeExtract.h"
+#include "MyTriangleIndexBuilder.h"
+#include "MyTriangulateCleanNormals.h"
+#include "MyVtkLoader.h"
+#include "MyVtkProbe.h"
+#include "MyMeshCache.h"
 
-void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshComponent* MeshComponent)
+// bump when the pipeline or the buffers built below change
+static const char* MeshCacheParams = "converter=2;triangulate;clean;point-normals";
+
+static void CreateMeshSectionFromCache(const MyMeshCacheView& cached, UProceduralMeshComponent* MeshComponent)
 {
-    vtkNew<vtkPolyDataReader> reader;
-    reader->SetFileName(filePath.c_str());
-    reader->Update();
+    const int32 NumVertices = static_cast<int32>(cached.Positions.size() / 3);
+    TArray<FVector> Vertices;
+    TArray<FVector> Normals;
+    TArray<FVector2D> UVs;
+    TArray<FLinearColor> Colors;
+    TArray<FProcMeshTangent> Tangents;
+    Vertices.SetNumUninitialized(NumVertices);
+    Normals.SetNumUninitialized(NumVertices);
+    UVs.SetNumUninitialized(NumVertices);
+    Colors.SetNumUninitialized(NumVertices);
+    Tangents.SetNumUninitialized(NumVertices);
+    for (int32 i = 0; i < NumVertices; ++i) {
+        const float* p = &cached.Positions[i * 3];
+        const float* n = &cached.Normals[i * 3];
+        const float* uv = &cached.UVs[i * 2];
+        const float* c = &cached.Colors[i * 4];
+        const float* t = &cached.Tangents[i * 4];
+        Vertices[i] = FVector(p[0], p[1], p[2]);
+        Normals[i] = FVector(n[0], n[1], n[2]);
+        UVs[i] = FVector2D(uv[0], uv[1]);
+        Colors[i] = FLinearColor(c[0], c[1], c[2], c[3]);
+        Tangents[i] = FProcMeshTangent(FVector(t[0], t[1], t[2]), t[3] < 0.0f);
+    }
+    TArray<int32> Triangles(cached.Triangles.data(), static_cast<int32>(cached.Triangles.size()));
 
-    vtkPolyData* rawPoly = reader->GetOutput();
-    if (!rawPoly || !rawPoly->GetPoints()) {
-        std::cerr << "Invalid or empty vtkPolyData!" << std::endl;
-        return;
+    MeshComponent->CreateMeshSection_LinearColor(
+        0,
+        Vertices,
+        Triangles,
+        Normals,
+        UVs,
+        Colors,
+        Tangents,
+        true);
+}
+
+// cacheDirectory: keep the converted buffers there and reuse them while the
+// file content is unchanged; nullptr always runs the VTK pipeline
+void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshComponent* MeshComponent,
+    const char* cacheDirectory = nullptr)
+{
+    MyMeshCacheKey cacheKey;
+    const bool cacheable = cacheDirectory && MyMakeMeshCacheKey(filePath.c_str(), MeshCacheParams, cacheKey);
+    if (cacheable) {
+        MyMeshCacheView cached;
+        const bool complete = MyMeshCache(cacheDirectory).Load(cacheKey, cached) && !cached.Triangles.empty() &&
+            cached.Normals.size() == cached.Positions.size() && cached.UVs.size() / 2 == cached.Positions.size() / 3 &&
+            cached.Colors.size() / 4 == cached.Positions.size() / 3 && cached.Tangents.size() == cached.Colors.size();
+        if (complete) {
+            CreateMeshSectionFromCache(cached, MeshComponent);
+            return;
+        }
     }
 
-    // Ensure mesh is triangulated
-    vtkNew<vtkTriangleFilter> triangleFilter;
-    triangleFilter->SetInputData(rawPoly);
-    triangleFilter->Update();
+    // header lines only, the loader reads the body
+    MyVtkFileInfo info;
+    if (!MyProbeVtkFileType(filePath.c_str(), info) || !info.IsPolyData()) {
+        std::cerr << "Not a vtk polydata file: " << filePath << std::endl;
+        return;
+    }
 
-    vtkNew<vtkCleanPolyData> clean;
-    clean->SetInputConnection(triangleFilter->GetOutputPort());
-    clean->Update();
+    // ASCII and BINARY legacy files are read straight from the mapped file
+    MyVtkLoadResult loaded;
+    MyLoadPolyDataWithLookupTables(filePath.c_str(), loaded);
 
-    vtkNew<vtkPolyDataNormals> normalsFilter;
-    normalsFilter->SetInputConnection(clean->GetOutputPort());
-    normalsFilter->ComputePointNormalsOn();
-    normalsFilter->Update();
+    vtkPolyData* rawPoly = loaded.PolyData;
+    if (!rawPoly || !rawPoly->GetPoints()) {
+        std::cerr << "Invalid or empty vtkPolyData!" << std::endl;
+        return;
+    }
 
-    vtkPolyData* poly = normalsFilter->GetOutput();
+    // triangulate, weld duplicate points and compute point normals in one pass
+    vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(rawPoly);
     vtkPoints* points = poly->GetPoints();
     vtkDataArray* normals = poly->GetPointData()->GetNormals();
 
@@ -50,34 +103,40 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
     TArray<FLinearColor> Colors;
     TArray<FProcMeshTangent> Tangents;
 
-    for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i) {
-        double p[3];
-        points->GetPoint(i, p);
-        Vertices.Add(FVector(p[0], p[1], p[2]));
-
-        if (normals) {
-            double n[3];
-            normals->GetTuple(i, n);
-            Normals.Add(FVector(n[0], n[1], n[2]));
-        } else {
-            Normals.Add(FVector::UpVector);
-        }
-
-        UVs.Add(FVector2D(0.0f, 0.0f));
-        Colors.Add(FLinearColor::White);
-        Tangents.Add(FProcMeshTangent(1.0f, 0.0f, 0.0f));
+    // one typed pass per attribute instead of a virtual GetPoint/GetTuple per point
+    const int32 NumVertices = static_cast<int32>(points->GetNumberOfPoints());
+    Vertices.SetNumUninitialized(NumVertices);
+    MyExtractComponents(points->GetData(), &Vertices.GetData()->X);
+    if (normals) {
+        Normals.SetNumUninitialized(NumVertices);
+        MyExtractComponents(normals, &Normals.GetData()->X);
+    } else {
+        Normals.Init(FVector::UpVector, NumVertices);
     }
+    UVs.Init(FVector2D(0.0f, 0.0f), NumVertices);
+    Colors.Init(FLinearColor::White, NumVertices);
+    Tangents.Init(FProcMeshTangent(1.0f, 0.0f, 0.0f), NumVertices);
 
     vtkCellArray* cells = poly->GetPolys();
-    vtkIdType npts;
-    const vtkIdType* ptIds;
+    MyTriangleIndexBuilder triangleIndices(cells);
+    Triangles.SetNumUninitialized(static_cast<int32>(3 * triangleIndices.GetNumberOfTriangles()));
+    triangleIndices.Fill(Triangles.GetData());
 
-    for (cells->InitTraversal(); cells->GetNextCell(npts, ptIds);) {
-        if (npts == 3) {
-            Triangles.Add(ptIds[0]);
-            Triangles.Add(ptIds[1]);
-            Triangles.Add(ptIds[2]);
+    if (cacheable) {
+        MyMeshBuffers buffers;
+        for (int32 i = 0; i < Vertices.Num(); ++i) {
+            const FVector& p = Vertices[i];
+            const FVector& n = Normals[i];
+            const FProcMeshTangent& t = Tangents[i];
+            buffers.Positions.insert(buffers.Positions.end(), { float(p.X), float(p.Y), float(p.Z) });
+            buffers.Normals.insert(buffers.Normals.end(), { float(n.X), float(n.Y), float(n.Z) });
+            buffers.UVs.insert(buffers.UVs.end(), { float(UVs[i].X), float(UVs[i].Y) });
+            buffers.Colors.insert(buffers.Colors.end(), { Colors[i].R, Colors[i].G, Colors[i].B, Colors[i].A });
+            buffers.Tangents.insert(buffers.Tangents.end(),
+                { float(t.TangentX.X), float(t.TangentX.Y), float(t.TangentX.Z), t.bFlipTangentY ? -1.0f : 1.0f });
         }
+        buffers.Triangles.assign(Triangles.GetData(), Triangles.GetData() + Triangles.Num());
+        MyMeshCache(cacheDirectory).Store(cacheKey, buffers);
     }
 
     MeshComponent->CreateMeshSection_LinearColor(
@@ -1,9 +1,6 @@
 // Converts 3D vtkPolyData (.vtk) directly into an Unreal Engine mesh
 #include <vtkSmartPointer.h>
 #include <vtkPolyDataReader.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkPolyData.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
@@ -13,6 +10,9 @@
 #include <iostream>
 
 #include "ProceduralMeshComponent.h"
+#include "MyAttributeExtract.h"
+#include "MyTriangleIndexBuilder.h"
+#include "MyTriangulateCleanNormals.h"
 
 void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshComponent* MeshComponent)
 {
@@ -26,22 +26,11 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
         return;
     }
 
-    // Ensure mesh is triangulated
-    vtkNew<vtkTriangleFilter> triangleFilter;
-    triangleFilter->SetInputData(rawPoly);
-    triangleFilter->Update();
-
-    vtkNew<vtkCleanPolyData> clean;
-    clean->SetInputConnection(triangleFilter->GetOutputPort());
-    clean->Update();
-
-    vtkNew<vtkPolyDataNormals> normalsFilter;
-    normalsFilter->SetInputConnection(clean->GetOutputPort());
-    normalsFilter->ComputePointNormalsOff();
-    normalsFilter->ComputeCellNormalsOn();
-    normalsFilter->Update();
-
-    vtkPolyData* poly = normalsFilter->GetOutput();
+    // triangulate, weld duplicate points and compute cell normals in one pass
+    MyTriangulateCleanNormalsOptions cleanOptions;
+    cleanOptions.ComputePointNormals = false;
+    cleanOptions.ComputeCellNormals = true;
+    vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(rawPoly, cleanOptions);
     vtkPoints* points = poly->GetPoints();
     vtkDataArray* cellNormals = poly->GetCellData()->GetNormals();
 
@@ -52,33 +41,34 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
     TArray<FLinearColor> Colors;
     TArray<FProcMeshTangent> Tangents;
 
-    for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i) {
-        double p[3];
-        points->GetPoint(i, p);
-        Vertices.Add(FVector(p[0], p[1], p[2]));
+    const int32 NumVertices = static_cast<int32>(points->GetNumberOfPoints());
+    Vertices.SetNumUninitialized(NumVertices);
+    MyExtractComponents(points->GetData(), &Vertices.GetData()->X);
+
+    // Placeholder, actual normals added per-triangle below
+    Normals.Init(FVector::UpVector, NumVertices);
+    UVs.Init(FVector2D(0.0f, 0.0f), NumVertices);
+    Colors.Init(FLinearColor::White, NumVertices);
+    Tangents.Init(FProcMeshTangent(1.0f, 0.0f, 0.0f), NumVertices);
 
-        // Placeholder, actual normals added per-triangle below
-        Normals.Add(FVector::UpVector);
-        UVs.Add(FVector2D(0.0f, 0.0f));
-        Colors.Add(FLinearColor::White);
-        Tangents.Add(FProcMeshTangent(1.0f, 0.0f, 0.0f));
+    // cell normals read once into FVectors rather than per triangle
+    TArray<FVector> CellNormals;
+    if (cellNormals) {
+        CellNormals.SetNumUninitialized(static_cast<int32>(cellNormals->GetNumberOfTuples()));
+        MyExtractComponents(cellNormals, &CellNormals.GetData()->X);
     }
 
     vtkCellArray* cells = poly->GetPolys();
-    vtkIdType npts;
-    const vtkIdType* ptIds;
-    vtkIdType cellId = 0;
+    MyTriangleIndexBuilder triangleIndices(cells);
+    Triangles.SetNumUninitialized(static_cast<int32>(3 * triangleIndices.GetNumberOfTriangles()));
+    triangleIndices.Fill(Triangles.GetData());
 
-    for (cells->InitTraversal(); cells->GetNextCell(npts, ptIds); ++cellId) {
-        if (npts == 3) {
-            Triangles.Add(ptIds[0]);
-            Triangles.Add(ptIds[1]);
-            Triangles.Add(ptIds[2]);
+    for (vtkIdType cellId = 0; cellId < triangleIndices.GetNumberOfCells(); ++cellId) {
+        for (vtkIdType t = triangleIndices.GetFirstTriangle(cellId); t < triangleIndices.GetFirstTriangle(cellId + 1); ++t) {
+            const int32* ptIds = &Triangles[3 * t];
 
             if (cellNormals) {
-                double n[3];
-                cellNormals->GetTuple(cellId, n);
-                FVector normal(n[0], n[1], n[2]);
+                const FVector& normal = CellNormals[cellId];
                 Normals[ptIds[0]] = normal;
                 Normals[ptIds[1]] = normal;
                 Normals[ptIds[2]] = normal;
@@ -1,9 +1,6 @@
 // Converts 3D vtkPolyData (.vtk) directly into an Unreal Engine mesh, supporting cell- and point-based scalar color lookup tables
 #include <vtkSmartPointer.h>
 #include <vtkPolyDataReader.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkPolyData.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
@@ -19,8 +16,16 @@
 #include <vtkFloatArray.h>
 #include <vtkXMLPolyDataReader.h>
 #include <iostream>
+#include <vector>
 
 #include "ProceduralMeshComponent.h"
+#include "MyAttributeExtract.h"
+#include "MyColorMap.h"
+#include "MyScalarRange.h"
+#include "MySplitVertices.h"
+#include "MyTangents.h"
+#include "MyTriangulateCleanNormals.h"
+#include "MyVertexGather.h"
 
 void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshComponent* MeshComponent)
 {
@@ -34,21 +39,10 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
         return;
     }
 
-    vtkNew<vtkTriangleFilter> triangleFilter;
-    triangleFilter->SetInputData(rawPoly);
-    triangleFilter->Update();
-
-    vtkNew<vtkCleanPolyData> clean;
-    clean->SetInputConnection(triangleFilter->GetOutputPort());
-    clean->Update();
-
-    vtkNew<vtkPolyDataNormals> normalsFilter;
-    normalsFilter->SetInputConnection(clean->GetOutputPort());
-    normalsFilter->ComputePointNormalsOn();
-    normalsFilter->ComputeCellNormalsOn();
-    normalsFilter->Update();
-
-    vtkPolyData* poly = normalsFilter->GetOutput();
+    // triangulate, weld duplicate points and compute point and cell normals in one pass
+    MyTriangulateCleanNormalsOptions cleanOptions;
+    cleanOptions.ComputeCellNormals = true;
+    vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(rawPoly, cleanOptions);
     vtkPoints* points = poly->GetPoints();
     vtkDataArray* cellNormals = poly->GetCellData()->GetNormals();
     vtkDataArray* pointNormals = poly->GetPointData()->GetNormals();
@@ -69,10 +63,9 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
     if (!lut) {
         // Fallback: generate LUT manually
         vtkNew<vtkLookupTable> generatedLut;
-        if (cellScalars)
-            generatedLut->SetTableRange(cellScalars->GetRange());
-        else if (pointScalars)
-            generatedLut->SetTableRange(pointScalars->GetRange());
+        double scalarRange[2];
+        if (MyGetScalarRange(cellScalars ? cellScalars : pointScalars, scalarRange))
+            generatedLut->SetTableRange(scalarRange);
         generatedLut->Build();
         lut = generatedLut;
     }
@@ -81,7 +74,7 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
     TArray<int32> Triangles;
     TArray<FVector> Normals;
     TArray<FVector2D> UVs;
-    TArray<FLinearColor> Colors;
+    TArray<FColor> Colors;
     TArray<FProcMeshTangent> Tangents;
 
     double bounds[6];
@@ -89,91 +82,90 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
     double dx = bounds[1] - bounds[0];
     double dy = bounds[3] - bounds[2];
 
-    for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i) {
-        double p[3];
-        points->GetPoint(i, p);
-        Vertices.Add(FVector(p[0], p[1], p[2]));
-
-        FVector normal = FVector::UpVector;
-        if (pointNormals) {
-            double n[3];
-            pointNormals->GetTuple(i, n);
-            normal = FVector(n[0], n[1], n[2]);
+    // a vertex per point and distinct cell color and normal around it, instead
+    // of one per point taking the attributes of the last cell drawn
+    const bool useCellNormals = !pointNormals && cellNormals;
+    std::vector<MyComponentView> cellValues;
+    if (cellScalars) {
+        for (int c = 0; c < cellScalars->GetNumberOfComponents(); ++c) {
+            cellValues.emplace_back(cellScalars, c);
         }
-        Normals.Add(normal);
-
-        float u = static_cast<float>((p[0] - bounds[0]) / dx);
-        float v = static_cast<float>((p[1] - bounds[2]) / dy);
-        UVs.Add(FVector2D(u, v));
+    }
+    if (useCellNormals) {
+        for (int c = 0; c < 3; ++c) {
+            cellValues.emplace_back(cellNormals, c);
+        }
+    }
+    const MySplitVerticesResult split = MySplitVertices(poly, cellValues);
+    const int32 NumVertices = static_cast<int32>(split.VertexPoints.size());
+
+    // typed copies of the point and cell arrays, mapped straight to FColor,
+    // the 8-bit format the mesh section stores
+    TArray<FVector> PointCoords, PointNormals, CellNormals;
+    PointCoords.SetNumUninitialized(static_cast<int32>(points->GetNumberOfPoints()));
+    MyExtractComponents(points->GetData(), &PointCoords.GetData()->X);
+    if (pointNormals) {
+        PointNormals.SetNumUninitialized(static_cast<int32>(pointNormals->GetNumberOfTuples()));
+        MyExtractComponents(pointNormals, &PointNormals.GetData()->X);
+    } else if (useCellNormals) {
+        CellNormals.SetNumUninitialized(static_cast<int32>(cellNormals->GetNumberOfTuples()));
+        MyExtractComponents(cellNormals, &CellNormals.GetData()->X);
+    }
+    TArray<FColor> CellColors, PointColors;
+    if (cellScalars) {
+        CellColors.SetNumUninitialized(static_cast<int32>(cellScalars->GetNumberOfTuples()));
+        MyColorMap(lut).Map(cellScalars, CellColors.GetData(), MyColorFormat::BGRA8);
+    } else if (pointScalars) {
+        PointColors.SetNumUninitialized(static_cast<int32>(pointScalars->GetNumberOfTuples()));
+        MyColorMap(lut).Map(pointScalars, PointColors.GetData(), MyColorFormat::BGRA8);
+    }
 
-        Colors.Add(FLinearColor::White);
-        Tangents.Add(FProcMeshTangent(1.0f, 0.0f, 0.0f));
+    // one kernel for the attributes present, simple planar UV mapping (XY
+    // projection); vertices without normals or colors keep the defaults
+    Vertices.SetNumUninitialized(NumVertices);
+    Normals.Init(FVector::UpVector, NumVertices);
+    UVs.SetNumUninitialized(NumVertices);
+    Colors.Init(FColor::White, NumVertices);
+
+    MyVertexSources<FVector::FReal, FColor> sources;
+    sources.Points = &PointCoords.GetData()->X;
+    sources.VertexPoints = split.VertexPoints.data();
+    sources.VertexCells = split.VertexCells.data();
+    sources.PointNormals = pointNormals ? &PointNormals.GetData()->X : nullptr;
+    sources.CellNormals = useCellNormals ? &CellNormals.GetData()->X : nullptr;
+    sources.PointColors = PointColors.Num() ? PointColors.GetData() : nullptr;
+    sources.CellColors = CellColors.Num() ? CellColors.GetData() : nullptr;
+    sources.PlanarUVs = true;
+    sources.UVOrigin[0] = bounds[0];
+    sources.UVOrigin[1] = bounds[2];
+    sources.UVSize[0] = dx;
+    sources.UVSize[1] = dy;
+    MyVertexTargets<FVector::FReal, FColor> targets;
+    targets.Positions = &Vertices.GetData()->X;
+    targets.Normals = &Normals.GetData()->X;
+    targets.Colors = Colors.GetData();
+    targets.UVs = &UVs.GetData()->X;
+    MyGatherVertices(sources, targets, NumVertices);
+
+    Triangles.SetNumUninitialized(static_cast<int32>(split.Triangles.size()));
+    for (int32 i = 0; i < Triangles.Num(); ++i) {
+        Triangles[i] = static_cast<int32>(split.Triangles[i]);
     }
 
-    vtkCellArray* cells = poly->GetPolys();
-    vtkIdType npts;
-    const vtkIdType* ptIds;
-    vtkIdType cellId = 0;
-
-    for (cells->InitTraversal(); cells->GetNextCell(npts, ptIds); ++cellId) {
-        if (npts == 3) {
-            Triangles.Add(ptIds[0]);
-            Triangles.Add(ptIds[1]);
-            Triangles.Add(ptIds[2]);
-
-            FVector normal = FVector::UpVector;
-            if (!pointNormals && cellNormals) {
-                double n[3];
-                cellNormals->GetTuple(cellId, n);
-                normal = FVector(n[0], n[1], n[2]);
-                Normals[ptIds[0]] = normal;
-                Normals[ptIds[1]] = normal;
-                Normals[ptIds[2]] = normal;
-            }
-
-            if (cellScalars) {
-                double val = cellScalars->GetTuple1(cellId);
-                double rgb[3];
-                lut->GetColor(val, rgb);
-                FLinearColor color(rgb[0], rgb[1], rgb[2], 1.0);
-                Colors[ptIds[0]] = color;
-                Colors[ptIds[1]] = color;
-                Colors[ptIds[2]] = color;
-            } else if (pointScalars) {
-                for (int j = 0; j < 3; ++j) {
-                    double val = pointScalars->GetTuple1(ptIds[j]);
-                    double rgb[3];
-                    lut->GetColor(val, rgb);
-                    Colors[ptIds[j]] = FLinearColor(rgb[0], rgb[1], rgb[2], 1.0);
-                }
-            }
-
-            const FVector& p0 = Vertices[ptIds[0]];
-            const FVector& p1 = Vertices[ptIds[1]];
-            const FVector& p2 = Vertices[ptIds[2]];
-
-            const FVector2D& uv0 = UVs[ptIds[0]];
-            const FVector2D& uv1 = UVs[ptIds[1]];
-            const FVector2D& uv2 = UVs[ptIds[2]];
-
-            FVector edge1 = p1 - p0;
-            FVector edge2 = p2 - p0;
-            FVector2D deltaUV1 = uv1 - uv0;
-            FVector2D deltaUV2 = uv2 - uv0;
-
-            float f = deltaUV1.X * deltaUV2.Y - deltaUV2.X * deltaUV1.Y;
-            if (FMath::Abs(f) < KINDA_SMALL_NUMBER) f = 1.0f; else f = 1.0f / f;
-
-            FVector tangent = f * (deltaUV2.Y * edge1 - deltaUV1.Y * edge2);
-            tangent.Normalize();
-
-            Tangents[ptIds[0]] = FProcMeshTangent(tangent, false);
-            Tangents[ptIds[1]] = FProcMeshTangent(tangent, false);
-            Tangents[ptIds[2]] = FProcMeshTangent(tangent, false);
-        }
+    // angle weighted per-vertex frames on the final normals, MikkTSpace style,
+    // so the engine does not need to recompute them
+    TArray<FVector> TangentX;
+    TArray<float> TangentSigns;
+    TangentX.SetNumUninitialized(NumVertices);
+    TangentSigns.SetNumUninitialized(NumVertices);
+    MyComputeTangents(&Vertices.GetData()->X, &Normals.GetData()->X, &UVs.GetData()->X, NumVertices,
+        Triangles.GetData(), Triangles.Num() / 3, &TangentX.GetData()->X, TangentSigns.GetData());
+    Tangents.SetNumUninitialized(NumVertices);
+    for (int32 i = 0; i < NumVertices; ++i) {
+        Tangents[i] = FProcMeshTangent(TangentX[i], TangentSigns[i] < 0.0f);
     }
 
-    MeshComponent->CreateMeshSection_LinearColor(
+    MeshComponent->CreateMeshSection(
         0,
         Vertices,
         Triangles,
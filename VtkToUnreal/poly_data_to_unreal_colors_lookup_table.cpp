@@ -1,9 +1,6 @@
 // Converts 3D vtkPolyData (.vtk) directly into an Unreal Engine mesh
 #include <vtkSmartPointer.h>
 #include <vtkPolyDataReader.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkPolyData.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
@@ -15,6 +12,11 @@
 #include <iostream>
 
 #include "ProceduralMeshComponent.h"
+#include "MyAttributeExtract.h"
+#include "MyColorMap.h"
+#include "MyScalarRange.h"
+#include "MyTriangleIndexBuilder.h"
+#include "MyTriangulateCleanNormals.h"
 
 void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshComponent* MeshComponent)
 {
@@ -28,22 +30,10 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
         return;
     }
 
-    // Ensure mesh is triangulated
-    vtkNew<vtkTriangleFilter> triangleFilter;
-    triangleFilter->SetInputData(rawPoly);
-    triangleFilter->Update();
-
-    vtkNew<vtkCleanPolyData> clean;
-    clean->SetInputConnection(triangleFilter->GetOutputPort());
-    clean->Update();
-
-    vtkNew<vtkPolyDataNormals> normalsFilter;
-    normalsFilter->SetInputConnection(clean->GetOutputPort());
-    normalsFilter->ComputePointNormalsOn(); // Enable both types for fallback
-    normalsFilter->ComputeCellNormalsOn();
-    normalsFilter->Update();
-
-    vtkPolyData* poly = normalsFilter->GetOutput();
+    // triangulate, weld duplicate points and compute point and cell normals in one pass
+    MyTriangulateCleanNormalsOptions cleanOptions;
+    cleanOptions.ComputeCellNormals = true;
+    vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(rawPoly, cleanOptions);
     vtkPoints* points = poly->GetPoints();
     vtkDataArray* cellNormals = poly->GetCellData()->GetNormals();
     vtkDataArray* pointNormals = poly->GetPointData()->GetNormals();
@@ -51,9 +41,10 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
     // Attempt to get scalar array and color map it
     vtkDataArray* scalars = poly->GetPointData()->GetScalars();
     vtkSmartPointer<vtkLookupTable> lut = vtkSmartPointer<vtkLookupTable>::New();
-    if (scalars)
+    double scalarRange[2];
+    if (MyGetScalarRange(scalars, scalarRange))
     {
-        lut->SetTableRange(scalars->GetRange());
+        lut->SetTableRange(scalarRange);
         lut->Build();
     }
 
@@ -61,7 +52,7 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
     TArray<int32> Triangles;
     TArray<FVector> Normals;
     TArray<FVector2D> UVs;
-    TArray<FLinearColor> Colors;
+    TArray<FColor> Colors;
     TArray<FProcMeshTangent> Tangents;
 
     // Compute bounds for basic UV projection
@@ -70,52 +61,52 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
     double dx = bounds[1] - bounds[0];
     double dy = bounds[3] - bounds[2];
 
-    for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i) {
-        double p[3];
-        points->GetPoint(i, p);
-        Vertices.Add(FVector(p[0], p[1], p[2]));
-
-        FVector normal = FVector::UpVector;
-        if (pointNormals) {
-            double n[3];
-            pointNormals->GetTuple(i, n);
-            normal = FVector(n[0], n[1], n[2]);
-        }
+    const int32 NumVertices = static_cast<int32>(points->GetNumberOfPoints());
+    Vertices.SetNumUninitialized(NumVertices);
+    MyExtractComponents(points->GetData(), &Vertices.GetData()->X);
 
-        Normals.Add(normal);
+    if (pointNormals) {
+        Normals.SetNumUninitialized(NumVertices);
+        MyExtractComponents(pointNormals, &Normals.GetData()->X);
+    } else {
+        Normals.Init(FVector::UpVector, NumVertices);
+    }
 
-        // Simple planar UV mapping (XY projection)
-        float u = static_cast<float>((p[0] - bounds[0]) / dx);
-        float v = static_cast<float>((p[1] - bounds[2]) / dy);
-        UVs.Add(FVector2D(u, v));
+    // Simple planar UV mapping (XY projection)
+    UVs.SetNumUninitialized(NumVertices);
+    for (int32 i = 0; i < NumVertices; ++i) {
+        UVs[i] = FVector2D(static_cast<float>((Vertices[i].X - bounds[0]) / dx),
+                           static_cast<float>((Vertices[i].Y - bounds[2]) / dy));
+    }
 
-        FLinearColor color = FLinearColor::White;
-        if (scalars) {
-            double val = scalars->GetTuple1(i);
-            double rgb[3];
-            lut->GetColor(val, rgb);
-            color = FLinearColor(rgb[0], rgb[1], rgb[2], 1.0);
-        }
+    // 4 bytes a vertex instead of an FLinearColor's 16; BGRA8 is FColor's byte
+    // order and the same linear quantization CreateMeshSection_LinearColor applies
+    if (scalars) {
+        Colors.SetNumUninitialized(NumVertices);
+        MyColorMap(lut).Map(scalars, Colors.GetData(), MyColorFormat::BGRA8);
+    } else {
+        Colors.Init(FColor::White, NumVertices);
+    }
+    Tangents.Init(FProcMeshTangent(1.0f, 0.0f, 0.0f), NumVertices);
 
-        Colors.Add(color);
-        Tangents.Add(FProcMeshTangent(1.0f, 0.0f, 0.0f)); // Placeholder
+    // cell attributes read once rather than per triangle
+    TArray<FVector> CellNormals;
+    if (!pointNormals && cellNormals) {
+        CellNormals.SetNumUninitialized(static_cast<int32>(cellNormals->GetNumberOfTuples()));
+        MyExtractComponents(cellNormals, &CellNormals.GetData()->X);
     }
 
     vtkCellArray* cells = poly->GetPolys();
-    vtkIdType npts;
-    const vtkIdType* ptIds;
-    vtkIdType cellId = 0;
+    MyTriangleIndexBuilder triangleIndices(cells);
+    Triangles.SetNumUninitialized(static_cast<int32>(3 * triangleIndices.GetNumberOfTriangles()));
+    triangleIndices.Fill(Triangles.GetData());
 
-    for (cells->InitTraversal(); cells->GetNextCell(npts, ptIds); ++cellId) {
-        if (npts == 3) {
-            Triangles.Add(ptIds[0]);
-            Triangles.Add(ptIds[1]);
-            Triangles.Add(ptIds[2]);
+    for (vtkIdType cellId = 0; cellId < triangleIndices.GetNumberOfCells(); ++cellId) {
+        for (vtkIdType t = triangleIndices.GetFirstTriangle(cellId); t < triangleIndices.GetFirstTriangle(cellId + 1); ++t) {
+            const int32* ptIds = &Triangles[3 * t];
 
             if (!pointNormals && cellNormals) {
-                double n[3];
-                cellNormals->GetTuple(cellId, n);
-                FVector normal(n[0], n[1], n[2]);
+                const FVector& normal = CellNormals[cellId];
                 Normals[ptIds[0]] = normal;
                 Normals[ptIds[1]] = normal;
                 Normals[ptIds[2]] = normal;
@@ -147,7 +138,7 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
         }
     }
 
-    MeshComponent->CreateMeshSection_LinearColor(
+    MeshComponent->CreateMeshSection(
         0,
         Vertices,
         Triangles,
@@ -1,9 +1,6 @@
 // Converts 3D vtkPolyData (.vtk) directly into an Unreal Engine mesh, supporting cell- and point-based scalar color lookup tables
 #include <vtkSmartPointer.h>
 #include <vtkPolyDataReader.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkPolyData.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
@@ -18,21 +15,39 @@
 #include <vtkGenericDataObjectReader.h>
 #include <vtkFloatArray.h>
 #include <vtkXMLPolyDataReader.h>
-#include <vtkPolyDataMapper.h>
 #include <iostream>
 
 #include "ProceduralMeshComponent.h"
-
-vtkUnsignedCharArray* MapScalarsFromPolyData(vtkPolyData* poly, const std::string& scalarName, bool useCellData)
+#include "MyAttributeExtract.h"
+#include "MyColorMap.h"
+#include "MyTriangleIndexBuilder.h"
+#include "MyTriangulateCleanNormals.h"
+
+// RGBA colors of the named point or cell array, what vtkPolyDataMapper::MapScalars
+// gives: the array's own lookup table, or the mapper's default one over [0, 1].
+// Mapped by MyColorMap, so no mapper and no rendering module are needed.
+vtkSmartPointer<vtkUnsignedCharArray> MapScalarsFromPolyData(vtkPolyData* poly, const std::string& scalarName, bool useCellData)
 {
-    vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapper->SetInputData(poly);
-    mapper->SetScalarVisibility(true);
-    mapper->SetColorModeToMapScalars();
-    mapper->SetScalarMode(useCellData ? VTK_SCALAR_MODE_USE_CELL_DATA : VTK_SCALAR_MODE_USE_POINT_DATA);
-    mapper->SelectColorArray(scalarName.c_str());
-    mapper->Update();
-    return mapper->MapScalars(1.0);
+    vtkDataArray* scalars = useCellData
+        ? poly->GetCellData()->GetArray(scalarName.c_str())
+        : poly->GetPointData()->GetArray(scalarName.c_str());
+    if (!scalars) {
+        return nullptr;
+    }
+
+    vtkSmartPointer<vtkScalarsToColors> lut = scalars->GetLookupTable();
+    if (!lut) {
+        vtkNew<vtkLookupTable> defaultLut;
+        defaultLut->SetTableRange(0.0, 1.0);
+        defaultLut->Build();
+        lut = defaultLut;
+    }
+
+    vtkSmartPointer<vtkUnsignedCharArray> colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    colors->SetNumberOfComponents(4);
+    colors->SetNumberOfTuples(scalars->GetNumberOfTuples());
+    MyColorMap(lut).Map(scalars, colors->GetPointer(0), MyColorFormat::RGBA8);
+    return colors;
 }
 
 void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshComponent* MeshComponent)
@@ -47,32 +62,21 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
         return;
     }
 
-    vtkNew<vtkTriangleFilter> triangleFilter;
-    triangleFilter->SetInputData(rawPoly);
-    triangleFilter->Update();
-
-    vtkNew<vtkCleanPolyData> clean;
-    clean->SetInputConnection(triangleFilter->GetOutputPort());
-    clean->Update();
-
-    vtkNew<vtkPolyDataNormals> normalsFilter;
-    normalsFilter->SetInputConnection(clean->GetOutputPort());
-    normalsFilter->ComputePointNormalsOn();
-    normalsFilter->ComputeCellNormalsOn();
-    normalsFilter->Update();
-
-    vtkPolyData* poly = normalsFilter->GetOutput();
+    // triangulate, weld duplicate points and compute point and cell normals in one pass
+    MyTriangulateCleanNormalsOptions cleanOptions;
+    cleanOptions.ComputeCellNormals = true;
+    vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(rawPoly, cleanOptions);
     vtkPoints* points = poly->GetPoints();
     vtkDataArray* cellNormals = poly->GetCellData()->GetNormals();
     vtkDataArray* pointNormals = poly->GetPointData()->GetNormals();
 
-    vtkUnsignedCharArray* mappedColors = MapScalarsFromPolyData(poly, "cell_scalars", true);
+    vtkSmartPointer<vtkUnsignedCharArray> mappedColors = MapScalarsFromPolyData(poly, "cell_scalars", true);
 
     TArray<FVector> Vertices;
     TArray<int32> Triangles;
     TArray<FVector> Normals;
     TArray<FVector2D> UVs;
-    TArray<FLinearColor> Colors;
+    TArray<FColor> Colors;
     TArray<FProcMeshTangent> Tangents;
 
     double bounds[6];
@@ -80,50 +84,54 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
     double dx = bounds[1] - bounds[0];
     double dy = bounds[3] - bounds[2];
 
-    for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i) {
-        double p[3];
-        points->GetPoint(i, p);
-        Vertices.Add(FVector(p[0], p[1], p[2]));
+    const int32 NumVertices = static_cast<int32>(points->GetNumberOfPoints());
+    Vertices.SetNumUninitialized(NumVertices);
+    MyExtractComponents(points->GetData(), &Vertices.GetData()->X);
 
-        FVector normal = FVector::UpVector;
-        if (pointNormals) {
-            double n[3];
-            pointNormals->GetTuple(i, n);
-            normal = FVector(n[0], n[1], n[2]);
-        }
-        Normals.Add(normal);
+    if (pointNormals) {
+        Normals.SetNumUninitialized(NumVertices);
+        MyExtractComponents(pointNormals, &Normals.GetData()->X);
+    } else {
+        Normals.Init(FVector::UpVector, NumVertices);
+    }
 
-        float u = static_cast<float>((p[0] - bounds[0]) / dx);
-        float v = static_cast<float>((p[1] - bounds[2]) / dy);
-        UVs.Add(FVector2D(u, v));
+    // Simple planar UV mapping (XY projection)
+    UVs.SetNumUninitialized(NumVertices);
+    for (int32 i = 0; i < NumVertices; ++i) {
+        UVs[i] = FVector2D(static_cast<float>((Vertices[i].X - bounds[0]) / dx),
+                           static_cast<float>((Vertices[i].Y - bounds[2]) / dy));
+    }
 
-        FLinearColor color = FLinearColor::White;
-        if (mappedColors && i < mappedColors->GetNumberOfTuples()) {
-            unsigned char rgb[3];
-            mappedColors->GetTypedTuple(i, rgb);
-            color = FLinearColor(rgb[0] / 255.0f, rgb[1] / 255.0f, rgb[2] / 255.0f);
+    Colors.Init(FColor::White, NumVertices);
+    if (mappedColors) {
+        const unsigned char* rgba = mappedColors->GetPointer(0);
+        const int numComps = mappedColors->GetNumberOfComponents();
+        const int32 NumColors = static_cast<int32>(FMath::Min<vtkIdType>(NumVertices, mappedColors->GetNumberOfTuples()));
+        for (int32 i = 0; i < NumColors; ++i, rgba += numComps) {
+            Colors[i] = FColor(rgba[0], rgba[1], rgba[2]);
         }
-        Colors.Add(color);
+    }
+    Tangents.Init(FProcMeshTangent(1.0f, 0.0f, 0.0f), NumVertices);
 
-        Tangents.Add(FProcMeshTangent(1.0f, 0.0f, 0.0f));
+    // cell attributes read once rather than per triangle
+    TArray<FVector> CellNormals;
+    if (!pointNormals && cellNormals) {
+        CellNormals.SetNumUninitialized(static_cast<int32>(cellNormals->GetNumberOfTuples()));
+        MyExtractComponents(cellNormals, &CellNormals.GetData()->X);
     }
 
     vtkCellArray* cells = poly->GetPolys();
-    vtkIdType npts;
-    const vtkIdType* ptIds;
-    vtkIdType cellId = 0;
+    MyTriangleIndexBuilder triangleIndices(cells);
+    Triangles.SetNumUninitialized(static_cast<int32>(3 * triangleIndices.GetNumberOfTriangles()));
+    triangleIndices.Fill(Triangles.GetData());
 
-    for (cells->InitTraversal(); cells->GetNextCell(npts, ptIds); ++cellId) {
-        if (npts == 3) {
-            Triangles.Add(ptIds[0]);
-            Triangles.Add(ptIds[1]);
-            Triangles.Add(ptIds[2]);
+    for (vtkIdType cellId = 0; cellId < triangleIndices.GetNumberOfCells(); ++cellId) {
+        for (vtkIdType t = triangleIndices.GetFirstTriangle(cellId); t < triangleIndices.GetFirstTriangle(cellId + 1); ++t) {
+            const int32* ptIds = &Triangles[3 * t];
 
             FVector normal = FVector::UpVector;
             if (!pointNormals && cellNormals) {
-                double n[3];
-                cellNormals->GetTuple(cellId, n);
-                normal = FVector(n[0], n[1], n[2]);
+                normal = CellNormals[cellId];
                 Normals[ptIds[0]] = normal;
                 Normals[ptIds[1]] = normal;
                 Normals[ptIds[2]] = normal;
@@ -154,7 +162,7 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
         }
     }
 
-    MeshComponent->CreateMeshSection_LinearColor(
+    MeshComponent->CreateMeshSection(
         0,
         Vertices,
         Triangles,
@@ -1,9 +1,6 @@
 // Converts 3D vtkPolyData (.vtk) directly into an Unreal Engine mesh
 #include <vtkSmartPointer.h>
 #include <vtkPolyDataReader.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkPolyData.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
@@ -13,6 +10,10 @@
 #include <iostream>
 
 #include "ProceduralMeshComponent.h"
+#include "MyAttributeExtract.h"
+#include "MyTangents.h"
+#include "MyTriangleIndexBuilder.h"
+#include "MyTriangulateCleanNormals.h"
 
 void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshComponent* MeshComponent)
 {
@@ -26,22 +27,10 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
         return;
     }
 
-    // Ensure mesh is triangulated
-    vtkNew<vtkTriangleFilter> triangleFilter;
-    triangleFilter->SetInputData(rawPoly);
-    triangleFilter->Update();
-
-    vtkNew<vtkCleanPolyData> clean;
-    clean->SetInputConnection(triangleFilter->GetOutputPort());
-    clean->Update();
-
-    vtkNew<vtkPolyDataNormals> normalsFilter;
-    normalsFilter->SetInputConnection(clean->GetOutputPort());
-    normalsFilter->ComputePointNormalsOn(); // Enable both types for fallback
-    normalsFilter->ComputeCellNormalsOn();
-    normalsFilter->Update();
-
-    vtkPolyData* poly = normalsFilter->GetOutput();
+    // triangulate, weld duplicate points and compute point and cell normals in one pass
+    MyTriangulateCleanNormalsOptions cleanOptions;
+    cleanOptions.ComputeCellNormals = true;
+    vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(rawPoly, cleanOptions);
     vtkPoints* points = poly->GetPoints();
     vtkDataArray* cellNormals = poly->GetCellData()->GetNormals();
     vtkDataArray* pointNormals = poly->GetPointData()->GetNormals();
@@ -59,75 +48,64 @@ void LoadPolyDataAndCreateMesh(const std::string& filePath, UProceduralMeshCompo
     double dx = bounds[1] - bounds[0];
     double dy = bounds[3] - bounds[2];
 
-    for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i) {
-        double p[3];
-        points->GetPoint(i, p);
-        Vertices.Add(FVector(p[0], p[1], p[2]));
+    const int32 NumVertices = static_cast<int32>(points->GetNumberOfPoints());
+    Vertices.SetNumUninitialized(NumVertices);
+    MyExtractComponents(points->GetData(), &Vertices.GetData()->X);
 
-        FVector normal = FVector::UpVector;
-        if (pointNormals) {
-            double n[3];
-            pointNormals->GetTuple(i, n);
-            normal = FVector(n[0], n[1], n[2]);
-        }
+    if (pointNormals) {
+        Normals.SetNumUninitialized(NumVertices);
+        MyExtractComponents(pointNormals, &Normals.GetData()->X);
+    } else {
+        Normals.Init(FVector::UpVector, NumVertices);
+    }
 
-        Normals.Add(normal);
+    // Simple planar UV mapping (XY projection)
+    UVs.SetNumUninitialized(NumVertices);
+    for (int32 i = 0; i < NumVertices; ++i) {
+        UVs[i] = FVector2D(static_cast<float>((Vertices[i].X - bounds[0]) / dx),
+                           static_cast<float>((Vertices[i].Y - bounds[2]) / dy));
+    }
 
-        // Simple planar UV mapping (XY projection)
-        float u = static_cast<float>((p[0] - bounds[0]) / dx);
-        float v = static_cast<float>((p[1] - bounds[2]) / dy);
-        UVs.Add(FVector2D(u, v));
+    Colors.Init(FLinearColor::White, NumVertices);
 
-        Colors.Add(FLinearColor::White);
-        Tangents.Add(FProcMeshTangent(1.0f, 0.0f, 0.0f)); // Placeholder
+    // cell attributes read once rather than per triangle
+    TArray<FVector> CellNormals;
+    if (!pointNormals && cellNormals) {
+        CellNormals.SetNumUninitialized(static_cast<int32>(cellNormals->GetNumberOfTuples()));
+        MyExtractComponents(cellNormals, &CellNormals.GetData()->X);
     }
 
     vtkCellArray* cells = poly->GetPolys();
-    vtkIdType npts;
-    const vtkIdType* ptIds;
-    vtkIdType cellId = 0;
+    MyTriangleIndexBuilder triangleIndices(cells);
+    Triangles.SetNumUninitialized(static_cast<int32>(3 * triangleIndices.GetNumberOfTriangles()));
+    triangleIndices.Fill(Triangles.GetData());
 
-    for (cells->InitTraversal(); cells->GetNextCell(npts, ptIds); ++cellId) {
-        if (npts == 3) {
-            Triangles.Add(ptIds[0]);
-            Triangles.Add(ptIds[1]);
-            Triangles.Add(ptIds[2]);
+    for (vtkIdType cellId = 0; cellId < triangleIndices.GetNumberOfCells(); ++cellId) {
+        for (vtkIdType t = triangleIndices.GetFirstTriangle(cellId); t < triangleIndices.GetFirstTriangle(cellId + 1); ++t) {
+            const int32* ptIds = &Triangles[3 * t];
 
             if (!pointNormals && cellNormals) {
-                double n[3];
-                cellNormals->GetTuple(cellId, n);
-                FVector normal(n[0], n[1], n[2]);
+                const FVector& normal = CellNormals[cellId];
                 Normals[ptIds[0]] = normal;
                 Normals[ptIds[1]] = normal;
                 Normals[ptIds[2]] = normal;
             }
-
-            // Compute tangents from triangle edges
-            const FVector& p0 = Vertices[ptIds[0]];
-            const FVector& p1 = Vertices[ptIds[1]];
-            const FVector& p2 = Vertices[ptIds[2]];
-
-            const FVector2D& uv0 = UVs[ptIds[0]];
-            const FVector2D& uv1 = UVs[ptIds[1]];
-            const FVector2D& uv2 = UVs[ptIds[2]];
-
-            FVector edge1 = p1 - p0;
-            FVector edge2 = p2 - p0;
-            FVector2D deltaUV1 = uv1 - uv0;
-            FVector2D deltaUV2 = uv2 - uv0;
-
-            float f = deltaUV1.X * deltaUV2.Y - deltaUV2.X * deltaUV1.Y;
-            if (FMath::Abs(f) < KINDA_SMALL_NUMBER) f = 1.0f; else f = 1.0f / f;
-
-            FVector tangent = f * (deltaUV2.Y * edge1 - deltaUV1.Y * edge2);
-            tangent.Normalize();
-
-            Tangents[ptIds[0]] = FProcMeshTangent(tangent, false);
-            Tangents[ptIds[1]] = FProcMeshTangent(tangent, false);
-            Tangents[ptIds[2]] = FProcMeshTangent(tangent, false);
         }
     }
 
+    // angle weighted per-vertex frames on the final normals, MikkTSpace style,
+    // so the engine does not need to recompute them
+    TArray<FVector> TangentX;
+    TArray<float> TangentSigns;
+    TangentX.SetNumUninitialized(NumVertices);
+    TangentSigns.SetNumUninitialized(NumVertices);
+    MyComputeTangents(&Vertices.GetData()->X, &Normals.GetData()->X, &UVs.GetData()->X, NumVertices,
+        Triangles.GetData(), Triangles.Num() / 3, &TangentX.GetData()->X, TangentSigns.GetData());
+    Tangents.SetNumUninitialized(NumVertices);
+    for (int32 i = 0; i < NumVertices; ++i) {
+        Tangents[i] = FProcMeshTangent(TangentX[i], TangentSigns[i] < 0.0f);
+    }
+
     MeshComponent->CreateMeshSection_LinearColor(
         0,
         Vertices,
@@ -2,9 +2,6 @@
 #include <vtkSmartPointer.h>
 #include <vtkUnstructuredGridReader.h>
 #include <vtkGeometryFilter.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkPolyData.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
@@ -14,6 +11,7 @@
 #include <iostream>
 
 #include "ProceduralMeshComponent.h"
+#include "MyTriangulateCleanNormals.h"
 
 void LoadUnstructuredGridAndCreateMesh(const std::string& filePath, UProceduralMeshComponent* MeshComponent)
 {
@@ -32,20 +30,8 @@ void LoadUnstructuredGridAndCreateMesh(const std::string& filePath, UProceduralM
     geometryFilter->SetInputData(grid);
     geometryFilter->Update();
 
-    vtkNew<vtkTriangleFilter> triangleFilter;
-    triangleFilter->SetInputConnection(geometryFilter->GetOutputPort());
-    triangleFilter->Update();
-
-    vtkNew<vtkCleanPolyData> clean;
-    clean->SetInputConnection(triangleFilter->GetOutputPort());
-    clean->Update();
-
-    vtkNew<vtkPolyDataNormals> normalsFilter;
-    normalsFilter->SetInputConnection(clean->GetOutputPort());
-    normalsFilter->ComputePointNormalsOn();
-    normalsFilter->Update();
-
-    vtkPolyData* poly = normalsFilter->GetOutput();
+    // triangulate, weld duplicate points and compute point normals in one pass
+    vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(geometryFilter->GetOutput());
     vtkPoints* points = poly->GetPoints();
     vtkDataArray* normals = poly->GetPointData()->GetNormals();
     vtkUnsignedCharArray* colorArray = vtkUnsignedCharArray::SafeDownCast(poly->GetPointData()->GetScalars());
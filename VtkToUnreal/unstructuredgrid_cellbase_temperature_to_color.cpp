@@ -2,9 +2,6 @@
 #include <vtkSmartPointer.h>
 #include <vtkUnstructuredGridReader.h>
 #include <vtkGeometryFilter.h>
-#include <vtkTriangleFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkPolyData.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
@@ -13,16 +10,25 @@
 #include <vtkDataArray.h>
 #include <vtkUnsignedCharArray.h>
 #include <iostream>
+#include <vector>
 
 #include "ProceduralMeshComponent.h"
+#include "MyAttributeExtract.h"
+#include "MyComponentView.h"
+#include "MyScalarRange.h"
+#include "MySplitVertices.h"
+#include "MyStageProfile.h"
+#include "MyTriangulateCleanNormals.h"
 
 extern FLinearColor TemperatureToColor(double scalar, double minVal, double maxVal);
 
 void LoadUnstructuredGridAndCreateMesh(const std::string& filePath, UProceduralMeshComponent* MeshComponent)
 {
+    MyStage readStage("read");
     vtkNew<vtkUnstructuredGridReader> reader;
     reader->SetFileName(filePath.c_str());
     reader->Update();
+    readStage.Stop();
 
     vtkUnstructuredGrid* grid = reader->GetOutput();
     if (!grid || !grid->GetPoints()) {
@@ -31,32 +37,45 @@ void LoadUnstructuredGridAndCreateMesh(const std::string& filePath, UProceduralM
     }
 
     // Convert unstructured grid to polydata using GeometryFilter
+    MyStage geometryStage("geometry");
     vtkNew<vtkGeometryFilter> geometryFilter;
     geometryFilter->SetInputData(grid);
     geometryFilter->Update();
+    geometryStage.Stop();
 
-    vtkNew<vtkTriangleFilter> triangleFilter;
-    triangleFilter->SetInputConnection(geometryFilter->GetOutputPort());
-    triangleFilter->Update();
-
-    vtkNew<vtkCleanPolyData> clean;
-    clean->SetInputConnection(triangleFilter->GetOutputPort());
-    clean->Update();
-
-    vtkNew<vtkPolyDataNormals> normalsFilter;
-    normalsFilter->SetInputConnection(clean->GetOutputPort());
-    normalsFilter->ComputePointNormalsOn();
-    normalsFilter->Update();
-
-    vtkPolyData* poly = normalsFilter->GetOutput();
+    // triangulate, weld duplicate points and compute point normals in one pass
+    MyStage cleanStage("triangulate+clean");
+    vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(geometryFilter->GetOutput());
+    cleanStage.Stop();
     vtkPoints* points = poly->GetPoints();
     vtkDataArray* normals = poly->GetPointData()->GetNormals();
     vtkDataArray* cellScalars = poly->GetCellData()->GetScalars();
 
-    double minScalar = 0.0, maxScalar = 1.0;
+    // [0, 1] when there are no cell scalars
+    double scalarRange[2] = { 0.0, 1.0 };
+    MyGetScalarRange(cellScalars, scalarRange);
+    const double minScalar = scalarRange[0], maxScalar = scalarRange[1];
+
+    // a vertex per point and distinct cell scalar around it instead of three per
+    // triangle: cells with equal temperatures share their vertices
+    std::vector<MyComponentView> cellValues;
     if (cellScalars) {
-        cellScalars->GetRange(minScalar, maxScalar);
+        cellValues.emplace_back(cellScalars, 0);
     }
+    MyStage splitStage("split vertices");
+    const MySplitVerticesResult split = MySplitVertices(poly, cellValues);
+    splitStage.Stop();
+    const int32 numVertices = static_cast<int32>(split.VertexPoints.size());
+
+    MyStage extractStage("extract");
+    std::vector<double> pointCoords(3 * points->GetNumberOfPoints());
+    MyExtractComponents(points->GetData(), pointCoords.data());
+    std::vector<double> pointNormals;
+    if (normals) {
+        pointNormals.resize(3 * normals->GetNumberOfTuples());
+        MyExtractComponents(normals, pointNormals.data());
+    }
+    extractStage.Stop();
 
     TArray<FVector> Vertices;
     TArray<int32> Triangles;
@@ -65,45 +84,37 @@ void LoadUnstructuredGridAndCreateMesh(const std::string& filePath, UProceduralM
     TArray<FLinearColor> Colors;
     TArray<FProcMeshTangent> Tangents;
 
-    vtkCellArray* cells = poly->GetPolys();
-    vtkIdType npts;
-    const vtkIdType* ptIds;
-    int32 triangleIndex = 0;
-
-    for (cells->InitTraversal(); cells->GetNextCell(npts, ptIds); ++triangleIndex) {
-        if (npts == 3) {
-            for (vtkIdType i = 0; i < 3; ++i) {
-                double p[3];
-                points->GetPoint(ptIds[i], p);
-                Vertices.Add(FVector(p[0], p[1], p[2]));
-
-                if (normals) {
-                    double n[3];
-                    normals->GetTuple(ptIds[i], n);
-                    Normals.Add(FVector(n[0], n[1], n[2]));
-                } else {
-                    Normals.Add(FVector::UpVector);
-                }
-
-                UVs.Add(FVector2D(0.0f, 0.0f));
-
-                FLinearColor color = FLinearColor::White;
-                if (cellScalars) {
-                    double scalar = cellScalars->GetTuple1(triangleIndex);
-                    color = TemperatureToColor(scalar, minScalar, maxScalar);
-                }
-                Colors.Add(color);
-
-                Tangents.Add(FProcMeshTangent(1.0f, 0.0f, 0.0f));
-            }
-
-            int32 baseIdx = triangleIndex * 3;
-            Triangles.Add(baseIdx);
-            Triangles.Add(baseIdx + 1);
-            Triangles.Add(baseIdx + 2);
+    Vertices.SetNumUninitialized(numVertices);
+    Normals.SetNumUninitialized(numVertices);
+    Colors.SetNumUninitialized(numVertices);
+    UVs.Init(FVector2D(0.0f, 0.0f), numVertices);
+    Tangents.Init(FProcMeshTangent(1.0f, 0.0f, 0.0f), numVertices);
+
+    MyStage colorStage("color map");
+    const MyComponentView temperatures = cellScalars ? cellValues[0] : MyComponentView();
+    for (int32 v = 0; v < numVertices; ++v) {
+        const double* p = &pointCoords[3 * split.VertexPoints[v]];
+        Vertices[v] = FVector(p[0], p[1], p[2]);
+
+        if (normals) {
+            const double* n = &pointNormals[3 * split.VertexPoints[v]];
+            Normals[v] = FVector(n[0], n[1], n[2]);
+        } else {
+            Normals[v] = FVector::UpVector;
         }
+
+        Colors[v] = temperatures.IsValid() ?
+            TemperatureToColor(temperatures.GetValue(split.VertexCells[v]), minScalar, maxScalar) :
+            FLinearColor::White;
+    }
+    colorStage.Stop();
+
+    Triangles.SetNumUninitialized(static_cast<int32>(split.Triangles.size()));
+    for (int32 i = 0; i < Triangles.Num(); ++i) {
+        Triangles[i] = static_cast<int32>(split.Triangles[i]);
     }
 
+    MY_STAGE("section upload");
     MeshComponent->CreateMeshSection_LinearColor(
         0,
         Vertices,
@@ -3,18 +3,16 @@
 #include <vtkSmartPointer.h>
 #include <vtkStructuredPointsReader.h>
 #include <vtkDataSetSurfaceFilter.h>
-#include <vtkCleanPolyData.h>
-#include <vtkPolyDataNormals.h>
 #include <vtkPolyData.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
-#include <vtkTriangleFilter.h>
 #include <vtkPointData.h>
 #include <vtkFloatArray.h>
 #include <iostream>
 
 // Unreal-specific includes assumed
 #include "ProceduralMeshComponent.h"
+#include "MyTriangulateCleanNormals.h"
 
 void ConvertVTKToUnrealMesh(const std::string& filePath, UProceduralMeshComponent* MeshComponent)
 {
@@ -28,20 +26,8 @@ void ConvertVTKToUnrealMesh(const std::string& filePath, UProceduralMeshComponen
     surfaceFilter->SetInputData(input);
     surfaceFilter->Update();
 
-    vtkNew<vtkCleanPolyData> clean;
-    clean->SetInputConnection(surfaceFilter->GetOutputPort());
-    clean->Update();
-
-    vtkNew<vtkTriangleFilter> triangleFilter;
-    triangleFilter->SetInputConnection(clean->GetOutputPort());
-    triangleFilter->Update();
-
-    vtkNew<vtkPolyDataNormals> normalsFilter;
-    normalsFilter->SetInputConnection(triangleFilter->GetOutputPort());
-    normalsFilter->ComputePointNormalsOn();
-    normalsFilter->Update();
-
-    vtkPolyData* poly = normalsFilter->GetOutput();
+    // triangulate, weld duplicate points and compute point normals in one pass
+    vtkSmartPointer<vtkPolyData> poly = MyTriangulateCleanNormals(surfaceFilter->GetOutput());
     vtkPoints* points = poly->GetPoints();
     vtkDataArray* normals = poly->GetPointData()->GetNormals();
 
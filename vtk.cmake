@@ -9,6 +9,7 @@ set(VTK_LIBS "/opt/vtk/9.4.1/lib64")
 find_package(VTK COMPONENTS 
   CommonColor
   CommonCore
+  CommonDataModel
   FiltersSources
   IOGeometry
   IOLegacy